@@ -61,6 +61,13 @@ ifeq (${ENABLE_PMF}, 1)
 BL31_SOURCES		+=	lib/pmf/pmf_main.c
 endif
 
+ifeq (${EL3_TRACE},1)
+BL31_SOURCES		+=	lib/el3_trace/el3_trace.c
+# The trace buffer handed by the Normal world is mapped on demand
+PLAT_XLAT_TABLES_DYNAMIC :=	1
+$(eval $(call add_define,PLAT_XLAT_TABLES_DYNAMIC))
+endif
+
 include lib/debugfs/debugfs.mk
 ifeq (${USE_DEBUGFS},1)
 	BL31_SOURCES	+= $(DEBUGFS_SRCS)
@@ -147,6 +154,15 @@ ifeq ($(FEATURE_DETECTION),1)
 BL31_SOURCES		+=	common/feat_detect.c
 endif
 
+ifeq (${XLAT_TABLES_PREBUILT},1)
+XLAT_PREBUILT_SOURCE	:=	${BUILD_PLAT}/bl31/xlat_tables_prebuilt.c
+BL31_SOURCES		+=	${XLAT_PREBUILT_SOURCE}
+
+$(eval $(call MAKE_XLAT_PREBUILT,\
+	${BUILD_PLAT}/bl31/$(notdir $(XLAT_TABLES_PREBUILT_MMAP_SOURCE:.c=.o)),\
+	${BUILD_PLAT}/bl31/xlat_tables_context.o,${XLAT_PREBUILT_SOURCE}))
+endif
+
 ifeq (${DRTM_SUPPORT},1)
 BL31_SOURCES		+=	services/std_svc/drtm/drtm_main.c		\
 				services/std_svc/drtm/drtm_dma_prot.c		\
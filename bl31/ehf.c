@@ -19,6 +19,7 @@
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/cpu_data.h>
 #include <lib/el3_runtime/pubsub_events.h>
+#include <lib/el3_trace/el3_trace.h>
 #include <plat/common/platform.h>
 
 /* Output EHF logs as verbose */
@@ -150,6 +151,7 @@ void ehf_activate_priority(unsigned int priority)
 	if (cur_pri_idx == EHF_INVALID_IDX)
 		pe_data->init_pri_mask = (uint8_t) old_mask;
 
+	EL3_TRACE_EVENT(EL3_TRACE_EV_EHF_ACTIVATE, priority, 0U, 0U);
 	EHF_LOG("activate prio=%d\n", get_pe_highest_active_idx(pe_data));
 }
 
@@ -214,6 +216,7 @@ void ehf_deactivate_priority(unsigned int priority)
 		panic();
 	}
 
+	EL3_TRACE_EVENT(EL3_TRACE_EV_EHF_DEACTIVATE, priority, 0U, 0U);
 	EHF_LOG("deactivate prio=%d\n", get_pe_highest_active_idx(pe_data));
 }
 
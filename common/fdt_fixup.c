@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -27,6 +27,31 @@
 #include <drivers/console.h>
 #include <lib/psci/psci.h>
 #include <plat/common/platform.h>
+#include <platform_def.h>
+
+#ifdef PLAT_FCONF_FDT_INDEX_NODES
+FDTW_INDEX_DECLARE(fdt_fixup_fdt_index, PLAT_FCONF_FDT_INDEX_NODES,
+		   PLAT_FCONF_FDT_INDEX_PHANDLES);
+#endif
+
+/*******************************************************************************
+ * fdt_fixup_index() - index the nodes of the DT before fixing it up
+ * @dtb:	pointer to the device tree blob in memory
+ *
+ * The parent and phandle lookups of the fixups below, and of the fdt_wrappers,
+ * then don't rescan the DT until a fixup adds, removes or resizes a node or a
+ * property. Only fixups which patch the DT in place, like
+ * fdt_adjust_gic_redist(), keep the index. It does nothing unless the platform
+ * defines PLAT_FCONF_FDT_INDEX_NODES.
+ ******************************************************************************/
+void fdt_fixup_index(const void *dtb)
+{
+#ifdef PLAT_FCONF_FDT_INDEX_NODES
+	if (fdtw_index_init(&fdt_fixup_fdt_index, dtb) != 0) {
+		VERBOSE("DT is not indexed\n");
+	}
+#endif
+}
 
 
 static int append_psci_compatible(void *fdt, int offs, const char *str)
@@ -73,6 +98,7 @@ int dt_add_psci_node(void *fdt)
 	offs = fdt_path_offset(fdt, "/");
 	if (offs < 0)
 		return -1;
+	fdtw_index_invalidate(fdt);
 	offs = fdt_add_subnode(fdt, offs, "psci");
 	if (offs < 0)
 		return -1;
@@ -93,28 +119,34 @@ int dt_add_psci_node(void *fdt)
 	return 0;
 }
 
-/*
- * Find the first subnode that has a "device_type" property with the value
- * "cpu" and which's enable-method is not "psci" (yet).
- * Returns 0 if no such subnode is found, so all have already been patched
- * or none have to be patched in the first place.
- * Returns 1 if *one* such subnode has been found and successfully changed
- * to "psci".
- * Returns negative values on error.
+/*******************************************************************************
+ * dt_add_psci_cpu_enable_methods() - switch CPU nodes in DT to use PSCI
+ * @fdt:	pointer to the device tree blob in memory
  *
- * Call in a loop until it returns 0. Recalculate the node offset after
- * it has returned 1.
- */
-static int dt_update_one_cpu_node(void *fdt, int offset)
+ * Iterate over all CPU device tree nodes (/cpus/cpu@x) in memory to change
+ * the enable-method to PSCI. This will add the enable-method properties, if
+ * required, or will change existing properties to read "psci".
+ *
+ * Patching a node only moves the nodes which follow it, so the iteration goes
+ * on from the node just patched rather than starting over.
+ *
+ * Return: 0 on success, or a negative error value otherwise.
+ ******************************************************************************/
+
+int dt_add_psci_cpu_enable_methods(void *fdt)
 {
-	int offs;
+	int offs, cpus, ret;
+
+	cpus = fdt_path_offset(fdt, "/cpus");
+	if (cpus < 0)
+		return cpus;
 
-	/* Iterate over all subnodes to find those with device_type = "cpu". */
-	for (offs = fdt_first_subnode(fdt, offset); offs >= 0;
-	     offs = fdt_next_subnode(fdt, offs)) {
+	fdtw_index_invalidate(fdt);
+
+	/* Find the subnodes with device_type = "cpu". */
+	fdt_for_each_subnode(offs, fdt, cpus) {
 		const char *prop;
 		int len;
-		int ret;
 
 		prop = fdt_getprop(fdt, offs, "device_type", &len);
 		if (prop == NULL)
@@ -131,11 +163,6 @@ static int dt_update_one_cpu_node(void *fdt, int offset)
 		ret = fdt_setprop_string(fdt, offs, "enable-method", "psci");
 		if (ret < 0)
 			return ret;
-		/*
-		 * Subnode found and patched.
-		 * Restart to accommodate potentially changed offsets.
-		 */
-		return 1;
 	}
 
 	if (offs == -FDT_ERR_NOTFOUND)
@@ -144,32 +171,6 @@ static int dt_update_one_cpu_node(void *fdt, int offset)
 	return offs;
 }
 
-/*******************************************************************************
- * dt_add_psci_cpu_enable_methods() - switch CPU nodes in DT to use PSCI
- * @fdt:	pointer to the device tree blob in memory
- *
- * Iterate over all CPU device tree nodes (/cpus/cpu@x) in memory to change
- * the enable-method to PSCI. This will add the enable-method properties, if
- * required, or will change existing properties to read "psci".
- *
- * Return: 0 on success, or a negative error value otherwise.
- ******************************************************************************/
-
-int dt_add_psci_cpu_enable_methods(void *fdt)
-{
-	int offs, ret;
-
-	do {
-		offs = fdt_path_offset(fdt, "/cpus");
-		if (offs < 0)
-			return offs;
-
-		ret = dt_update_one_cpu_node(fdt, offs);
-	} while (ret > 0);
-
-	return ret;
-}
-
 #define HIGH_BITS(x) ((sizeof(x) > 4) ? ((x) >> 32) : (typeof(x))0)
 
 /*******************************************************************************
@@ -203,6 +204,7 @@ int fdt_add_reserved_memory(void *dtb, const char *node_name,
 
 	ac = fdt_address_cells(dtb, 0);
 	sc = fdt_size_cells(dtb, 0);
+	fdtw_index_invalidate(dtb);
 	if (offs < 0) {			/* create if not existing yet */
 		offs = fdt_add_subnode(dtb, 0, "reserved-memory");
 		if (offs < 0) {
@@ -343,6 +345,7 @@ int fdt_add_cpus_node(void *dtb, unsigned int afflv0,
 		return -EEXIST;
 	}
 
+	fdtw_index_invalidate(dtb);
 	offs = fdt_add_subnode(dtb, 0, "cpus");
 	if (offs < 0) {
 		ERROR ("FDT: add subnode \"cpus\" node to parent node failed");
@@ -413,7 +416,7 @@ int fdt_add_cpu_idle_states(void *dtb, const struct psci_cpu_idle_state *state)
 	int cpu_node, cpus_node, idle_states_node, ret;
 	uint32_t count, phandle;
 
-	ret = fdt_find_max_phandle(dtb, &phandle);
+	ret = fdtw_find_max_phandle(dtb, &phandle);
 	phandle++;
 	if (ret < 0) {
 		return ret;
@@ -425,6 +428,7 @@ int fdt_add_cpu_idle_states(void *dtb, const struct psci_cpu_idle_state *state)
 	}
 
 	/* Create the idle-states node and its child nodes. */
+	fdtw_index_invalidate(dtb);
 	idle_states_node = fdt_add_subnode(dtb, cpus_node, "idle-states");
 	if (idle_states_node < 0) {
 		return idle_states_node;
@@ -534,7 +538,7 @@ int fdt_adjust_gic_redist(void *dtb, unsigned int nr_cores,
 		return offset;
 	}
 
-	parent = fdt_parent_offset(dtb, offset);
+	parent = fdtw_parent_offset(dtb, offset);
 	if (parent < 0) {
 		return parent;
 	}
@@ -622,5 +626,7 @@ int fdt_set_mac_address(void *dtb, unsigned int ethernet_idx,
 		return node;
 	}
 
+	fdtw_index_invalidate(dtb);
+
 	return fdt_setprop(dtb, node, "local-mac-address", mac_addr, 6);
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -275,22 +275,17 @@ static uint64_t fdt_read_prop_cells(const fdt32_t *prop, int nr_cells)
 	return reg;
 }
 
-int fdt_get_reg_props_by_index(const void *dtb, int node, int index,
-			       uintptr_t *base, size_t *size)
+/*
+ * Read entry 'index' of the "reg" property of 'node', given the number of
+ * address and size cells of its parent.
+ */
+static int fdtw_read_reg(const void *dtb, int node, int ac, int sc, int index,
+			 uintptr_t *base, size_t *size)
 {
 	const fdt32_t *prop;
-	int parent, len;
-	int ac, sc;
+	int len;
 	int cell;
 
-	parent = fdt_parent_offset(dtb, node);
-	if (parent < 0) {
-		return -FDT_ERR_BADOFFSET;
-	}
-
-	ac = fdt_address_cells(dtb, parent);
-	sc = fdt_size_cells(dtb, parent);
-
 	cell = index * (ac + sc);
 
 	prop = fdt_getprop(dtb, node, "reg", &len);
@@ -314,6 +309,20 @@ int fdt_get_reg_props_by_index(const void *dtb, int node, int index,
 	return 0;
 }
 
+int fdt_get_reg_props_by_index(const void *dtb, int node, int index,
+			       uintptr_t *base, size_t *size)
+{
+	int parent;
+
+	parent = fdtw_parent_offset(dtb, node);
+	if (parent < 0) {
+		return -FDT_ERR_BADOFFSET;
+	}
+
+	return fdtw_read_reg(dtb, node, fdt_address_cells(dtb, parent),
+			     fdt_size_cells(dtb, parent), index, base, size);
+}
+
 /*******************************************************************************
  * This function fills reg node info (base & size) with an index found by
  * checking the reg-names node.
@@ -440,7 +449,7 @@ static uint64_t fdtw_search_all_xlat_entries(const void *dtb,
 	 *              = 1                 + 2                      + 1
 	 */
 
-	parent_bus_node = fdt_parent_offset(dtb, local_bus);
+	parent_bus_node = fdtw_parent_offset(dtb, local_bus);
 	self_addr_cells = fdt_address_cells(dtb, local_bus);
 	self_size_cells = fdt_size_cells(dtb, local_bus);
 	parent_addr_cells = fdt_address_cells(dtb, parent_bus_node);
@@ -532,7 +541,7 @@ uint64_t fdtw_translate_address(const void *dtb, int node,
 	const char *node_name;
 	uint64_t global_address;
 
-	local_bus_node = fdt_parent_offset(dtb, node);
+	local_bus_node = fdtw_parent_offset(dtb, node);
 	node_name = fdt_get_name(dtb, local_bus_node, NULL);
 
 	/*
@@ -588,12 +597,17 @@ int fdtw_for_each_cpu(const void *dtb,
 {
 	int ret = 0;
 	int parent, node = 0;
+	int ac, sc;
 
 	parent = fdt_path_offset(dtb, "/cpus");
 	if (parent < 0) {
 		return parent;
 	}
 
+	/* All the CPU nodes share the same parent */
+	ac = fdt_address_cells(dtb, parent);
+	sc = fdt_size_cells(dtb, parent);
+
 	fdt_for_each_subnode(node, dtb, parent) {
 		const char *name;
 		int len;
@@ -605,7 +619,7 @@ int fdtw_for_each_cpu(const void *dtb,
 			continue;
 		}
 
-		ret = fdt_get_reg_props_by_index(dtb, node, 0, &mpidr, NULL);
+		ret = fdtw_read_reg(dtb, node, ac, sc, 0, &mpidr, NULL);
 		if (ret < 0) {
 			break;
 		}
@@ -630,6 +644,7 @@ int fdtw_find_or_add_subnode(void *fdt, int parentoffset, const char *name)
 	offset = fdt_subnode_offset(fdt, parentoffset, name);
 
 	if (offset == -FDT_ERR_NOTFOUND) {
+		fdtw_index_invalidate(fdt);
 		offset = fdt_add_subnode(fdt, parentoffset, name);
 	}
 
@@ -639,3 +654,193 @@ int fdtw_find_or_add_subnode(void *fdt, int parentoffset, const char *name)
 
 	return offset;
 }
+
+/*
+ * Index of the DTB the wrappers currently look nodes up in, see
+ * fdtw_index_init(). NULL when there is none.
+ */
+static struct fdtw_index *fdtw_active_index;
+
+/* Deepest node nesting supported by fdtw_index_init() */
+#define FDTW_INDEX_MAX_DEPTH	32
+
+/*
+ * Build an index of all the nodes of 'dtb' in 'index', and use it for lookups
+ * in this DTB until it is invalidated. 'index' must provide storage, see
+ * FDTW_INDEX_DECLARE(). Returns 0 on success, or a negative FDT error code if
+ * the DTB is invalid or does not fit, in which case the lookups keep scanning
+ * the DTB.
+ */
+int fdtw_index_init(struct fdtw_index *index, const void *dtb)
+{
+	int parents[FDTW_INDEX_MAX_DEPTH];
+	int node, depth = 0;
+	unsigned int i;
+	uint32_t phandle;
+
+	assert(index != NULL);
+	assert(dtb != NULL);
+
+	fdtw_active_index = NULL;
+	index->dtb = NULL;
+	index->nr_nodes = 0U;
+	index->nr_phandles = 0U;
+
+	if (fdt_check_header(dtb) != 0) {
+		return -FDT_ERR_BADSTRUCTURE;
+	}
+
+	/*
+	 * Nodes are visited, hence stored, in increasing offset order. The
+	 * depth drops below 0 once past the end of the root node.
+	 */
+	for (node = 0; (node >= 0) && (depth >= 0);
+	     node = fdt_next_node(dtb, node, &depth)) {
+		if ((depth >= FDTW_INDEX_MAX_DEPTH) ||
+		    (index->nr_nodes == index->max_nodes)) {
+			return -FDT_ERR_NOSPACE;
+		}
+
+		parents[depth] = node;
+		index->nodes[index->nr_nodes].offset = node;
+		index->nodes[index->nr_nodes].parent =
+			(depth == 0) ? -FDT_ERR_NOTFOUND : parents[depth - 1];
+		index->nr_nodes++;
+
+		phandle = fdt_get_phandle(dtb, node);
+		if ((phandle == 0U) || (phandle == (uint32_t)-1)) {
+			continue;
+		}
+
+		if (index->nr_phandles == index->max_phandles) {
+			return -FDT_ERR_NOSPACE;
+		}
+
+		/* Insertion sort by phandle */
+		for (i = index->nr_phandles;
+		     (i > 0U) && (index->phandles[i - 1U].phandle > phandle);
+		     i--) {
+			index->phandles[i] = index->phandles[i - 1U];
+		}
+		index->phandles[i].phandle = phandle;
+		index->phandles[i].offset = node;
+		index->nr_phandles++;
+	}
+
+	if ((node < 0) && (node != -FDT_ERR_NOTFOUND)) {
+		return node;
+	}
+
+	index->dtb = dtb;
+	index->size_dt_struct = fdt_size_dt_struct(dtb);
+	fdtw_active_index = index;
+
+	return 0;
+}
+
+/*
+ * Stop using the index of 'dtb', if any. To be called before changing the
+ * layout of the DTB.
+ */
+void fdtw_index_invalidate(const void *dtb)
+{
+	if ((fdtw_active_index != NULL) && (fdtw_active_index->dtb == dtb)) {
+		fdtw_active_index->dtb = NULL;
+		fdtw_active_index = NULL;
+	}
+}
+
+static const struct fdtw_index *fdtw_get_index(const void *dtb)
+{
+	const struct fdtw_index *index = fdtw_active_index;
+
+	if ((index == NULL) || (index->dtb != dtb)) {
+		return NULL;
+	}
+
+	if (fdt_size_dt_struct(dtb) != index->size_dt_struct) {
+		fdtw_index_invalidate(dtb);
+		return NULL;
+	}
+
+	return index;
+}
+
+/*
+ * Same as fdt_parent_offset(), in O(log(n)) when 'dtb' is indexed.
+ */
+int fdtw_parent_offset(const void *dtb, int node)
+{
+	const struct fdtw_index *index = fdtw_get_index(dtb);
+	unsigned int lo, hi, mid;
+
+	if (index == NULL) {
+		return fdt_parent_offset(dtb, node);
+	}
+
+	lo = 0U;
+	hi = index->nr_nodes;
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2U);
+		if (index->nodes[mid].offset == node) {
+			return index->nodes[mid].parent;
+		}
+		if (index->nodes[mid].offset < node) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return -FDT_ERR_BADOFFSET;
+}
+
+/*
+ * Same as fdt_node_offset_by_phandle(), in O(log(n)) when 'dtb' is indexed.
+ */
+int fdtw_node_offset_by_phandle(const void *dtb, uint32_t phandle)
+{
+	const struct fdtw_index *index = fdtw_get_index(dtb);
+	unsigned int lo, hi, mid;
+
+	if (index == NULL) {
+		return fdt_node_offset_by_phandle(dtb, phandle);
+	}
+
+	if ((phandle == 0U) || (phandle == (uint32_t)-1)) {
+		return -FDT_ERR_BADPHANDLE;
+	}
+
+	lo = 0U;
+	hi = index->nr_phandles;
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2U);
+		if (index->phandles[mid].phandle == phandle) {
+			return index->phandles[mid].offset;
+		}
+		if (index->phandles[mid].phandle < phandle) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return -FDT_ERR_NOTFOUND;
+}
+
+/*
+ * Same as fdt_find_max_phandle(), without scanning the DTB when it is indexed.
+ */
+int fdtw_find_max_phandle(const void *dtb, uint32_t *phandle)
+{
+	const struct fdtw_index *index = fdtw_get_index(dtb);
+
+	if (index == NULL) {
+		return fdt_find_max_phandle(dtb, phandle);
+	}
+
+	*phandle = (index->nr_phandles == 0U) ? 0U :
+		   index->phandles[index->nr_phandles - 1U].phandle;
+
+	return 0;
+}
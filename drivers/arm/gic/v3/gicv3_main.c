@@ -44,14 +44,47 @@ static bool is_sgi_ppi(unsigned int id);
 #define SAVE_GICR_REG(base, ctx, name, i)	\
 	(ctx)->gicr_##name[(i)] = gicr_read_##name((base), (i))
 
-/* Helper macros to save and restore GICD registers to and from the context */
-#define RESTORE_GICD_REGS(base, ctx, intr_num, reg, REG)		\
+#if GICV3_DIST_SPARSE_CTX
+/* MMIO accesses of the last distributor save and restore */
+static gicv3_dist_ctx_stats_t gicv3_dist_ctx_stats;
+
+#define GICD_CTX_STAT_INC(field)	(gicv3_dist_ctx_stats.field++)
+
+/* The Distributor resets to zero: registers saved as zero are not restored */
+#define GICD_SKIP_RESET_VAL		true
+#else
+#define GICD_CTX_STAT_INC(field)
+#define GICD_SKIP_RESET_VAL		false
+#endif
+
+/*
+ * Zero is a no-op for the write-1-to-set GICD_IS{ENABLE,PEND,ACTIVE}R<n>
+ * registers, so zero values are never restored to them.
+ */
+#define GICD_SKIP_SET_ONLY		true
+
+/*
+ * Helper macros to save and restore GICD registers to and from the context.
+ * Words that hold zero are not written back if 'skip_zero' is true.
+ */
+#define RESTORE_GICD_VAL(base, reg, int_id, val, skip_zero)		\
+	do {								\
+		if ((skip_zero) && ((val) == 0U)) {			\
+			GICD_CTX_STAT_INC(restore_skipped);		\
+		} else {						\
+			gicd_write_##reg((base), (int_id), (val));	\
+			GICD_CTX_STAT_INC(restore_writes);		\
+		}							\
+	} while (false)
+
+#define RESTORE_GICD_REGS(base, ctx, intr_num, reg, REG, skip_zero)	\
 	do {								\
 		for (unsigned int int_id = MIN_SPI_ID; int_id < (intr_num);\
 				int_id += (1U << REG##R_SHIFT)) {	\
-			gicd_write_##reg((base), int_id,		\
+			RESTORE_GICD_VAL((base), reg, int_id,		\
 				(ctx)->gicd_##reg[(int_id - MIN_SPI_ID) >> \
-							REG##R_SHIFT]);	\
+							REG##R_SHIFT],	\
+				(skip_zero));				\
 		}							\
 	} while (false)
 
@@ -61,18 +94,20 @@ static bool is_sgi_ppi(unsigned int id);
 				int_id += (1U << REG##R_SHIFT)) {	\
 			(ctx)->gicd_##reg[(int_id - MIN_SPI_ID) >>	\
 			REG##R_SHIFT] = gicd_read_##reg((base), int_id); \
+			GICD_CTX_STAT_INC(save_reads);			\
 		}							\
 	} while (false)
 
 #if GIC_EXT_INTID
-#define RESTORE_GICD_EREGS(base, ctx, intr_num, reg, REG)		\
+#define RESTORE_GICD_EREGS(base, ctx, intr_num, reg, REG, skip_zero)	\
 	do {								\
 		for (unsigned int int_id = MIN_ESPI_ID; int_id < (intr_num);\
 				int_id += (1U << REG##R_SHIFT)) {	\
-			gicd_write_##reg((base), int_id,		\
+			RESTORE_GICD_VAL((base), reg, int_id,		\
 			(ctx)->gicd_##reg[(int_id - (MIN_ESPI_ID -	\
 			round_up(TOTAL_SPI_INTR_NUM, 1U << REG##R_SHIFT)))\
-						>> REG##R_SHIFT]);	\
+						>> REG##R_SHIFT],	\
+				(skip_zero));				\
 		}							\
 	} while (false)
 
@@ -83,11 +118,12 @@ static bool is_sgi_ppi(unsigned int id);
 			(ctx)->gicd_##reg[(int_id - (MIN_ESPI_ID -	\
 			round_up(TOTAL_SPI_INTR_NUM, 1U << REG##R_SHIFT)))\
 			>> REG##R_SHIFT] = gicd_read_##reg((base), int_id);\
+			GICD_CTX_STAT_INC(save_reads);			\
 		}							\
 	} while (false)
 #else
 #define SAVE_GICD_EREGS(base, ctx, intr_num, reg, REG)
-#define RESTORE_GICD_EREGS(base, ctx, intr_num, reg, REG)
+#define RESTORE_GICD_EREGS(base, ctx, intr_num, reg, REG, skip_zero)
 #endif /* GIC_EXT_INTID */
 
 /*******************************************************************************
@@ -747,6 +783,12 @@ void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx)
 	unsigned int num_eints = gicv3_get_espi_limit(gicd_base);
 #endif
 
+#if GICV3_DIST_SPARSE_CTX
+	gicv3_dist_ctx_stats.save_reads = 0U;
+	gicv3_dist_ctx_stats.restore_writes = 0U;
+	gicv3_dist_ctx_stats.restore_skipped = 0U;
+#endif
+
 	/* Wait for pending write to complete */
 	gicd_wait_for_pending_write(gicd_base);
 
@@ -849,40 +891,52 @@ void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 	unsigned int num_eints = gicv3_get_espi_limit(gicd_base);
 #endif
 	/* Restore GICD_IGROUPR for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igroupr, IGROUP);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igroupr,
+		IGROUP, GICD_SKIP_RESET_VAL);
 
 	/* Restore GICD_IGROUPRE for INTIDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, igroupr, IGROUP);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, igroupr,
+		IGROUP, GICD_SKIP_RESET_VAL);
 
 	/* Restore GICD_IPRIORITYR for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ipriorityr, IPRIORITY);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ipriorityr,
+		IPRIORITY, GICD_SKIP_RESET_VAL);
 
 	/* Restore GICD_IPRIORITYRE for INTIDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, ipriorityr, IPRIORITY);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, ipriorityr,
+		IPRIORITY, GICD_SKIP_RESET_VAL);
 
 	/* Restore GICD_ICFGR for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, icfgr, ICFG);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, icfgr,
+		ICFG, GICD_SKIP_RESET_VAL);
 
 	/* Restore GICD_ICFGRE for INTIDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, icfgr, ICFG);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, icfgr,
+		ICFG, GICD_SKIP_RESET_VAL);
 
 	/* Restore GICD_IGRPMODR for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igrpmodr, IGRPMOD);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igrpmodr,
+		IGRPMOD, GICD_SKIP_RESET_VAL);
 
 	/* Restore GICD_IGRPMODRE for INTIDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, igrpmodr, IGRPMOD);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, igrpmodr,
+		IGRPMOD, GICD_SKIP_RESET_VAL);
 
 	/* Restore GICD_NSACR for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, nsacr, NSAC);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, nsacr,
+		NSAC, GICD_SKIP_RESET_VAL);
 
 	/* Restore GICD_NSACRE for INTIDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, nsacr, NSAC);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, nsacr,
+		NSAC, GICD_SKIP_RESET_VAL);
 
 	/* Restore GICD_IROUTER for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, irouter, IROUTE);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, irouter,
+		IROUTE, GICD_SKIP_RESET_VAL);
 
 	/* Restore GICD_IROUTERE for INTIDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, irouter, IROUTE);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, irouter,
+		IROUTE, GICD_SKIP_RESET_VAL);
 
 	/*
 	 * Restore ISENABLER(E), ISPENDR(E) and ISACTIVER(E) after
@@ -890,27 +944,53 @@ void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 	 */
 
 	/* Restore GICD_ISENABLER for INT_IDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLE);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isenabler,
+		ISENABLE, GICD_SKIP_SET_ONLY);
 
 	/* Restore GICD_ISENABLERE for INT_IDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, isenabler, ISENABLE);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, isenabler,
+		ISENABLE, GICD_SKIP_SET_ONLY);
 
 	/* Restore GICD_ISPENDR for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPEND);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ispendr,
+		ISPEND, GICD_SKIP_SET_ONLY);
 
 	/* Restore GICD_ISPENDRE for INTIDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, ispendr, ISPEND);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, ispendr,
+		ISPEND, GICD_SKIP_SET_ONLY);
 
 	/* Restore GICD_ISACTIVER for INTIDs 32 - 1019 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVE);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isactiver,
+		ISACTIVE, GICD_SKIP_SET_ONLY);
 
 	/* Restore GICD_ISACTIVERE for INTIDs 4096 - 5119 */
-	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, isactiver, ISACTIVE);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_eints, isactiver,
+		ISACTIVE, GICD_SKIP_SET_ONLY);
 
 	/* Restore the GICD_CTLR */
 	gicd_write_ctlr(gicd_base, dist_ctx->gicd_ctlr);
 	gicd_wait_for_pending_write(gicd_base);
+
+#if GICV3_DIST_SPARSE_CTX
+	VERBOSE("GICD context: %u reads, %u writes, %u writes skipped\n",
+		gicv3_dist_ctx_stats.save_reads,
+		gicv3_dist_ctx_stats.restore_writes,
+		gicv3_dist_ctx_stats.restore_skipped);
+#endif
+}
+
+#if GICV3_DIST_SPARSE_CTX
+/*******************************************************************************
+ * Return the number of Distributor register accesses made by the last calls to
+ * gicv3_distif_save() and gicv3_distif_init_restore().
+ ******************************************************************************/
+void gicv3_distif_get_ctx_stats(gicv3_dist_ctx_stats_t *stats)
+{
+	assert(stats != NULL);
+
+	*stats = gicv3_dist_ctx_stats;
 }
+#endif /* GICV3_DIST_SPARSE_CTX */
 
 /*******************************************************************************
  * This function gets the priority of the interrupt the processor is currently
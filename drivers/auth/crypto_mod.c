@@ -5,12 +5,33 @@
  */
 
 #include <assert.h>
+#include <string.h>
 
 #include <common/debug.h>
 #include <drivers/auth/crypto_mod.h>
 
 /* Variable exported by the crypto library through REGISTER_CRYPTO_LIB() */
 
+#if CRYPTO_DIGEST_CACHE
+/*
+ * Digests of the last image whose hash was verified. They are kept until the
+ * next hash verification or calculation, which covers the measurement of an
+ * image right after its authentication. load_image() and io_read() drop them,
+ * so that they never outlive a reload of the buffer.
+ */
+static struct {
+	const void *data_ptr;
+	unsigned int data_len;
+	unsigned int valid;	/* Bitmap of enum crypto_md_algo */
+	unsigned char digest[CRYPTO_MD_NUM][CRYPTO_MD_MAX_SIZE];
+	size_t digest_len[CRYPTO_MD_NUM];
+} crypto_digest_cache;
+
+/* Algorithm of the measured boot driver */
+static bool crypto_digest_cache_md_set;
+static enum crypto_md_algo crypto_digest_cache_md;
+#endif /* CRYPTO_DIGEST_CACHE */
+
 /*
  * The crypto module is responsible for verifying digital signatures and hashes.
  * It relies on a crypto library to perform the cryptographic operations.
@@ -112,6 +133,11 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 	assert(digest_info_ptr != NULL);
 	assert(digest_info_len != 0);
 
+#if CRYPTO_DIGEST_CACHE
+	/* The library stores the digests again if the hash matches */
+	crypto_digest_cache.valid = 0U;
+#endif
+
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
@@ -137,11 +163,85 @@ int crypto_mod_calc_hash(enum crypto_md_algo alg, void *data_ptr,
 	assert(data_len != 0);
 	assert(output != NULL);
 
+#if CRYPTO_DIGEST_CACHE
+	/* Entries are only used once, whether they match or not */
+	if (((crypto_digest_cache.valid & (1U << alg)) != 0U) &&
+	    (crypto_digest_cache.data_ptr == data_ptr) &&
+	    (crypto_digest_cache.data_len == data_len)) {
+		(void)memcpy(output, crypto_digest_cache.digest[alg],
+			     crypto_digest_cache.digest_len[alg]);
+		crypto_digest_cache.valid = 0U;
+		return CRYPTO_SUCCESS;
+	}
+
+	crypto_digest_cache.valid = 0U;
+#endif
+
 	return crypto_lib_desc.calc_hash(alg, data_ptr, data_len, output);
 }
 #endif /* CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
+#if CRYPTO_DIGEST_CACHE
+/*
+ * Set the algorithm that the crypto library should calculate in addition to the
+ * one of the verified hash.
+ */
+void crypto_mod_digest_cache_set_md(enum crypto_md_algo alg)
+{
+	assert((unsigned int)alg < CRYPTO_MD_NUM);
+
+	crypto_digest_cache_md = alg;
+	crypto_digest_cache_md_set = true;
+}
+
+bool crypto_mod_digest_cache_get_md(enum crypto_md_algo *alg)
+{
+	assert(alg != NULL);
+
+	*alg = crypto_digest_cache_md;
+	return crypto_digest_cache_md_set;
+}
+
+/*
+ * Store the digest of a buffer whose hash has just been verified
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: hashed data
+ *   alg: message digest algorithm
+ *   digest, digest_len: digest of the data
+ */
+void crypto_mod_digest_cache_store(const void *data_ptr, unsigned int data_len,
+				   enum crypto_md_algo alg,
+				   const unsigned char *digest,
+				   size_t digest_len)
+{
+	assert((unsigned int)alg < CRYPTO_MD_NUM);
+	assert(digest_len <= CRYPTO_MD_MAX_SIZE);
+
+	if ((crypto_digest_cache.data_ptr != data_ptr) ||
+	    (crypto_digest_cache.data_len != data_len)) {
+		crypto_digest_cache.data_ptr = data_ptr;
+		crypto_digest_cache.data_len = data_len;
+		crypto_digest_cache.valid = 0U;
+	}
+
+	(void)memcpy(crypto_digest_cache.digest[alg], digest, digest_len);
+	crypto_digest_cache.digest_len[alg] = digest_len;
+	crypto_digest_cache.valid |= 1U << alg;
+}
+
+/*
+ * Drop the cached digests, called before data is read into memory that may
+ * hold the cached buffer.
+ */
+void crypto_mod_digest_cache_invalidate(void)
+{
+	crypto_digest_cache.valid = 0U;
+}
+#endif /* CRYPTO_DIGEST_CACHE */
+
 /*
  * Authenticated decryption of data
  *
@@ -20,10 +20,25 @@
 #include <drivers/auth/crypto_mod.h>
 #include <drivers/auth/mbedtls/mbedtls_common.h>
 #include <drivers/auth/mbedtls/mbedtls_config.h>
+#if ENABLE_SHA_CE
+#include <drivers/auth/sha_ce.h>
+#endif
 #include <plat/common/platform.h>
 
 #define LIB_NAME		"mbed TLS"
 
+/*
+ * The SHA instructions are only used in BL1 and BL2. The SHA-CE code saves
+ * the SIMD registers it uses, which is the whole FP state of the lower ELs
+ * only as long as SVE and SME are not enabled for them. BL31 may run with the
+ * SVE and SME state of the Normal world live (e.g. for DRTM).
+ */
+#if ENABLE_SHA_CE && (defined(IMAGE_BL1) || defined(IMAGE_BL2))
+#define USE_SHA_CE		1
+#else
+#define USE_SHA_CE		0
+#endif
+
 #if CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 /*
@@ -53,6 +68,73 @@ CASSERT(CRYPTO_MD_MAX_SIZE >= MBEDTLS_MD_MAX_SIZE,
  * }
  */
 
+#if CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
+CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
+/*
+ * Map a generic crypto message digest algorithm to the corresponding macro used
+ * by Mbed TLS.
+ */
+static inline mbedtls_md_type_t md_type(enum crypto_md_algo algo)
+{
+	switch (algo) {
+	case CRYPTO_MD_SHA512:
+		return MBEDTLS_MD_SHA512;
+	case CRYPTO_MD_SHA384:
+		return MBEDTLS_MD_SHA384;
+	case CRYPTO_MD_SHA256:
+		return MBEDTLS_MD_SHA256;
+	default:
+		/* Invalid hash algorithm. */
+		return MBEDTLS_MD_NONE;
+	}
+}
+#endif /* CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
+	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
+
+#if USE_SHA_CE || CRYPTO_DIGEST_CACHE
+/*
+ * Map a Mbed TLS message digest type to the corresponding generic crypto
+ * algorithm. Return false if there is none.
+ */
+static bool md_algo(mbedtls_md_type_t type, enum crypto_md_algo *algo)
+{
+	switch (type) {
+	case MBEDTLS_MD_SHA256:
+		*algo = CRYPTO_MD_SHA256;
+		return true;
+	case MBEDTLS_MD_SHA384:
+		*algo = CRYPTO_MD_SHA384;
+		return true;
+	case MBEDTLS_MD_SHA512:
+		*algo = CRYPTO_MD_SHA512;
+		return true;
+	default:
+		return false;
+	}
+}
+#endif /* USE_SHA_CE || CRYPTO_DIGEST_CACHE */
+
+#if USE_SHA_CE
+/*
+ * Calculate a hash with the Armv8 SHA instructions if the CPU implements them,
+ * with mbed TLS otherwise.
+ */
+static int md_calc(const mbedtls_md_info_t *md_info, const unsigned char *input,
+		   size_t ilen, unsigned char *output)
+{
+	enum crypto_md_algo algo;
+
+	if (md_algo(mbedtls_md_get_type(md_info), &algo) &&
+	    (sha_ce_calc_hash(algo, input, ilen, output) == CRYPTO_SUCCESS)) {
+		return 0;
+	}
+
+	return mbedtls_md(md_info, input, ilen, output);
+}
+#else
+#define md_calc		mbedtls_md
+#endif /* USE_SHA_CE */
+
 /*
  * Initialize the library and export the descriptor
  */
@@ -128,7 +210,7 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 		goto end1;
 	}
 	p = (unsigned char *)data_ptr;
-	rc = mbedtls_md(md_info, p, data_len, hash);
+	rc = md_calc(md_info, p, data_len, hash);
 	if (rc != 0) {
 		rc = CRYPTO_ERR_SIGNATURE;
 		goto end1;
@@ -153,6 +235,98 @@ end2:
 	return rc;
 }
 
+#if CRYPTO_DIGEST_CACHE
+#define MD_DUAL_CHUNK_SIZE	U(0x1000)
+
+/*
+ * Calculate the hashes of the data with two algorithms in a single pass, one
+ * chunk at a time, so that the data is only read once from memory.
+ */
+static int md_calc_dual(const mbedtls_md_info_t *md_info1,
+			const mbedtls_md_info_t *md_info2,
+			const unsigned char *input, size_t ilen,
+			unsigned char *output1, unsigned char *output2)
+{
+	mbedtls_md_context_t ctx1, ctx2;
+	size_t off, chunk;
+	int rc;
+
+	mbedtls_md_init(&ctx1);
+	mbedtls_md_init(&ctx2);
+
+	rc = mbedtls_md_setup(&ctx1, md_info1, 0);
+	if (rc == 0) {
+		rc = mbedtls_md_setup(&ctx2, md_info2, 0);
+	}
+	if (rc == 0) {
+		rc = mbedtls_md_starts(&ctx1);
+	}
+	if (rc == 0) {
+		rc = mbedtls_md_starts(&ctx2);
+	}
+
+	for (off = 0U; (rc == 0) && (off < ilen); off += chunk) {
+		chunk = MIN(ilen - off, (size_t)MD_DUAL_CHUNK_SIZE);
+		rc = mbedtls_md_update(&ctx1, &input[off], chunk);
+		if (rc == 0) {
+			rc = mbedtls_md_update(&ctx2, &input[off], chunk);
+		}
+	}
+
+	if (rc == 0) {
+		rc = mbedtls_md_finish(&ctx1, output1);
+	}
+	if (rc == 0) {
+		rc = mbedtls_md_finish(&ctx2, output2);
+	}
+
+	mbedtls_md_free(&ctx1);
+	mbedtls_md_free(&ctx2);
+
+	return rc;
+}
+
+/*
+ * Calculate the hash of the data to verify, together with the hash that the
+ * measured boot driver needs if it uses another algorithm. Store both in the
+ * digest cache of the crypto module once the hash is verified.
+ */
+static int md_calc_cached(const mbedtls_md_info_t *md_info,
+			  const unsigned char *input, size_t ilen,
+			  unsigned char *output,
+			  const mbedtls_md_info_t **mboot_md_info,
+			  unsigned char *mboot_output)
+{
+	enum crypto_md_algo mboot_algo;
+
+	*mboot_md_info = NULL;
+	if (crypto_mod_digest_cache_get_md(&mboot_algo)) {
+		*mboot_md_info = mbedtls_md_info_from_type(md_type(mboot_algo));
+	}
+
+	if ((*mboot_md_info == NULL) || (*mboot_md_info == md_info)) {
+		*mboot_md_info = NULL;
+		return md_calc(md_info, input, ilen, output);
+	}
+
+	return md_calc_dual(md_info, *mboot_md_info, input, ilen, output,
+			    mboot_output);
+}
+
+static void md_cache_store(const void *data_ptr, unsigned int data_len,
+			   const mbedtls_md_info_t *md_info,
+			   const unsigned char *digest)
+{
+	enum crypto_md_algo algo;
+
+	if ((md_info != NULL) &&
+	    md_algo(mbedtls_md_get_type(md_info), &algo)) {
+		crypto_mod_digest_cache_store(data_ptr, data_len, algo, digest,
+					      mbedtls_md_get_size(md_info));
+	}
+}
+#endif /* CRYPTO_DIGEST_CACHE */
+
 /*
  * Match a hash
  *
@@ -167,6 +341,10 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	const mbedtls_md_info_t *md_info;
 	unsigned char *p, *end, *hash;
 	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+#if CRYPTO_DIGEST_CACHE
+	const mbedtls_md_info_t *mboot_md_info;
+	unsigned char mboot_hash[MBEDTLS_MD_MAX_SIZE];
+#endif
 	size_t len;
 	int rc;
 
@@ -209,7 +387,12 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
-	rc = mbedtls_md(md_info, p, data_len, data_hash);
+#if CRYPTO_DIGEST_CACHE
+	rc = md_calc_cached(md_info, p, data_len, data_hash, &mboot_md_info,
+			    mboot_hash);
+#else
+	rc = md_calc(md_info, p, data_len, data_hash);
+#endif
 	if (rc != 0) {
 		return CRYPTO_ERR_HASH;
 	}
@@ -220,6 +403,12 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
+#if CRYPTO_DIGEST_CACHE
+	/* Keep the digests for the measurement of the data */
+	md_cache_store(data_ptr, data_len, md_info, data_hash);
+	md_cache_store(data_ptr, data_len, mboot_md_info, mboot_hash);
+#endif
+
 	return CRYPTO_SUCCESS;
 }
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
@@ -227,25 +416,6 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 
 #if CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
-/*
- * Map a generic crypto message digest algorithm to the corresponding macro used
- * by Mbed TLS.
- */
-static inline mbedtls_md_type_t md_type(enum crypto_md_algo algo)
-{
-	switch (algo) {
-	case CRYPTO_MD_SHA512:
-		return MBEDTLS_MD_SHA512;
-	case CRYPTO_MD_SHA384:
-		return MBEDTLS_MD_SHA384;
-	case CRYPTO_MD_SHA256:
-		return MBEDTLS_MD_SHA256;
-	default:
-		/* Invalid hash algorithm. */
-		return MBEDTLS_MD_NONE;
-	}
-}
-
 /*
  * Calculate a hash
  *
@@ -267,7 +437,7 @@ static int calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
 	 * 'output' hash buffer pointer considering its size is always
 	 * bigger than or equal to MBEDTLS_MD_MAX_SIZE.
 	 */
-	return mbedtls_md(md_info, data_ptr, data_len, output);
+	return md_calc(md_info, data_ptr, data_len, output);
 }
 #endif /* CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
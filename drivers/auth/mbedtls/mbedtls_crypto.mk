@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2015-2023, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -8,4 +8,10 @@ include drivers/auth/mbedtls/mbedtls_common.mk
 
 MBEDTLS_SOURCES	+=		drivers/auth/mbedtls/mbedtls_crypto.c
 
+ifeq (${ENABLE_SHA_CE},1)
+MBEDTLS_SOURCES	+=		drivers/auth/sha_ce/sha_ce.c			\
+				drivers/auth/sha_ce/aarch64/sha256_ce.S		\
+				drivers/auth/sha_ce/aarch64/sha512_ce.S
+endif
+
 
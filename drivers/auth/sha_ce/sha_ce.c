@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <drivers/auth/sha_ce.h>
+#include <lib/utils_def.h>
+
+#define SHA256_BLOCK_SIZE	U(64)
+#define SHA256_LEN_SIZE		U(8)
+#define SHA256_DIGEST_SIZE	U(32)
+
+#define SHA512_BLOCK_SIZE	U(128)
+#define SHA512_LEN_SIZE		U(16)
+#define SHA384_DIGEST_SIZE	U(48)
+#define SHA512_DIGEST_SIZE	U(64)
+
+static const uint32_t sha256_iv[8] = {
+	0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+	0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U,
+};
+
+static const uint64_t sha384_iv[8] = {
+	0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL,
+	0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
+	0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL,
+	0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL,
+};
+
+static const uint64_t sha512_iv[8] = {
+	0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL,
+	0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+	0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+	0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL,
+};
+
+static unsigned int sha_ce_support(void)
+{
+	return (unsigned int)((read_id_aa64isar0_el1() >>
+			       ID_AA64ISAR0_SHA2_SHIFT) &
+			      ID_AA64ISAR0_SHA2_MASK);
+}
+
+/*
+ * Build the last one or two blocks of a message in 'tail': the 'rem' trailing
+ * bytes of the message, the padding and the message length in bits. Return
+ * the number of blocks built.
+ */
+static size_t sha_ce_pad(uint8_t *tail, const uint8_t *src, size_t rem,
+			 size_t data_len, size_t block_size, size_t len_size)
+{
+	size_t tail_len;
+	uint64_t bits = (uint64_t)data_len << 3;
+	unsigned int i;
+
+	tail_len = ((rem + 1U + len_size) <= block_size) ? block_size :
+							   2U * block_size;
+
+	(void)memcpy(tail, src, rem);
+	tail[rem] = 0x80U;
+	(void)memset(&tail[rem + 1U], 0, tail_len - rem - 1U);
+
+	for (i = 0U; i < sizeof(bits); i++) {
+		tail[tail_len - 1U - i] = (uint8_t)(bits >> (8U * i));
+	}
+
+	return tail_len / block_size;
+}
+
+static void sha256_ce(const uint8_t *data, size_t data_len,
+		      unsigned char *output)
+{
+	uint32_t state[8];
+	uint8_t tail[2U * SHA256_BLOCK_SIZE];
+	size_t nblocks = data_len / SHA256_BLOCK_SIZE;
+	unsigned int i;
+
+	(void)memcpy(state, sha256_iv, sizeof(state));
+
+	if (nblocks != 0U) {
+		sha256_ce_blocks(state, data, nblocks);
+	}
+
+	nblocks = sha_ce_pad(tail, &data[nblocks * SHA256_BLOCK_SIZE],
+			     data_len % SHA256_BLOCK_SIZE, data_len,
+			     SHA256_BLOCK_SIZE, SHA256_LEN_SIZE);
+	sha256_ce_blocks(state, tail, nblocks);
+
+	for (i = 0U; i < SHA256_DIGEST_SIZE; i++) {
+		output[i] = (uint8_t)(state[i / 4U] >> (24U - (8U * (i % 4U))));
+	}
+}
+
+static void sha512_ce(const uint64_t iv[8], const uint8_t *data,
+		      size_t data_len, unsigned char *output,
+		      size_t digest_size)
+{
+	uint64_t state[8];
+	uint8_t tail[2U * SHA512_BLOCK_SIZE];
+	size_t nblocks = data_len / SHA512_BLOCK_SIZE;
+	unsigned int i;
+
+	(void)memcpy(state, iv, sizeof(state));
+
+	if (nblocks != 0U) {
+		sha512_ce_blocks(state, data, nblocks);
+	}
+
+	nblocks = sha_ce_pad(tail, &data[nblocks * SHA512_BLOCK_SIZE],
+			     data_len % SHA512_BLOCK_SIZE, data_len,
+			     SHA512_BLOCK_SIZE, SHA512_LEN_SIZE);
+	sha512_ce_blocks(state, tail, nblocks);
+
+	for (i = 0U; i < digest_size; i++) {
+		output[i] = (uint8_t)(state[i / 8U] >> (56U - (8U * (i % 8U))));
+	}
+}
+
+int sha_ce_calc_hash(enum crypto_md_algo md_algo, const void *data_ptr,
+		     size_t data_len, unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	unsigned int support = sha_ce_support();
+
+	switch (md_algo) {
+	case CRYPTO_MD_SHA256:
+		if (support < ID_AA64ISAR0_SHA2_SHA256) {
+			return CRYPTO_ERR_HASH;
+		}
+		sha256_ce(data_ptr, data_len, output);
+		break;
+	case CRYPTO_MD_SHA384:
+		if (support < ID_AA64ISAR0_SHA2_SHA512) {
+			return CRYPTO_ERR_HASH;
+		}
+		sha512_ce(sha384_iv, data_ptr, data_len, output,
+			  SHA384_DIGEST_SIZE);
+		break;
+	case CRYPTO_MD_SHA512:
+		if (support < ID_AA64ISAR0_SHA2_SHA512) {
+			return CRYPTO_ERR_HASH;
+		}
+		sha512_ce(sha512_iv, data_ptr, data_len, output,
+			  SHA512_DIGEST_SIZE);
+		break;
+	default:
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
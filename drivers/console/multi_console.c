@@ -8,11 +8,50 @@
 #include <stddef.h>
 #include <stdlib.h>
 
+#include <platform_def.h>
+
+#include <arch_helpers.h>
 #include <drivers/console.h>
+#include <lib/cassert.h>
 
 console_t *console_list;
 uint8_t console_state = CONSOLE_FLAG_BOOT;
 
+#if DEFERRED_CONSOLE
+/*
+ * While the console state is CONSOLE_FLAG_BOOT, characters are stored in a
+ * memory ring and only sent to the consoles when console_drain() or
+ * console_flush() is called, or when the ring is full. The ring can be placed
+ * in a platform reserved region so that later stages can read the boot log.
+ */
+#ifdef PLAT_DEFERRED_CONSOLE_BASE
+#define CONSOLE_RING_SIZE	(PLAT_DEFERRED_CONSOLE_SIZE - sizeof(console_ring_t))
+console_ring_t *const console_ring =
+	(console_ring_t *)PLAT_DEFERRED_CONSOLE_BASE;
+#else
+#define CONSOLE_RING_SIZE	U(0x1000)
+static struct {
+	console_ring_t hdr;
+	char data[CONSOLE_RING_SIZE];
+} console_ring_storage;
+console_ring_t *const console_ring = &console_ring_storage.hdr;
+#endif
+
+/* The ring is also drained by asm_console_drain() on the crash path */
+CASSERT(CONSOLE_RING_T_MAGIC == __builtin_offsetof(console_ring_t, magic),
+	assert_console_ring_t_magic_offset_mismatch);
+CASSERT(CONSOLE_RING_T_SIZE == __builtin_offsetof(console_ring_t, size),
+	assert_console_ring_t_size_offset_mismatch);
+CASSERT(CONSOLE_RING_T_WRITE_POS ==
+	__builtin_offsetof(console_ring_t, write_pos),
+	assert_console_ring_t_write_pos_offset_mismatch);
+CASSERT(CONSOLE_RING_T_DRAIN_POS ==
+	__builtin_offsetof(console_ring_t, drain_pos),
+	assert_console_ring_t_drain_pos_offset_mismatch);
+CASSERT(CONSOLE_RING_T_DATA == __builtin_offsetof(console_ring_t, data),
+	assert_console_ring_t_data_offset_mismatch);
+#endif /* DEFERRED_CONSOLE */
+
 IMPORT_SYM(console_t *, __STACKS_START__, stacks_start)
 IMPORT_SYM(console_t *, __STACKS_END__, stacks_end)
 
@@ -62,6 +101,10 @@ int console_is_registered(console_t *to_find)
 
 void console_switch_state(unsigned int new_state)
 {
+#if DEFERRED_CONSOLE
+	/* Send the buffered output to the consoles of the current state */
+	console_drain();
+#endif
 	console_state = new_state;
 }
 
@@ -86,7 +129,7 @@ static int do_putc(int c, console_t *console)
 	return console->putc(c, console);
 }
 
-int console_putc(int c)
+static int console_putc_all(int c)
 {
 	int err = ERROR_NO_VALID_CONSOLE;
 	console_t *console;
@@ -100,6 +143,63 @@ int console_putc(int c)
 	return err;
 }
 
+#if DEFERRED_CONSOLE
+static void console_ring_init(void)
+{
+	/* Keep appending to a log left by the previous stage */
+	if ((console_ring->magic == CONSOLE_RING_MAGIC) &&
+	    (console_ring->size == CONSOLE_RING_SIZE) &&
+	    (console_ring->drain_pos <= console_ring->write_pos))
+		return;
+
+	console_ring->size = CONSOLE_RING_SIZE;
+	console_ring->write_pos = 0U;
+	console_ring->drain_pos = 0U;
+	console_ring->magic = CONSOLE_RING_MAGIC;
+}
+
+void console_drain(void)
+{
+	uint64_t pos;
+
+	console_ring_init();
+
+	for (pos = console_ring->drain_pos; pos != console_ring->write_pos;
+	     pos++)
+		(void)console_putc_all(console_ring->data[pos % CONSOLE_RING_SIZE]);
+
+	console_ring->drain_pos = pos;
+}
+
+static int console_ring_putc(int c)
+{
+	console_ring_init();
+
+	/* Make room by sending the oldest output out synchronously */
+	if ((console_ring->write_pos - console_ring->drain_pos) ==
+	    CONSOLE_RING_SIZE)
+		console_drain();
+
+	console_ring->data[console_ring->write_pos % CONSOLE_RING_SIZE] =
+		(char)c;
+	console_ring->write_pos++;
+
+	return 0;
+}
+#endif /* DEFERRED_CONSOLE */
+
+int console_putc(int c)
+{
+#if DEFERRED_CONSOLE
+	/* Boot output is single threaded and can be deferred */
+	if (console_state == CONSOLE_FLAG_BOOT)
+		return console_ring_putc(c);
+
+	console_drain();
+#endif
+	return console_putc_all(c);
+}
+
 int putchar(int c)
 {
 	if (console_putc(c) == 0)
@@ -132,6 +232,14 @@ void console_flush(void)
 {
 	console_t *console;
 
+#if DEFERRED_CONSOLE
+	console_drain();
+#ifdef PLAT_DEFERRED_CONSOLE_BASE
+	/* Make the log visible to the next stage, whatever its cache state */
+	flush_dcache_range((uintptr_t)console_ring, PLAT_DEFERRED_CONSOLE_SIZE);
+#endif
+#endif
+
 	for (console = console_list; console != NULL; console = console->next)
 		if ((console->flags & console_state) && (console->flush != NULL)) {
 			console->flush(console);
@@ -9,6 +9,7 @@
 
 #include <platform_def.h>
 
+#include <drivers/auth/crypto_mod.h>
 #include <drivers/io/io_driver.h>
 #include <drivers/io/io_storage.h>
 
@@ -278,6 +279,11 @@ int io_read(uintptr_t handle,
 
 	io_dev_info_t *dev = entity->dev_handle;
 
+#if CRYPTO_DIGEST_CACHE && (defined(IMAGE_BL1) || defined(IMAGE_BL2))
+	/* The buffer may hold data whose digest is cached */
+	crypto_mod_digest_cache_invalidate();
+#endif
+
 	if (dev->funcs->read != NULL)
 		result = dev->funcs->read(entity, buffer, length, length_read);
 
@@ -13,19 +13,26 @@
 #include <common/debug.h>
 #include <drivers/auth/crypto_mod.h>
 #include <drivers/measured_boot/event_log/event_log.h>
+#include <lib/cassert.h>
 
 #include <plat/common/platform.h>
 
 #if TPM_ALG_ID == TPM_ALG_SHA512
 #define	CRYPTO_MD_ID	CRYPTO_MD_SHA512
+#define	CRYPTO_MD_SIZE	SHA512_DIGEST_SIZE
 #elif TPM_ALG_ID == TPM_ALG_SHA384
 #define	CRYPTO_MD_ID	CRYPTO_MD_SHA384
+#define	CRYPTO_MD_SIZE	SHA384_DIGEST_SIZE
 #elif TPM_ALG_ID == TPM_ALG_SHA256
 #define	CRYPTO_MD_ID	CRYPTO_MD_SHA256
+#define	CRYPTO_MD_SIZE	SHA256_DIGEST_SIZE
 #else
 #  error Invalid TPM algorithm.
 #endif /* TPM_ALG_ID */
 
+/* The digest is calculated straight into the TCG_DIGEST_SIZE bytes of a record */
+CASSERT(CRYPTO_MD_SIZE == TCG_DIGEST_SIZE, assert_event_log_digest_size);
+
 /* Running Event Log Pointer */
 static uint8_t *log_ptr;
 
@@ -81,33 +88,46 @@ static const event2_header_t locality_event_header = {
 };
 
 /*
- * Record a measurement as a TCG_PCR_EVENT2 event
- *
- * @param[in] hash		Pointer to hash data of TCG_DIGEST_SIZE bytes
- * @param[in] event_type	Type of Event, Various Event Types are
- * 				mentioned in tcg.h header
- * @param[in] metadata_ptr	Pointer to event_log_metadata_t structure
+ * Offsets of the digest and of TCG_PCR_EVENT2.EventSize from the start of a
+ * TCG_PCR_EVENT2 with a single digest.
+ */
+#define EVENT2_DIGEST_OFFSET	(offsetof(event2_header_t, digests) +	  \
+				 offsetof(tpml_digest_values, digests) + \
+				 offsetof(tpmt_ha, digest))
+#define EVENT2_DATA_OFFSET	(EVENT2_DIGEST_OFFSET + TCG_DIGEST_SIZE)
+
+static uint32_t event_log_name_len(const event_log_metadata_t *metadata_ptr)
+{
+	if (metadata_ptr->name == NULL) {
+		return 0U;
+	}
+
+	return (uint32_t)strlen(metadata_ptr->name) + 1U;
+}
+
+/*
+ * Reserve a TCG_PCR_EVENT2 at the end of the Event Log and fill in its header.
+ * The record is not part of the log until event_log_record_end() is called, so
+ * a caller that fails to produce the digest simply does not end the record.
  *
- * There must be room for storing this new event into the event log buffer.
+ * @param[in] event_type	Type of the event
+ * @param[in] metadata_ptr	Metadata of the event
+ * @return:
+ *	Pointer to the TCG_DIGEST_SIZE bytes of the digest in the record
  */
-void event_log_record(const uint8_t *hash, uint32_t event_type,
-		      const event_log_metadata_t *metadata_ptr)
+uint8_t *event_log_record_begin(uint32_t event_type,
+				const event_log_metadata_t *metadata_ptr)
 {
-	void *ptr = log_ptr;
-	uint32_t name_len = 0U;
+	event2_header_t *hdr = (event2_header_t *)log_ptr;
+	tpmt_ha *digest;
 
-	assert(hash != NULL);
 	assert(metadata_ptr != NULL);
 	/* event_log_buf_init() must have been called prior to this. */
 	assert(log_ptr != NULL);
 
-	if (metadata_ptr->name != NULL) {
-		name_len = (uint32_t)strlen(metadata_ptr->name) + 1U;
-	}
-
 	/* Check for space in Event Log buffer */
-	assert(((uintptr_t)ptr + (uint32_t)EVENT2_HDR_SIZE + name_len) <
-	       log_end);
+	assert(((uintptr_t)log_ptr + (uint32_t)EVENT2_HDR_SIZE +
+		event_log_name_len(metadata_ptr)) < log_end);
 
 	/*
 	 * As per TCG specifications, firmware components that are measured
@@ -115,43 +135,74 @@ void event_log_record(const uint8_t *hash, uint32_t event_type,
 	 * EV_POST_CODE.
 	 */
 	/* TCG_PCR_EVENT2.PCRIndex */
-	((event2_header_t *)ptr)->pcr_index = metadata_ptr->pcr;
+	hdr->pcr_index = metadata_ptr->pcr;
 
 	/* TCG_PCR_EVENT2.EventType */
-	((event2_header_t *)ptr)->event_type = event_type;
+	hdr->event_type = event_type;
 
 	/* TCG_PCR_EVENT2.Digests.Count */
-	ptr = (uint8_t *)ptr + offsetof(event2_header_t, digests);
-	((tpml_digest_values *)ptr)->count = HASH_ALG_COUNT;
-
-	/* TCG_PCR_EVENT2.Digests[] */
-	ptr = (uint8_t *)((uintptr_t)ptr +
-			offsetof(tpml_digest_values, digests));
+	hdr->digests.count = HASH_ALG_COUNT;
 
 	/* TCG_PCR_EVENT2.Digests[].AlgorithmId */
-	((tpmt_ha *)ptr)->algorithm_id = TPM_ALG_ID;
+	digest = (tpmt_ha *)((uintptr_t)log_ptr + EVENT2_DIGEST_OFFSET -
+			     offsetof(tpmt_ha, digest));
+	digest->algorithm_id = TPM_ALG_ID;
 
 	/* TCG_PCR_EVENT2.Digests[].Digest[] */
-	ptr = (uint8_t *)((uintptr_t)ptr + offsetof(tpmt_ha, digest));
+	return log_ptr + EVENT2_DIGEST_OFFSET;
+}
 
-	/* Copy digest */
-	(void)memcpy(ptr, (const void *)hash, TCG_DIGEST_SIZE);
+/*
+ * Complete the record reserved by event_log_record_begin(), once its digest
+ * has been written, and append it to the Event Log.
+ *
+ * @param[in] metadata_ptr	Metadata passed to event_log_record_begin()
+ */
+void event_log_record_end(const event_log_metadata_t *metadata_ptr)
+{
+	event2_data_t *data = (event2_data_t *)((uintptr_t)log_ptr +
+						EVENT2_DATA_OFFSET);
+	uint32_t name_len = event_log_name_len(metadata_ptr);
 
 	/* TCG_PCR_EVENT2.EventSize */
-	ptr = (uint8_t *)((uintptr_t)ptr + TCG_DIGEST_SIZE);
-	((event2_data_t *)ptr)->event_size = name_len;
+	data->event_size = name_len;
 
 	/* Copy event data to TCG_PCR_EVENT2.Event */
-	if (metadata_ptr->name != NULL) {
-		(void)memcpy((void *)(((event2_data_t *)ptr)->event),
-				(const void *)metadata_ptr->name, name_len);
+	if (name_len != 0U) {
+		(void)memcpy((void *)data->event,
+			     (const void *)metadata_ptr->name, name_len);
 	}
 
 	/* End of event data */
-	log_ptr = (uint8_t *)((uintptr_t)ptr +
+	log_ptr = (uint8_t *)((uintptr_t)data +
 			offsetof(event2_data_t, event) + name_len);
 }
 
+/*
+ * Record a measurement as a TCG_PCR_EVENT2 event
+ *
+ * @param[in] hash		Pointer to hash data of TCG_DIGEST_SIZE bytes
+ * @param[in] event_type	Type of Event, Various Event Types are
+ * 				mentioned in tcg.h header
+ * @param[in] metadata_ptr	Pointer to event_log_metadata_t structure
+ *
+ * There must be room for storing this new event into the event log buffer.
+ */
+void event_log_record(const uint8_t *hash, uint32_t event_type,
+		      const event_log_metadata_t *metadata_ptr)
+{
+	uint8_t *digest;
+
+	assert(hash != NULL);
+
+	digest = event_log_record_begin(event_type, metadata_ptr);
+
+	/* Copy digest */
+	(void)memcpy(digest, (const void *)hash, TCG_DIGEST_SIZE);
+
+	event_log_record_end(metadata_ptr);
+}
+
 void event_log_buf_init(uint8_t *event_log_start, uint8_t *event_log_finish)
 {
 	assert(event_log_start != NULL);
@@ -177,6 +228,11 @@ void event_log_init(uint8_t *event_log_start, uint8_t *event_log_finish)
 	/* Get pointer to platform's event_log_metadata_t structure */
 	plat_metadata_ptr = plat_event_log_get_metadata();
 	assert(plat_metadata_ptr != NULL);
+
+#if CRYPTO_DIGEST_CACHE
+	/* Ask image authentication to also calculate our digests */
+	crypto_mod_digest_cache_set_md(CRYPTO_MD_ID);
+#endif
 }
 
 void event_log_write_specid_event(void)
@@ -261,8 +317,18 @@ void event_log_write_header(void)
 	log_ptr = (uint8_t *)((uintptr_t)ptr + sizeof(startup_locality_event_t));
 }
 
+/*
+ * Calculate the hash of data with the algorithm of the Event Log.
+ *
+ * @param[in] data_base		Address of data
+ * @param[in] data_size		Size of data
+ * @param[out] hash_data	Buffer of TCG_DIGEST_SIZE bytes for the hash
+ * @return:
+ *	0 = success
+ *    < 0 = error
+ */
 int event_log_measure(uintptr_t data_base, uint32_t data_size,
-		      unsigned char hash_data[CRYPTO_MD_MAX_SIZE])
+		      uint8_t *hash_data)
 {
 	/* Calculate hash */
 	return crypto_mod_calc_hash(CRYPTO_MD_ID,
@@ -283,7 +349,7 @@ int event_log_measure(uintptr_t data_base, uint32_t data_size,
 int event_log_measure_and_record(uintptr_t data_base, uint32_t data_size,
 				 uint32_t data_id)
 {
-	unsigned char hash_data[CRYPTO_MD_MAX_SIZE];
+	uint8_t *digest;
 	int rc;
 	const event_log_metadata_t *metadata_ptr = plat_metadata_ptr;
 
@@ -294,13 +360,17 @@ int event_log_measure_and_record(uintptr_t data_base, uint32_t data_size,
 	}
 	assert(metadata_ptr->id != EVLOG_INVALID_ID);
 
-	/* Measure the payload with algorithm selected by EventLog driver */
-	rc = event_log_measure(data_base, data_size, hash_data);
+	/*
+	 * Measure the payload with algorithm selected by EventLog driver,
+	 * straight into the record.
+	 */
+	digest = event_log_record_begin(EV_POST_CODE, metadata_ptr);
+	rc = event_log_measure(data_base, data_size, digest);
 	if (rc != 0) {
 		return rc;
 	}
 
-	event_log_record(hash_data, EV_POST_CODE, metadata_ptr);
+	event_log_record_end(metadata_ptr);
 
 	return 0;
 }
@@ -56,6 +56,11 @@ void rss_measured_boot_init(void)
 			strlen((const char *)&metadata_ptr->sw_type) + 1;
 		metadata_ptr++;
 	}
+
+#if CRYPTO_DIGEST_CACHE
+	/* Ask image authentication to also calculate our digests */
+	crypto_mod_digest_cache_set_md(CRYPTO_MD_ID);
+#endif
 }
 
 int rss_mboot_measure_and_record(uintptr_t data_base, uint32_t data_size,
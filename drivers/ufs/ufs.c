@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <endian.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -17,6 +18,7 @@
 #include <drivers/delay_timer.h>
 #include <drivers/ufs.h>
 #include <lib/mmio.h>
+#include <lib/utils_def.h>
 
 #define CDB_ADDR_MASK			127
 #define ALIGN_CDB(x)			(((x) + CDB_ADDR_MASK) & ~CDB_ADDR_MASK)
@@ -25,11 +27,26 @@
 #define UFS_DESC_SIZE			0x400
 #define MAX_UFS_DESC_SIZE		0x8000		/* 32 descriptors */
 
+/*
+ * The UTP Transfer Request List takes the first UFS_DESC_SIZE bytes of the
+ * descriptor area (up to 32 slots of 32 bytes). It is followed by one
+ * UFS_DESC_SIZE command descriptor per slot so that all slots can be in
+ * flight at the same time.
+ */
+#define UFS_UTRL_SIZE			UFS_DESC_SIZE
+#define UFS_MAX_NUTRS			(CAP_NUTRS_MASK + 1)
+
 #define MAX_PRDT_SIZE			0x40000		/* 256KB */
 
+/* Largest transfer issued on a single slot by ufs_read_blocks_queued() */
+#define UFS_QUEUED_MAX_XFER		(8 * MAX_PRDT_SIZE)
+
 static ufs_params_t ufs_params;
 static int nutrs;	/* Number of UTP Transfer Request Slots */
 
+/* Slots in flight in ufs_read_blocks_queued() */
+static utp_utrd_t ufs_queued_utrd[UFS_MAX_NUTRS];
+
 int ufshc_send_uic_cmd(uintptr_t base, uic_cmd_t *cmd)
 {
 	unsigned int data;
@@ -252,26 +269,24 @@ static int get_empty_slot(int *slot)
 	return 0;
 }
 
-static void get_utrd(utp_utrd_t *utrd)
+static void ufs_setup_utrd(utp_utrd_t *utrd, int slot)
 {
 	uintptr_t base;
-	int slot = 0, result;
 	utrd_header_t *hd;
 
-	assert(utrd != NULL);
-	result = get_empty_slot(&slot);
-	assert(result == 0);
-
 	/* clear utrd */
 	memset((void *)utrd, 0, sizeof(utp_utrd_t));
 	base = ufs_params.desc_base + (slot * sizeof(utrd_header_t));
-	/* clear the descriptor */
-	memset((void *)base, 0, UFS_DESC_SIZE);
+	/* clear the transfer request descriptor and its command descriptor */
+	memset((void *)base, 0, sizeof(utrd_header_t));
+	memset((void *)(ufs_params.desc_base + UFS_UTRL_SIZE +
+			(slot * UFS_DESC_SIZE)), 0, UFS_DESC_SIZE);
 
 	utrd->header = base;
 	utrd->task_tag = slot + 1;
 	/* CDB address should be aligned with 128 bytes */
-	utrd->upiu = ALIGN_CDB(utrd->header + sizeof(utrd_header_t));
+	utrd->upiu = ALIGN_CDB(ufs_params.desc_base + UFS_UTRL_SIZE +
+			       (slot * UFS_DESC_SIZE));
 	utrd->resp_upiu = ALIGN_8(utrd->upiu + sizeof(cmd_upiu_t));
 	utrd->size_upiu = utrd->resp_upiu - utrd->upiu;
 	utrd->size_resp_upiu = ALIGN_8(sizeof(resp_upiu_t));
@@ -283,9 +298,37 @@ static void get_utrd(utp_utrd_t *utrd)
 	/* Both RUL and RUO is based on DWORD */
 	hd->rul = utrd->size_resp_upiu >> 2;
 	hd->ruo = utrd->size_upiu >> 2;
+}
+
+static void get_utrd(utp_utrd_t *utrd)
+{
+	int slot = 0, result;
+
+	assert(utrd != NULL);
+	result = get_empty_slot(&slot);
+	assert(result == 0);
+
+	ufs_setup_utrd(utrd, slot);
 	(void)result;
 }
 
+/* Write back the transfer request and command descriptors of a slot */
+static void ufs_flush_utrd(utp_utrd_t *utrd)
+{
+	flush_dcache_range(utrd->header, sizeof(utrd_header_t));
+	flush_dcache_range(utrd->upiu, UFS_DESC_SIZE);
+}
+
+/*
+ * Invalidate the descriptors of a slot after the controller has completed it
+ * to avoid the cpu referring to data prefetched before DMA completion.
+ */
+static void ufs_inv_utrd(utp_utrd_t *utrd)
+{
+	inv_dcache_range(utrd->header, sizeof(utrd_header_t));
+	inv_dcache_range(utrd->upiu, UFS_DESC_SIZE);
+}
+
 /*
  * Prepare UTRD, Command UPIU, Response UPIU.
  */
@@ -381,7 +424,7 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 		hd->prdto = (utrd->size_upiu + utrd->size_resp_upiu) >> 2;
 	}
 
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	ufs_flush_utrd(utrd);
 	return 0;
 }
 
@@ -433,7 +476,7 @@ static int ufs_prepare_query(utp_utrd_t *utrd, uint8_t op, uint8_t idn,
 		assert(0);
 		break;
 	}
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	ufs_flush_utrd(utrd);
 	return 0;
 }
 
@@ -451,7 +494,7 @@ static void ufs_prepare_nop_out(utp_utrd_t *utrd)
 
 	nop_out->trans_type = 0;
 	nop_out->task_tag = utrd->task_tag;
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	ufs_flush_utrd(utrd);
 }
 
 static void ufs_send_request(int task_tag)
@@ -497,7 +540,7 @@ static int ufs_check_resp(utp_utrd_t *utrd, int trans_type)
 	 * completed to avoid cpu referring to the prefetched
 	 * data brought in before DMA completion.
 	 */
-	inv_dcache_range((uintptr_t)hd, UFS_DESC_SIZE);
+	ufs_inv_utrd(utrd);
 	assert(hd->ocs == OCS_SUCCESS);
 	assert((resp->trans_type & TRANS_TYPE_CODE_MASK) == trans_type);
 
@@ -746,6 +789,173 @@ size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
 	return size - resp->res_trans_cnt;
 }
 
+/*
+ * Submit a READ_10 of 'length' bytes on 'slot'. The doorbell of the slot is
+ * rung without waiting for other slots to complete.
+ */
+static void ufs_queue_read(int slot, uint8_t lun, int lba, uintptr_t buf,
+			   size_t length)
+{
+	utp_utrd_t *utrd = &ufs_queued_utrd[slot];
+	int result;
+
+	ufs_setup_utrd(utrd, slot);
+	result = ufs_prepare_cmd(utrd, CDBCMD_READ_10, lun, lba, buf, length);
+	assert(result == 0);
+	(void)result;
+
+	mmio_write_32(ufs_params.reg_base + UTRLDBR, 1U << slot);
+}
+
+/*
+ * Check the outcome of a completed slot. Returns the number of bytes
+ * transferred, or -EAGAIN if the command has to be issued again.
+ */
+static int ufs_queued_resp(int slot, size_t length, size_t *xfer)
+{
+	utp_utrd_t *utrd = &ufs_queued_utrd[slot];
+	utrd_header_t *hd = (utrd_header_t *)utrd->header;
+	resp_upiu_t *resp = (resp_upiu_t *)utrd->resp_upiu;
+	sense_data_t *sense = &resp->sd.sense;
+
+	ufs_inv_utrd(utrd);
+	if ((hd->ocs != OCS_SUCCESS) ||
+	    ((resp->trans_type & TRANS_TYPE_CODE_MASK) != RESPONSE_UPIU)) {
+		return -EIO;
+	}
+
+	if (sense->resp_code == SENSE_DATA_VALID &&
+	    sense->sense_key == SENSE_KEY_UNIT_ATTENTION && sense->asc == 0x29 &&
+	    sense->ascq == 0) {
+		WARN("Unit Attention Condition\n");
+		return -EAGAIN;
+	}
+
+	*xfer = length - resp->res_trans_cnt;
+	return 0;
+}
+
+/*
+ * Abort the commands still in flight on the 'pending' slots, so that the
+ * controller no longer writes to the buffer once the read has returned. If the
+ * controller does not release the slots, it is disabled to stop the DMA.
+ */
+static void ufs_queued_abort(unsigned int pending)
+{
+	int timeout;
+
+	/* Slots are cleared by writing 0 to their bit */
+	mmio_write_32(ufs_params.reg_base + UTRLCLR, ~pending);
+
+	timeout = UTRLCLR_TIMEOUT_US;
+	do {
+		if ((mmio_read_32(ufs_params.reg_base + UTRLDBR) &
+		     pending) == 0U) {
+			return;
+		}
+		udelay(1);
+	} while (--timeout > 0);
+
+	ERROR("UFS: failed to abort queued read, disabling controller\n");
+	if (ufshc_hce_disable(ufs_params.reg_base) != 0) {
+		panic();
+	}
+}
+
+/*
+ * Read 'size' bytes split across all the transfer request slots. Each slot
+ * is refilled with the next part of the buffer as soon as it completes, in
+ * whichever order the device completes them. Returns the number of bytes
+ * read, or 0 if any of the commands failed.
+ */
+size_t ufs_read_blocks_queued(int lun, int lba, uintptr_t buf, size_t size)
+{
+	size_t chunk, offset = 0, done = 0;
+	size_t slot_off[UFS_MAX_NUTRS], slot_len[UFS_MAX_NUTRS];
+	int slot_retries[UFS_MAX_NUTRS];
+	unsigned int pending = 0U, completed, data;
+	bool failed = false;
+	size_t xfer;
+	int slot, result;
+
+	assert((ufs_params.reg_base != 0) &&
+	       (ufs_params.desc_base != 0) &&
+	       (ufs_params.desc_size >= (UFS_UTRL_SIZE + UFS_DESC_SIZE)) &&
+	       ((size & UFS_BLOCK_MASK) == 0));
+
+	/* Spread the transfer evenly over the slots, in whole blocks */
+	chunk = (size + nutrs - 1) / nutrs;
+	chunk = (chunk + UFS_BLOCK_MASK) & ~(size_t)UFS_BLOCK_MASK;
+	if (chunk > UFS_QUEUED_MAX_XFER) {
+		chunk = UFS_QUEUED_MAX_XFER;
+	}
+
+	/* clear all interrupts and make sure the list is running */
+	mmio_write_32(ufs_params.reg_base + IS, ~0);
+	mmio_write_32(ufs_params.reg_base + UTRLRSR, 1);
+
+	while ((offset < size) || (pending != 0U)) {
+		/* Fill the free slots */
+		for (slot = 0; (slot < nutrs) && (offset < size) && !failed;
+		     slot++) {
+			if ((pending & (1U << slot)) != 0U) {
+				continue;
+			}
+			slot_off[slot] = offset;
+			slot_len[slot] = MIN(chunk, size - offset);
+			slot_retries[slot] = 0;
+			ufs_queue_read(slot, lun,
+				       lba + (int)(offset >> UFS_BLOCK_SHIFT),
+				       buf + offset, slot_len[slot]);
+			pending |= 1U << slot;
+			offset += slot_len[slot];
+		}
+
+		data = mmio_read_32(ufs_params.reg_base + IS);
+		if ((data & (UFS_INT_UTPES | UFS_INT_DFES | UFS_INT_HCFES |
+			     UFS_INT_SBFES | UFS_INT_UE)) != 0U) {
+			ERROR("UFS: queued read failed (IS 0x%x)\n", data);
+			ufs_queued_abort(pending);
+			inv_dcache_range(buf, size);
+			return 0;
+		}
+
+		/* Slots whose doorbell has been cleared by the controller */
+		completed = pending &
+			    ~mmio_read_32(ufs_params.reg_base + UTRLDBR);
+		for (slot = 0; completed != 0U; slot++, completed >>= 1) {
+			if ((completed & 1U) == 0U) {
+				continue;
+			}
+			pending &= ~(1U << slot);
+
+			result = ufs_queued_resp(slot, slot_len[slot], &xfer);
+			if ((result == -EAGAIN) && !failed &&
+			    (++slot_retries[slot] < UFS_CMD_RETRIES)) {
+				ufs_queue_read(slot, lun,
+					lba + (int)(slot_off[slot] >>
+						    UFS_BLOCK_SHIFT),
+					buf + slot_off[slot], slot_len[slot]);
+				pending |= 1U << slot;
+			} else if (result != 0) {
+				/* Stop issuing and drain the other slots */
+				failed = true;
+				offset = size;
+			} else {
+				done += xfer;
+			}
+		}
+	}
+
+	/*
+	 * Invalidate prefetched cache contents before cpu
+	 * accesses the buf.
+	 */
+	inv_dcache_range(buf, size);
+
+	return failed ? 0 : done;
+}
+
 size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
 {
 	utp_utrd_t utrd;
@@ -846,14 +1056,14 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 	assert((params != NULL) &&
 	       (params->reg_base != 0) &&
 	       (params->desc_base != 0) &&
-	       (params->desc_size >= UFS_DESC_SIZE));
+	       (params->desc_size >= (UFS_UTRL_SIZE + UFS_DESC_SIZE)));
 
 	memcpy(&ufs_params, params, sizeof(ufs_params_t));
 
 	/* 0 means 1 slot */
 	nutrs = (mmio_read_32(ufs_params.reg_base + CAP) & CAP_NUTRS_MASK) + 1;
-	if (nutrs > (ufs_params.desc_size / UFS_DESC_SIZE)) {
-		nutrs = ufs_params.desc_size / UFS_DESC_SIZE;
+	if (nutrs > ((ufs_params.desc_size - UFS_UTRL_SIZE) / UFS_DESC_SIZE)) {
+		nutrs = (ufs_params.desc_size - UFS_UTRL_SIZE) / UFS_DESC_SIZE;
 	}
 
 
@@ -244,6 +244,15 @@
 #define ID_AA64ISAR0_RNDR_SHIFT	U(60)
 #define ID_AA64ISAR0_RNDR_MASK	ULL(0xf)
 
+#define ID_AA64ISAR0_TLB_SHIFT		U(56)
+#define ID_AA64ISAR0_TLB_MASK		ULL(0xf)
+#define ID_AA64ISAR0_TLB_RANGE		ULL(2)
+
+#define ID_AA64ISAR0_SHA2_SHIFT		U(12)
+#define ID_AA64ISAR0_SHA2_MASK		ULL(0xf)
+#define ID_AA64ISAR0_SHA2_SHA256	U(1)
+#define ID_AA64ISAR0_SHA2_SHA512	U(2)
+
 /* ID_AA64ISAR1_EL1 definitions */
 #define ID_AA64ISAR1_EL1		S3_0_C0_C6_1
 
@@ -932,6 +941,24 @@
 #define TLBI_ADDR_MASK		ULL(0x00000FFFFFFFFFFF)
 #define TLBI_ADDR(x)		(((x) >> TLBI_ADDR_SHIFT) & TLBI_ADDR_MASK)
 
+/*
+ * Operand of the TLBI range instructions (FEAT_TLBIRANGE). They invalidate
+ * (NUM + 1) * 2^(5 * SCALE + 1) pages of the TG granule size from BADDR.
+ */
+#define TLBIR_BADDR_MASK	ULL(0x1FFFFFFFFF)
+#define TLBIR_NUM_SHIFT		U(39)
+#define TLBIR_NUM_MASK		ULL(0x1F)
+#define TLBIR_SCALE_SHIFT	U(44)
+#define TLBIR_SCALE_MASK	ULL(0x3)
+#define TLBIR_TG_SHIFT		U(46)
+#define TLBIR_TG_4K		ULL(1)
+#define TLBIR_TG_16K		ULL(2)
+#define TLBIR_TG_64K		ULL(3)
+
+/* Number of pages invalidated by a TLBI range instruction */
+#define TLBIR_PAGES(num, scale)	(((num) + 1U) << ((5U * (scale)) + 1U))
+#define TLBIR_MAX_PAGES		TLBIR_PAGES(TLBIR_NUM_MASK, TLBIR_SCALE_MASK)
+
 /*******************************************************************************
  * Definitions of register offsets and fields in the CNTCTLBase Frame of the
  * system level implementation of the Generic Timer.
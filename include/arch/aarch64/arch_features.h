@@ -67,6 +67,12 @@ static inline bool is_armv8_4_dit_present(void)
 		ID_AA64PFR0_DIT_MASK) == 1U;
 }
 
+static inline bool is_feat_tlbirange_present(void)
+{
+	return ((read_id_aa64isar0_el1() >> ID_AA64ISAR0_TLB_SHIFT) &
+		ID_AA64ISAR0_TLB_MASK) >= ID_AA64ISAR0_TLB_RANGE;
+}
+
 static inline bool is_armv8_4_ttst_present(void)
 {
 	return ((read_id_aa64mmfr2_el1() >> ID_AA64MMFR2_EL1_ST_SHIFT) &
@@ -142,6 +142,7 @@ DEFINE_SYSOP_TYPE_FUNC(tlbi, alle2is)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle3)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle3is)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1)
+DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1is)
 #elif ERRATA_A76_1286807
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle1)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle1is)
@@ -150,6 +151,7 @@ DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle2is)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle3)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(alle3is)
 DEFINE_TLBIOP_ERRATA_TYPE_FUNC(vmalle1)
+DEFINE_TLBIOP_ERRATA_TYPE_FUNC(vmalle1is)
 #else
 DEFINE_SYSOP_TYPE_FUNC(tlbi, alle1)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, alle1is)
@@ -158,6 +160,7 @@ DEFINE_SYSOP_TYPE_FUNC(tlbi, alle2is)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, alle3)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, alle3is)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1)
+DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1is)
 #endif
 
 #if ERRATA_A57_813419
@@ -616,6 +619,26 @@ static inline void tlbipaallos(void)
 	__asm__("SYS #6,c8,c1,#4");
 }
 
+/*
+ * TLBI RVAAE1IS, RVAE2IS and RVAE3IS instructions
+ * (TLB Invalidate by VA Range, Inner Shareable), from FEAT_TLBIRANGE.
+ * See the TLBIR_* definitions for the format of the operand.
+ */
+static inline void tlbirvaae1is(uint64_t v)
+{
+	__asm__("SYS #0,c8,c2,#3,%0" : : "r" (v));
+}
+
+static inline void tlbirvae2is(uint64_t v)
+{
+	__asm__("SYS #4,c8,c2,#1,%0" : : "r" (v));
+}
+
+static inline void tlbirvae3is(uint64_t v)
+{
+	__asm__("SYS #6,c8,c2,#1,%0" : : "r" (v));
+}
+
 /*
  * Invalidate TLBs of GPT entries by Physical address, last level.
  *
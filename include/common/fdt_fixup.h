@@ -23,6 +23,7 @@ struct psci_cpu_idle_state {
 	uint32_t wakeup_latency_us;
 };
 
+void fdt_fixup_index(const void *dtb);
 int dt_add_psci_node(void *fdt);
 int dt_add_psci_cpu_enable_methods(void *fdt);
 int fdt_add_reserved_memory(void *dtb, const char *node_name,
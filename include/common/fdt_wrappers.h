@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -46,6 +46,55 @@ int fdtw_for_each_cpu(const void *fdt,
 
 int fdtw_find_or_add_subnode(void *fdt, int parentoffset, const char *name);
 
+/*
+ * Optional index of the nodes of a DTB, built in one pass by fdtw_index_init().
+ * While it is valid, fdtw_parent_offset() and fdtw_node_offset_by_phandle()
+ * look nodes up in it instead of scanning the DTB from its start, and so do
+ * the wrappers above. Any write which adds, removes or resizes a node or a
+ * property invalidates it: the wrappers and fixups which do so call
+ * fdtw_index_invalidate(), and the index is also ignored once the size of the
+ * structure block of the DTB changes. fconf_populate() indexes the DTBs it
+ * parses, and fdt_fixup_index() the DTB about to be fixed up, when the platform
+ * defines PLAT_FCONF_FDT_INDEX_NODES.
+ */
+struct fdtw_index_node {
+	int offset;
+	int parent;
+};
+
+struct fdtw_index_phandle {
+	uint32_t phandle;
+	int offset;
+};
+
+struct fdtw_index {
+	const void *dtb;
+	uint32_t size_dt_struct;
+	struct fdtw_index_node *nodes;
+	unsigned int max_nodes;
+	unsigned int nr_nodes;
+	struct fdtw_index_phandle *phandles;
+	unsigned int max_phandles;
+	unsigned int nr_phandles;
+};
+
+/* Define a static index with room for the given numbers of entries */
+#define FDTW_INDEX_DECLARE(_name, _max_nodes, _max_phandles)		\
+	static struct fdtw_index_node _name##_nodes[(_max_nodes)];	\
+	static struct fdtw_index_phandle _name##_phandles[(_max_phandles)]; \
+	static struct fdtw_index _name = {				\
+		.nodes = _name##_nodes,					\
+		.max_nodes = (_max_nodes),				\
+		.phandles = _name##_phandles,				\
+		.max_phandles = (_max_phandles),			\
+	}
+
+int fdtw_index_init(struct fdtw_index *index, const void *dtb);
+void fdtw_index_invalidate(const void *dtb);
+int fdtw_parent_offset(const void *dtb, int node);
+int fdtw_node_offset_by_phandle(const void *dtb, uint32_t phandle);
+int fdtw_find_max_phandle(const void *dtb, uint32_t *phandle);
+
 static inline uint32_t fdt_blob_size(const void *dtb)
 {
 	const uint32_t *dtb_header = dtb;
@@ -532,6 +532,13 @@ typedef struct gicv3_dist_ctx {
 	uint32_t gicd_nsacr[GICD_NUM_REGS(NSACR)];
 } gicv3_dist_ctx_t;
 
+/* Distributor register accesses of the last context save and restore */
+typedef struct gicv3_dist_ctx_stats {
+	unsigned int save_reads;
+	unsigned int restore_writes;
+	unsigned int restore_skipped;
+} gicv3_dist_ctx_stats_t;
+
 typedef struct gicv3_its_ctx {
 	/* 64 bits registers */
 	uint64_t gits_cbaser;
@@ -560,6 +567,9 @@ unsigned int gicv3_get_interrupt_type(unsigned int id,
 					  unsigned int proc_num);
 void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx);
 void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx);
+#if GICV3_DIST_SPARSE_CTX
+void gicv3_distif_get_ctx_stats(gicv3_dist_ctx_stats_t *stats);
+#endif
 /*
  * gicv3_distif_post_restore and gicv3_distif_pre_save must be implemented if
  * gicv3_distif_save and gicv3_rdistif_init_restore are used. If no
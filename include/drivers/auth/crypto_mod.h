@@ -7,6 +7,9 @@
 #ifndef CRYPTO_MOD_H
 #define CRYPTO_MOD_H
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #define	CRYPTO_AUTH_VERIFY_ONLY			1
 #define	CRYPTO_HASH_CALC_ONLY			2
 #define	CRYPTO_AUTH_VERIFY_AND_HASH_CALC	3
@@ -36,6 +39,9 @@ enum crypto_md_algo {
 	CRYPTO_MD_SHA512,
 };
 
+/* Number of message digest algorithms */
+#define CRYPTO_MD_NUM			3U
+
 /* Maximum size as per the known stronger hash algorithm i.e.SHA512 */
 #define CRYPTO_MD_MAX_SIZE		64U
 
@@ -119,6 +125,23 @@ int crypto_mod_calc_hash(enum crypto_md_algo alg, void *data_ptr,
 #endif /* CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
+#if CRYPTO_DIGEST_CACHE
+/*
+ * Digests calculated by the crypto library while verifying the hash of an
+ * image, which crypto_mod_calc_hash() returns if the same image is hashed next.
+ * The measured boot driver sets the algorithm it uses, so that the library can
+ * calculate it in the same pass when the image is authenticated with another
+ * algorithm.
+ */
+void crypto_mod_digest_cache_set_md(enum crypto_md_algo alg);
+bool crypto_mod_digest_cache_get_md(enum crypto_md_algo *alg);
+void crypto_mod_digest_cache_store(const void *data_ptr, unsigned int data_len,
+				   enum crypto_md_algo alg,
+				   const unsigned char *digest,
+				   size_t digest_len);
+void crypto_mod_digest_cache_invalidate(void);
+#endif /* CRYPTO_DIGEST_CACHE */
+
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash, \
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef SHA_CE_H
+#define SHA_CE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <drivers/auth/crypto_mod.h>
+
+/* Block functions implemented with the Armv8 SHA-256 and SHA-512 instructions */
+void sha256_ce_blocks(uint32_t state[8], const uint8_t *data, size_t nblocks);
+void sha512_ce_blocks(uint64_t state[8], const uint8_t *data, size_t nblocks);
+
+/*
+ * Calculate the hash of a buffer with the SHA instructions. Return
+ * CRYPTO_ERR_HASH if the CPU does not implement the instructions required by
+ * the algorithm, in which case the caller must fall back to a software
+ * implementation.
+ */
+int sha_ce_calc_hash(enum crypto_md_algo md_algo, const void *data_ptr,
+		     size_t data_len, unsigned char output[CRYPTO_MD_MAX_SIZE]);
+
+#endif /* SHA_CE_H */
@@ -25,6 +25,15 @@
 /* Bits 8 to 31 for non-scope use. */
 #define CONSOLE_FLAG_TRANSLATE_CRLF	(U(1) << 8)
 
+/* Layout of console_ring_t, the memory ring used by DEFERRED_CONSOLE */
+#define CONSOLE_RING_MAGIC		U(0x434f4e53)	/* "CONS" */
+
+#define CONSOLE_RING_T_MAGIC		U(0)
+#define CONSOLE_RING_T_SIZE		U(4)
+#define CONSOLE_RING_T_WRITE_POS	U(8)
+#define CONSOLE_RING_T_DRAIN_POS	U(16)
+#define CONSOLE_RING_T_DATA		U(24)
+
 /* Returned by getc callbacks when receive FIFO is empty. */
 #define ERROR_NO_PENDING_CHAR		(-1)
 /* Returned by console_xxx() if no registered console implements xxx. */
@@ -78,6 +87,26 @@ int console_getc(void);
 /* Flush all consoles registered for the current state. */
 void console_flush(void);
 
+#if DEFERRED_CONSOLE
+/*
+ * Memory ring holding the output of the boot console state. 'write_pos' and
+ * 'drain_pos' count the bytes written to the ring and sent to the consoles
+ * since it was set up; the last 'size' bytes of the log are in data[].
+ */
+typedef struct console_ring {
+	uint32_t magic;
+	uint32_t size;
+	uint64_t write_pos;
+	uint64_t drain_pos;
+	char data[];
+} console_ring_t;
+
+extern console_ring_t *const console_ring;
+
+/* Send the characters buffered in the console ring to the consoles. */
+void console_drain(void);
+#endif /* DEFERRED_CONSOLE */
+
 #endif /* __ASSEMBLER__ */
 
 #endif /* CONSOLE_H */
@@ -275,6 +275,8 @@
 
 #define FDEVICEINIT_TIMEOUT_MS	        1500
 
+#define UTRLCLR_TIMEOUT_US		1000
+
 /**
  * ufs_dev_desc - ufs device details from the device descriptor
  * @wmanufacturerid: card details
@@ -563,6 +565,7 @@ void ufs_clear_flag(int idn);
 void ufs_read_desc(int idn, int index, uintptr_t buf, size_t size);
 void ufs_write_desc(int idn, int index, uintptr_t buf, size_t size);
 size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size);
+size_t ufs_read_blocks_queued(int lun, int lba, uintptr_t buf, size_t size);
 size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size);
 int ufs_init(const ufs_ops_t *ops, ufs_params_t *params);
 
@@ -7,6 +7,8 @@
 #ifndef DEBUGFS_H
 #define DEBUGFS_H
 
+#include <stdint.h>
+
 #define NAMELEN   13 /* Maximum length of a file name */
 #define PATHLEN   41 /* Maximum length of a path */
 #define STATLEN   41 /* Size of static part of dir format */
@@ -59,7 +61,26 @@ void debugfs_init(void);
 int debugfs_smc_setup(void);
 
 /* Debugfs version returned through SMC interface */
-#define DEBUGFS_VERSION		(0x000000001U)
+#define DEBUGFS_VERSION		(0x000000002U)
+
+/* Largest shared buffer accepted by the INIT_BULK command */
+#ifndef DEBUGFS_SHARED_BUF_MAX
+#define DEBUGFS_SHARED_BUF_MAX	(16U * 1024U * 1024U)
+#endif
+
+/* Maximum number of segments of a READ_SG command */
+#define DEBUGFS_SG_MAX		32U
+
+/*******************************************************************************
+ * Segment of a READ_SG command: read up to 'len' bytes of 'fd' to 'offset' in
+ * the shared buffer. 'len' is updated with the number of bytes actually read.
+ ******************************************************************************/
+typedef struct {
+	int32_t		fd;
+	uint32_t	reserved;
+	uint64_t	offset;
+	uint64_t	len;
+} debugfs_sg_t;
 
 /* Function ID for accessing the debugfs interface */
 #define DEBUGFS_FID_VALUE	(0x30U)
@@ -40,7 +40,35 @@ void cm_prepare_el3_exit_ns(void);
 #if CTX_INCLUDE_EL2_REGS
 void cm_el2_sysregs_context_save(uint32_t security_state);
 void cm_el2_sysregs_context_restore(uint32_t security_state);
-#endif
+
+#if CTX_LAZY_EL2_REGS
+/* EL2 system register groups tracked by the lazy context switch */
+#define CM_EL2_GRP_COMMON	U(0)
+#define CM_EL2_GRP_SPE		U(1)
+#define CM_EL2_GRP_MTE		U(2)
+#define CM_EL2_GRP_MPAM		U(3)
+#define CM_EL2_GRP_FGT		U(4)
+#define CM_EL2_GRP_ECV		U(5)
+#define CM_EL2_GRP_VHE		U(6)
+#define CM_EL2_GRP_RAS		U(7)
+#define CM_EL2_GRP_NV2		U(8)
+#define CM_EL2_GRP_TRF		U(9)
+#define CM_EL2_GRP_CSV2		U(10)
+#define CM_EL2_GRP_HCX		U(11)
+#define CM_EL2_GRP_MAX		U(12)
+
+/* Per-CPU, per-group counters of performed and elided saves/restores */
+typedef struct cm_el2_sysregs_stats {
+	uint32_t saved[CM_EL2_GRP_MAX];
+	uint32_t save_skipped[CM_EL2_GRP_MAX];
+	uint32_t restored[CM_EL2_GRP_MAX];
+	uint32_t restore_skipped[CM_EL2_GRP_MAX];
+} cm_el2_sysregs_stats_t;
+
+void cm_el2_sysregs_context_invalidate(void);
+const cm_el2_sysregs_stats_t *cm_el2_sysregs_get_stats(unsigned int cpu_idx);
+#endif /* CTX_LAZY_EL2_REGS */
+#endif /* CTX_INCLUDE_EL2_REGS */
 
 void cm_el1_sysregs_context_save(uint32_t security_state);
 void cm_el1_sysregs_context_restore(uint32_t security_state);
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2023, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef EL3_TRACE_H
+#define EL3_TRACE_H
+
+#include <lib/utils_def.h>
+
+/*
+ * SiP SMC used by the Normal world to hand a shared buffer to the EL3 event
+ * trace. x1 holds the command, x2 and x3 its arguments.
+ */
+#define EL3_TRACE_SMC_64		U(0xC2000060)
+#define EL3_TRACE_FID_VALUE		U(0x60)
+#define is_el3_trace_fid(_fid)	\
+	(((_fid) & FUNCID_NUM_MASK) == EL3_TRACE_FID_VALUE)
+
+/* Commands of EL3_TRACE_SMC_64 */
+#define EL3_TRACE_CMD_INIT		U(0)	/* x2: buffer PA, x3: size */
+#define EL3_TRACE_CMD_START		U(1)
+#define EL3_TRACE_CMD_STOP		U(2)
+
+/* Return values of EL3_TRACE_SMC_64 */
+#define EL3_TRACE_E_SUCCESS		0
+#define EL3_TRACE_E_INVALID_PARAMS	-2
+#define EL3_TRACE_E_DENIED		-3
+
+/* Shared buffer layout */
+#define EL3_TRACE_MAGIC			U(0x45335452)	/* "E3TR" */
+#define EL3_TRACE_VERSION		U(1)
+
+/* Event IDs */
+#define EL3_TRACE_EV_SMC		U(0x01)	/* arg0: flags, arg1: fid, arg2: x1 */
+#define EL3_TRACE_EV_EHF_ACTIVATE	U(0x10)	/* arg0: priority */
+#define EL3_TRACE_EV_EHF_DEACTIVATE	U(0x11)	/* arg0: priority */
+#define EL3_TRACE_EV_SPMD_SWITCH	U(0x20)	/* arg0: to, arg1: fid */
+#define EL3_TRACE_EV_PSCI_CPU_ON	U(0x30)	/* arg1: target MPIDR */
+#define EL3_TRACE_EV_PSCI_CPU_OFF	U(0x31)
+#define EL3_TRACE_EV_PSCI_CPU_SUSPEND	U(0x32)	/* arg0: power_state */
+#define EL3_TRACE_EV_PSCI_WAKEUP	U(0x33)	/* arg0: end power level */
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+/*
+ * The shared buffer starts with an el3_trace_hdr_t, followed by one
+ * el3_trace_cpu_t per CPU, followed by 'entries_per_cpu' el3_trace_entry_t for
+ * each CPU. Each CPU only writes its own ring: an entry is filled before
+ * 'head' is incremented, so a reader can copy the ring, then discard the
+ * entries that the new value of 'head' shows as overwritten.
+ */
+typedef struct el3_trace_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t num_cpus;
+	uint32_t entries_per_cpu;
+	uint64_t timer_freq;
+	uint64_t reserved[5];
+} el3_trace_hdr_t;
+
+typedef struct el3_trace_cpu {
+	uint64_t head;
+	uint64_t reserved[7];
+} el3_trace_cpu_t;
+
+typedef struct el3_trace_entry {
+	uint64_t timestamp;
+	uint32_t id;
+	uint32_t arg0;
+	uint64_t arg1;
+	uint64_t arg2;
+} el3_trace_entry_t;
+
+#if EL3_TRACE
+void el3_trace_event(uint32_t id, uint32_t arg0, uint64_t arg1, uint64_t arg2);
+uintptr_t el3_trace_smc_handler(unsigned int smc_fid,
+				u_register_t x1,
+				u_register_t x2,
+				u_register_t x3,
+				u_register_t x4,
+				void *cookie,
+				void *handle,
+				u_register_t flags);
+
+#define EL3_TRACE_EVENT(_id, _arg0, _arg1, _arg2)			\
+	el3_trace_event((_id), (uint32_t)(_arg0), (uint64_t)(_arg1),	\
+			(uint64_t)(_arg2))
+#else
+#define EL3_TRACE_EVENT(_id, _arg0, _arg1, _arg2)
+#endif /* EL3_TRACE */
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* EL3_TRACE_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, ARM Limited. All rights reserved.
+ * Copyright (c) 2019-2023, ARM Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,7 @@
 #ifndef FCONF_H
 #define FCONF_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -24,7 +25,22 @@
 	const struct fconf_populator (name##__populator) = {			\
 		.config_type = (#config),					\
 		.info = (#name),						\
-		.populate = (callback)						\
+		.populate = (callback),						\
+		.bin = false							\
+	};
+
+/*
+ * Same as FCONF_REGISTER_POPULATOR, for a callback which also accepts a
+ * pre-parsed binary configuration (see fconf_bin.h) and tells both formats
+ * apart with fconf_bin_check().
+ */
+#define FCONF_REGISTER_BIN_POPULATOR(config, name, callback)			\
+	__attribute__((used, section(".fconf_populator")))			\
+	const struct fconf_populator (name##__populator) = {			\
+		.config_type = (#config),					\
+		.info = (#name),						\
+		.populate = (callback),						\
+		.bin = true							\
 	};
 
 /*
@@ -42,6 +58,9 @@ struct fconf_populator {
 	 * Return 0 on success, err_code < 0 otherwise.
 	 */
 	int (*populate)(uintptr_t config);
+
+	/* The callback accepts a binary configuration as well as a dtb */
+	bool bin;
 };
 
 /* This function supports to load tb_fw_config and fw_config dtb */
@@ -50,7 +69,9 @@ int fconf_load_config(unsigned int image_id);
 /* Top level populate function
  *
  * This function takes a configuration dtb and calls all the registered
- * populator callback with it.
+ * populator callback with it. With FCONF_BIN_CONFIG, it also takes a binary
+ * configuration: the populators registered with FCONF_REGISTER_BIN_POPULATOR
+ * get the binary configuration, the others the dtb embedded in it.
  *
  *  Panic on error.
  */
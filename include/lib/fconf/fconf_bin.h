@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef FCONF_BIN_H
+#define FCONF_BIN_H
+
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+/*
+ * Pre-parsed binary configuration, generated at build time from a config DTB
+ * by tools/fconf_bin/fconf_bin.py. It starts with a struct fconf_bin_hdr,
+ * followed by 'num_sections' struct fconf_bin_section, followed by the
+ * sections. Each section is an array of 'count' entries of a fixed layout,
+ * aligned to 8 bytes, so that it can be used in place. All fields are little
+ * endian.
+ *
+ * The FCONF_BIN_SEC_DTB section, if present, holds the DTB the blob was
+ * generated from. It is passed to the populators that do not understand the
+ * binary format.
+ */
+#define FCONF_BIN_MAGIC			U(0x4E424346)	/* "FCBN" */
+#define FCONF_BIN_VERSION		U(1)
+#define FCONF_BIN_ALIGN			U(8)
+
+/* Section types */
+#define FCONF_BIN_SEC_DTB		U(0)
+#define FCONF_BIN_SEC_DTB_REGISTRY	U(1)
+
+struct fconf_bin_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t total_size;
+	uint32_t num_sections;
+};
+
+struct fconf_bin_section {
+	uint32_t type;
+	uint32_t offset;	/* From the start of the blob */
+	uint32_t size;		/* In bytes, including any padding */
+	uint32_t count;		/* Number of entries */
+};
+
+/* Entry of FCONF_BIN_SEC_DTB_REGISTRY, one per "dtb-registry" subnode */
+struct fconf_bin_dtb_entry {
+	uint64_t load_addr;
+	uint64_t ns_load_addr;	/* ~0 if absent */
+	uint32_t max_size;
+	uint32_t id;
+};
+
+int fconf_bin_check(uintptr_t config);
+const void *fconf_bin_get_section(uintptr_t config, uint32_t type,
+				  uint32_t entry_size, uint32_t *count);
+
+#endif /* FCONF_BIN_H */
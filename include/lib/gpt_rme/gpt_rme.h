@@ -212,7 +212,8 @@ int gpt_init_l0_tables(gpccr_pps_e pps,
  * Public API that carves out PAS regions from the L0 tables and builds any L1
  * tables that are needed.  This function ideally is run after DDR discovery and
  * initialization.  The L0 tables must have already been initialized to GPI_ANY
- * when this function is called.
+ * when this function is called.  The PAS regions array is sorted by base address
+ * in place.
  *
  * Parameters
  *   pgs		PGS value to use for table generation.
@@ -277,4 +278,31 @@ void gpt_disable(void);
 int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state);
 int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state);
 
+/*
+ * Public API to look up the GPI currently assigned to the granule containing
+ * a given physical address.
+ *
+ * Parameters
+ *   base: Physical address to look up.
+ *   gpi: Output, one of the GPT_GPI_x values.
+ *
+ * Return
+ *    Negative Linux error code in the event of a failure, 0 for success.
+ */
+int gpt_get_gpi(uint64_t base, unsigned int *gpi);
+
+/*
+ * Public API to keep a granule in the Non-secure PAS while EL3 accesses it.
+ * gpt_lock_ns_granule() fails if the granule is not Non-secure, otherwise it
+ * blocks all PAS transitions until gpt_unlock_ns_granule() is called.
+ *
+ * Parameters
+ *   base: Physical address in the granule.
+ *
+ * Return
+ *    Negative Linux error code in the event of a failure, 0 for success.
+ */
+int gpt_lock_ns_granule(uint64_t base);
+void gpt_unlock_ns_granule(void);
+
 #endif /* GPT_RME_H */
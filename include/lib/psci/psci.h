@@ -168,6 +168,7 @@
 
 #ifndef __ASSEMBLER__
 
+#include <stddef.h>
 #include <stdint.h>
 
 /* Function to help build the psci capabilities bitfield */
@@ -327,6 +328,28 @@ typedef struct plat_psci_ops {
 				int reset_type, u_register_t cookie);
 } plat_psci_ops_t;
 
+#if PSCI_STAT_EXPORT
+/*******************************************************************************
+ * Layout of the buffer filled by psci_stat_export(). The header is followed by
+ * the MPIDR of each CPU, then by 'num_states' psci_stat_export_entry_t for each
+ * CPU and finally by 'num_states' entries for each non-CPU power domain, in the
+ * order of the PSCI power domain tree.
+ ******************************************************************************/
+#define PSCI_STAT_EXPORT_VERSION	U(1)
+
+typedef struct psci_stat_export_hdr {
+	uint32_t version;
+	uint32_t num_cpus;
+	uint32_t num_non_cpu_pds;
+	uint32_t num_states;
+} psci_stat_export_hdr_t;
+
+typedef struct psci_stat_export_entry {
+	uint64_t residency;
+	uint64_t count;
+} psci_stat_export_entry_t;
+#endif /* PSCI_STAT_EXPORT */
+
 /*******************************************************************************
  * Function & Data prototypes
  ******************************************************************************/
@@ -349,6 +372,10 @@ int psci_node_hw_state(u_register_t target_cpu,
 int psci_features(unsigned int psci_fid);
 void __dead2 psci_power_down_wfi(void);
 void psci_arch_setup(void);
+#if PSCI_STAT_EXPORT
+size_t psci_stat_export_size(void);
+int psci_stat_export(void *buf, size_t size);
+#endif
 
 #endif /*__ASSEMBLER__*/
 
@@ -115,6 +115,16 @@
 #define XLAT_TABLE_IDX(virtual_addr, level)	\
 	(((virtual_addr) >> XLAT_ADDR_SHIFT(level)) & ULL(0x1FF))
 
+/*
+ * Number of adjacent block or page descriptors that share a TLB entry when they
+ * have the Contiguous bit set, and size of the memory they map. With the 4KB
+ * translation granule, this is 16 descriptors at every lookup level.
+ */
+#define XLAT_CONTIG_ENTRIES_SHIFT	U(4)
+#define XLAT_CONTIG_ENTRIES	(U(1) << XLAT_CONTIG_ENTRIES_SHIFT)
+#define XLAT_CONTIG_SIZE(level)	\
+	(ULL(1) << (XLAT_CONTIG_ENTRIES_SHIFT + XLAT_ADDR_SHIFT(level)))
+
 /*
  * The ARMv8 translation table descriptor format defines AP[2:1] as the Access
  * Permissions bits, and does not define an AP[0] bit.
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef XLAT_TABLES_PREBUILT_H
+#define XLAT_TABLES_PREBUILT_H
+
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+
+/*
+ * Translation tables generated at build time by tools/xlat_prebuilt for the
+ * static regions of BL31 that are known before linking, see
+ * XLAT_TABLES_PREBUILT.
+ *
+ * The platform marks the array of regions it passes to mmap_add() with
+ * XLAT_PREBUILT_MMAP, in the source file named by
+ * XLAT_TABLES_PREBUILT_MMAP_SOURCE. The build system extracts the array and
+ * the parameters of the translation context from the object files, the tool
+ * maps the regions with the xlat_tables_v2 library on the host and generates a
+ * struct xlat_prebuilt. init_xlat_tables() installs it instead of mapping
+ * these regions again, the other static regions and the dynamic regions are
+ * mapped on top as usual.
+ */
+#define XLAT_PREBUILT_MAGIC		U(0x54414C58)	/* "XLAT" */
+
+/* Flags of the translation context */
+#define XLAT_PREBUILT_FLAG_RME		U(1)
+
+#if ENABLE_RME
+#define XLAT_PREBUILT_FLAGS		XLAT_PREBUILT_FLAG_RME
+#else
+#define XLAT_PREBUILT_FLAGS		U(0)
+#endif
+
+#if XLAT_TABLES_PREBUILT && defined(IMAGE_BL31)
+#define XLAT_PREBUILT_MMAP	__section(".rodata.xlat_prebuilt_mmap")
+#else
+#define XLAT_PREBUILT_MMAP
+#endif
+
+/*
+ * Parameters of the translation context, read by the tool. Regions that
+ * overlap the image are left to be mapped at run time, as the regions of the
+ * image itself may be nested in them.
+ *
+ * The tool reads the regions as an array of mmap_region_t, so the host must
+ * have the byte order and the mmap_region_t layout of the target. The magic
+ * number is read byte-swapped on a big-endian host, and mmap_region_size holds
+ * sizeof(mmap_region_t) on the target.
+ */
+struct xlat_prebuilt_params {
+	uint32_t magic;
+	uint32_t flags;
+	uint64_t va_space_size;
+	uint64_t pa_space_size;
+	uint64_t image_base;
+	uint64_t image_limit;
+	uint32_t max_regions;
+	uint32_t max_tables;
+	uint32_t mmap_region_size;
+	uint32_t reserved;
+};
+
+/* Value of struct xlat_prebuilt_entry.table for the base table */
+#define XLAT_PREBUILT_BASE_TABLE	U(0xFFFF)
+
+/*
+ * Non-zero descriptor of the generated tables. Table descriptors only hold
+ * TABLE_DESC, the address of the subtable is added when installing them so
+ * that the generated tables don't depend on where BL31 is linked.
+ */
+struct xlat_prebuilt_entry {
+	uint16_t table;		/* Subtable index, or XLAT_PREBUILT_BASE_TABLE */
+	uint16_t idx;		/* Index of the descriptor in the table */
+	uint32_t subtable;	/* Subtable index of a table descriptor */
+	uint64_t desc;
+};
+
+/* Output of the tool */
+struct xlat_prebuilt {
+	uint64_t va_space_size;
+	uint64_t pa_space_size;
+	uint32_t flags;
+	unsigned int num_regions;
+	const mmap_region_t *mmap;
+	unsigned int num_entries;
+	const struct xlat_prebuilt_entry *entries;
+	/* Number of subtables used, and regions mapped in each of them */
+	unsigned int num_tables;
+	const int *mapped_regions;
+};
+
+extern const struct xlat_prebuilt xlat_tables_prebuilt;
+
+void init_xlat_tables_prebuilt_ctx(xlat_ctx_t *ctx,
+				   const struct xlat_prebuilt *prebuilt);
+
+#endif /* XLAT_TABLES_PREBUILT_H */
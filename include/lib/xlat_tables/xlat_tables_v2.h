@@ -76,6 +76,9 @@
 #define MT_SHAREABILITY_MASK	(U(3) << MT_SHAREABILITY_SHIFT)
 #define MT_SHAREABILITY(_attr)	((_attr) & MT_SHAREABILITY_MASK)
 
+/* Use of the Contiguous bit in the descriptors of the region */
+#define MT_CONTIGUOUS_SHIFT	U(10)
+
 /* All other bits are reserved */
 
 /*
@@ -130,6 +133,16 @@
 #define MT_SHAREABILITY_OSH	(U(2) << MT_SHAREABILITY_SHIFT)
 #define MT_SHAREABILITY_NSH	(U(3) << MT_SHAREABILITY_SHIFT)
 
+/*
+ * Allow the library to set the Contiguous bit in groups of XLAT_CONTIG_ENTRIES
+ * adjacent block or page descriptors of the region, so that each group only
+ * needs one TLB entry. A group must be entirely covered by the region, aligned
+ * to its size in both VA and PA, and not shared with any other region.
+ * Changing the attributes of a page of a group with
+ * xlat_change_mem_attributes() clears the Contiguous bit of the whole group.
+ */
+#define MT_CONTIGUOUS		(U(1) << MT_CONTIGUOUS_SHIFT)
+
 /* Compound attributes for most common usages */
 #define MT_CODE			(MT_MEMORY | MT_RO | MT_EXECUTE)
 #define MT_RO_DATA		(MT_MEMORY | MT_RO | MT_EXECUTE_NEVER)
@@ -296,6 +309,10 @@ void mmap_add_alloc_va(mmap_region_t *mm);
  * Add a dynamic region with defined base PA and base VA. This type of region
  * can be added and removed even after the translation tables are initialized.
  *
+ * In BL31 and BL32, the functions that act on the default translation context
+ * take a lock once the MMU is enabled, so they can be called from any CPU. The
+ * *_ctx() functions are not serialised.
+ *
  * Returns:
  *        0: Success.
  *   EINVAL: Invalid values were used as arguments.
@@ -337,6 +354,31 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx,
 				uintptr_t base_va,
 				size_t size);
 
+/*
+ * Add an array of 'count' dynamic regions with defined base PA and base VA.
+ * The memory barrier needed after updating the translation tables is only
+ * issued once for all the regions. Either all or none of the regions are
+ * added: if one of them can't be added, the ones before it are removed again.
+ *
+ * It returns the same error values as mmap_add_dynamic_region().
+ */
+int mmap_add_dynamic_regions(mmap_region_t *mm, unsigned int count);
+int mmap_add_dynamic_regions_ctx(xlat_ctx_t *ctx, mmap_region_t *mm,
+				 unsigned int count);
+
+/*
+ * Remove an array of 'count' dynamic regions, identified by the base VA and
+ * size of each entry. The TLB maintenance is only waited for once for all the
+ * regions. All the regions are checked before removing any of them, so either
+ * all or none are removed.
+ *
+ * It returns the same error values as mmap_remove_dynamic_region(), and
+ * EINVAL if a region appears more than once in the array.
+ */
+int mmap_remove_dynamic_regions(const mmap_region_t *mm, unsigned int count);
+int mmap_remove_dynamic_regions_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm,
+				    unsigned int count);
+
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 /*
@@ -378,6 +420,12 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx,
  * NOTE2: The caller is responsible for making sure that the targeted
  * translation tables are not modified by any other code while this function is
  * executing.
+ *
+ * NOTE3: If a page to change belongs to a group of XLAT_CONTIG_ENTRIES (16) pages
+ * mapped with MT_CONTIGUOUS, all the pages of the group are briefly made
+ * invalid while its Contiguous bit is cleared. None of them may be accessed by
+ * the caller in the meantime, i.e. they must not hold its code, stack or the
+ * translation tables, or be used by other CPUs.
  */
 int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size, uint32_t attr);
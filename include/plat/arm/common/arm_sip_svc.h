@@ -25,6 +25,11 @@
 /* DEBUGFS_SMC_32			0x82000030U */
 /* DEBUGFS_SMC_64			0xC2000030U */
 
+/* Function ID for exporting the PSCI stats of all power domains at once */
+#define ARM_SIP_SVC_PSCI_STAT_EXPORT	U(0xC2000040)
+
+/* EL3_TRACE_SMC_64			0xC2000060U */
+
 /*
  * Arm(R) Ethos(TM)-N NPU SiP SMC function IDs
  * 0xC2000050-0xC200005F
@@ -48,12 +48,14 @@
 #define ARM_SPM_BUF_EL3_MMAP		MAP_REGION_FLAT(			\
 						PLAT_SPM_BUF_BASE,		\
 						PLAT_SPM_BUF_SIZE,		\
-						MT_RW_DATA | MT_SECURE)
+						MT_RW_DATA | MT_SECURE |	\
+						MT_CONTIGUOUS)
 #define ARM_SPM_BUF_EL0_MMAP		MAP_REGION2(			\
 						PLAT_SPM_BUF_BASE,		\
 						PLAT_SPM_BUF_BASE,		\
 						PLAT_SPM_BUF_SIZE,		\
-						MT_RO_DATA | MT_SECURE | MT_USER,\
+						MT_RO_DATA | MT_SECURE | MT_USER |\
+						MT_CONTIGUOUS,			\
 						PAGE_SIZE)
 
 /*
@@ -67,7 +69,8 @@
 						PLAT_SP_IMAGE_NS_BUF_BASE,	\
 						PLAT_SP_IMAGE_NS_BUF_BASE,	\
 						PLAT_SP_IMAGE_NS_BUF_SIZE,	\
-						MT_RW_DATA | MT_NS | MT_USER,	\
+						MT_RW_DATA | MT_NS | MT_USER |	\
+						MT_CONTIGUOUS,			\
 						PAGE_SIZE)
 
 /*
@@ -90,7 +93,8 @@
 						PLAT_SP_IMAGE_STACK_BASE,	\
 						(ARM_SP_IMAGE_LIMIT -		\
 						 PLAT_SP_IMAGE_STACK_BASE),	\
-						MT_RW_DATA | MT_SECURE | MT_USER,\
+						MT_RW_DATA | MT_SECURE | MT_USER |\
+						MT_CONTIGUOUS,			\
 						PAGE_SIZE)
 
 /* Total number of memory regions with distinct properties */
@@ -172,6 +172,12 @@ int plat_sdei_validate_entry_point(uintptr_t ep, unsigned int client_mode);
 void plat_sdei_handle_masked_trigger(uint64_t mpidr, unsigned int intr);
 #endif
 
+/*
+ * Check a buffer passed by the Normal world to the debugfs interface, the EL3
+ * trace or the PSCI stats export call. Mandatory when one of them is enabled.
+ */
+int plat_validate_ns_region(uintptr_t base, size_t size);
+
 void plat_default_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags);
 void plat_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
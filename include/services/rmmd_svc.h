@@ -40,6 +40,49 @@
 					/* 0x18F */
 #define RMM_RMI_REQ_COMPLETE		SMC64_RMI_FID(U(0x3F))
 
+/*
+ * RMMD_RMI_BATCH is an implementation defined function, handled by the RMMD
+ * when RMMD_RMI_BATCH_SUPPORT is enabled. As the RMI range is reserved for the
+ * functions of the RMM specification, it is allocated in the Vendor Specific
+ * EL3 Monitor range (0xC700 0000 - 0xC700 FFFF) instead. It lets the
+ * Normal world queue several RMI requests in a page of Non-secure memory and
+ * have them all forwarded to the RMM with a single Normal world exit, so that
+ * the Normal world and Realm system register contexts are only switched once
+ * per batch instead of once per request.
+ *
+ * The arguments to this SMC are :
+ *    arg0 - Function ID.
+ *    arg1 - Physical address of a 4KB aligned rmi_batch_page_t in the
+ *           Non-secure PAS.
+ * The return arguments are :
+ *    ret0 - Status / error (E_RMM_x).
+ *    ret1 - Number of entries that were forwarded to the RMM. Their results
+ *           are written back to the page, except those of the last one if
+ *           ret0 is E_RMM_BAD_PAS because the page left the Non-secure PAS
+ *           while the batch was processed.
+ *
+ * The RMMD copies each request from the page just before forwarding it, and
+ * writes its results back just after. The Normal world must not update the
+ * page until the SMC returns.
+ */
+#define RMMD_RMI_BATCH			((SMC_TYPE_FAST << FUNCID_TYPE_SHIFT) | \
+					 (SMC_64 << FUNCID_CC_SHIFT)	      | \
+					 (OEN_VEN_EL3_START << FUNCID_OEN_SHIFT))
+
+/* Number of arguments (x1 - x7) passed to the RMM for each batch entry */
+#define RMI_BATCH_NUM_ARGS		U(7)
+
+/* Number of results (x1 - x5 of RMM_RMI_REQ_COMPLETE) of each batch entry */
+#define RMI_BATCH_NUM_RETS		U(5)
+
+/* Size of a batch page, of a batch entry and of the batch page header */
+#define RMI_BATCH_PAGE_SIZE		U(0x1000)
+#define RMI_BATCH_ENTRY_SIZE		U(128)
+
+/* Maximum number of entries in a batch page */
+#define RMI_BATCH_MAX_ENTRIES		((RMI_BATCH_PAGE_SIZE /		\
+					  RMI_BATCH_ENTRY_SIZE) - 1U)
+
 /* RMM_BOOT_COMPLETE arg0 error codes */
 #define E_RMM_BOOT_SUCCESS				(0)
 #define E_RMM_BOOT_UNKNOWN				(-1)
@@ -165,6 +208,21 @@
 #ifndef __ASSEMBLER__
 #include <stdint.h>
 
+/* RMI request queued in an RMMD_RMI_BATCH page */
+typedef struct rmi_batch_entry {
+	uint64_t fid;
+	uint64_t args[RMI_BATCH_NUM_ARGS];
+	uint64_t ret[RMI_BATCH_NUM_RETS];
+	uint64_t reserved[3];
+} rmi_batch_entry_t;
+
+/* Layout of the Non-secure page passed to RMMD_RMI_BATCH */
+typedef struct rmi_batch_page {
+	uint64_t count;
+	uint64_t reserved[15];
+	rmi_batch_entry_t entries[RMI_BATCH_MAX_ENTRIES];
+} rmi_batch_page_t;
+
 int rmmd_setup(void);
 uint64_t rmmd_rmi_handler(uint32_t smc_fid,
 		uint64_t x1,
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2023, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef FILE_STREAM_H
+#define FILE_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Maximum size of the chunks passed to the consumers */
+#define FILE_STREAM_CHUNK_SIZE		(1024 * 1024)
+
+/*
+ * Consumer of the content of a file. It is called on consecutive chunks of the
+ * file, and returns 0 on success. Any other value stops the stream.
+ */
+typedef int (*file_stream_fn_t)(void *ctx, const unsigned char *data,
+				size_t len);
+
+typedef struct file_stream_consumer {
+	file_stream_fn_t fn;
+	void *ctx;
+} file_stream_consumer_t;
+
+/* Statistics of a call to file_stream_read() */
+typedef struct file_stream_stats {
+	uint64_t bytes;
+	uint64_t nsecs;
+} file_stream_stats_t;
+
+/* Exported API */
+int file_stream_read(const char *filename,
+		     const file_stream_consumer_t *consumers,
+		     unsigned int num_consumers, file_stream_stats_t *stats);
+void file_stream_print_stats(const char *name,
+			     const file_stream_stats_t *stats);
+
+#endif /* FILE_STREAM_H */
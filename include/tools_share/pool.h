@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2023, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+/*
+ * Task run by the worker pool. 'idx' identifies the task among the ones
+ * passed to pool_run() and 'arg' is passed through unchanged.
+ */
+typedef void (*pool_task_fn_t)(unsigned int idx, void *arg);
+
+/* Exported API */
+unsigned int pool_default_jobs(void);
+void pool_run(unsigned int jobs, unsigned int num, const int *deps,
+	      pool_task_fn_t task, void *arg);
+
+#endif /* POOL_H */
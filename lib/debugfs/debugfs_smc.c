@@ -1,9 +1,10 @@
 /*
- * Copyright (c) 2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2019-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <limits.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
@@ -11,7 +12,9 @@
 #include <lib/debugfs.h>
 #include <lib/smccc.h>
 #include <lib/spinlock.h>
+#include <lib/utils_def.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
+#include <plat/common/platform.h>
 #include <smccc_helpers.h>
 
 #define MAX_PATH_LEN	256
@@ -27,9 +30,9 @@
 #define STAT		8
 #define INIT		10
 #define VERSION		11
-
-/* This is the virtual address to which we map the NS shared buffer */
-#define DEBUGFS_SHARED_BUF_VIRT		((void *)0x81000000U)
+#define INIT_BULK	12
+#define READ_BULK	13
+#define READ_SG		14
 
 static union debugfs_parms {
 	struct {
@@ -53,12 +56,153 @@ static union debugfs_parms {
 	} bind;
 } parms;
 
+/* Virtual address and size of the mapped NS shared buffer */
+static void *debugfs_shared_buf;
+static size_t debugfs_shared_buf_size;
+
 /* debugfs_access_lock protects shared buffer and internal */
 /* FS functions from concurrent acccesses.                 */
 static spinlock_t debugfs_access_lock;
 
 static bool debugfs_initialized;
 
+/*******************************************************************************
+ * Map 'size' bytes of NS memory at 'pa' as the shared buffer, replacing the
+ * previous buffer if any. The previous buffer is only unmapped once the new
+ * one is mapped, so a failure leaves the interface usable.
+ ******************************************************************************/
+static int debugfs_map_shared_buf(unsigned long long pa, size_t size)
+{
+	uintptr_t va;
+
+	if (((pa & PAGE_SIZE_MASK) != 0U) || ((size & PAGE_SIZE_MASK) != 0U) ||
+	    (size < sizeof(union debugfs_parms)) ||
+	    (size > DEBUGFS_SHARED_BUF_MAX)) {
+		return -1;
+	}
+
+	if (plat_validate_ns_region((uintptr_t)pa, size) != 0) {
+		return -1;
+	}
+
+	if (mmap_add_dynamic_region_alloc_va(pa, &va, size, MT_MEMORY |
+					     MT_RW | MT_NS | MT_CONTIGUOUS) != 0) {
+		return -1;
+	}
+
+	if (debugfs_shared_buf != NULL) {
+		if (mmap_remove_dynamic_region((uintptr_t)debugfs_shared_buf,
+					       debugfs_shared_buf_size) != 0) {
+			(void)mmap_remove_dynamic_region(va, size);
+			return -1;
+		}
+	}
+
+	debugfs_shared_buf = (void *)va;
+	debugfs_shared_buf_size = size;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Read up to 'len' bytes of 'fd' to offset 'off' of the shared buffer. Unlike
+ * read(), which drivers may cut short e.g. at the end of a device chunk, this
+ * keeps reading until 'len' bytes are transferred or the end of file is
+ * reached. It returns the number of bytes read, or -1 on error.
+ ******************************************************************************/
+static long debugfs_read_bulk(int fd, size_t off, size_t len)
+{
+	uint8_t *buf;
+	size_t done = 0U;
+	int n;
+
+	if ((off > debugfs_shared_buf_size) ||
+	    (len > (debugfs_shared_buf_size - off))) {
+		return -1;
+	}
+
+	buf = (uint8_t *)debugfs_shared_buf + off;
+
+	while (done < len) {
+		n = read(fd, buf + done, (int)MIN(len - done, (size_t)INT_MAX));
+		if (n < 0) {
+			return (done != 0U) ? (long)done : -1;
+		}
+		if (n == 0) {
+			break;
+		}
+		done += (size_t)n;
+	}
+
+	return (long)done;
+}
+
+/*******************************************************************************
+ * Copy segment 'i' of the segment table, of 'table_size' bytes, at the start of
+ * the shared buffer. The data of a segment must not overlap the table.
+ ******************************************************************************/
+static int debugfs_get_sg(unsigned int i, size_t table_size, debugfs_sg_t *seg)
+{
+	if (table_size > debugfs_shared_buf_size) {
+		return -1;
+	}
+
+	memcpy(seg, (debugfs_sg_t *)debugfs_shared_buf + i, sizeof(*seg));
+
+	return (seg->offset < table_size) ? -1 : 0;
+}
+
+/*******************************************************************************
+ * Perform the 'nseg' reads described by the segment table at the start of the
+ * shared buffer, in which the number of bytes read is written back to 'len'.
+ * It returns the total number of bytes read, or -1 on error.
+ *
+ * Called with debugfs_access_lock held. The lock is released between segments
+ * so that the other CPUs are not held up for the whole transfer. Each segment
+ * is copied and checked again before it is read, as the shared buffer may have
+ * been changed or replaced in the meantime.
+ ******************************************************************************/
+static long debugfs_read_sg(u_register_t nseg)
+{
+	debugfs_sg_t seg;
+	size_t table_size;
+	size_t total = 0U;
+	unsigned int i;
+	long n;
+
+	if ((nseg == 0U) || (nseg > DEBUGFS_SG_MAX)) {
+		return -1;
+	}
+
+	table_size = nseg * sizeof(debugfs_sg_t);
+
+	for (i = 0U; i < nseg; i++) {
+		if (debugfs_get_sg(i, table_size, &seg) != 0) {
+			return -1;
+		}
+	}
+
+	for (i = 0U; i < nseg; i++) {
+		if (i != 0U) {
+			spin_unlock(&debugfs_access_lock);
+			spin_lock(&debugfs_access_lock);
+		}
+
+		if (debugfs_get_sg(i, table_size, &seg) != 0) {
+			return -1;
+		}
+
+		n = debugfs_read_bulk(seg.fd, seg.offset, seg.len);
+		if (n < 0) {
+			return -1;
+		}
+		((debugfs_sg_t *)debugfs_shared_buf)[i].len = (uint64_t)n;
+		total += (size_t)n;
+	}
+
+	return (long)total;
+}
+
 uintptr_t debugfs_smc_handler(unsigned int smc_fid,
 			      u_register_t cmd,
 			      u_register_t arg2,
@@ -69,6 +213,7 @@ uintptr_t debugfs_smc_handler(unsigned int smc_fid,
 			      u_register_t flags)
 {
 	int64_t smc_ret = DEBUGFS_E_INVALID_PARAMS, smc_resp = 0;
+	long len;
 	int ret;
 
 	/* Allow calls from non-secure only */
@@ -93,19 +238,13 @@ uintptr_t debugfs_smc_handler(unsigned int smc_fid,
 
 	if (debugfs_initialized == true) {
 		/* Copy NS shared buffer to internal secure location */
-		memcpy(&parms, (void *)DEBUGFS_SHARED_BUF_VIRT,
-		       sizeof(union debugfs_parms));
+		memcpy(&parms, debugfs_shared_buf, sizeof(union debugfs_parms));
 	}
 
 	switch (cmd) {
 	case INIT:
 		if (debugfs_initialized == false) {
-			/* TODO: check PA validity e.g. whether */
-			/* it is an NS region.                  */
-			ret = mmap_add_dynamic_region(arg2,
-				(uintptr_t)DEBUGFS_SHARED_BUF_VIRT,
-				PAGE_SIZE_4KB,
-				MT_MEMORY | MT_RW | MT_NS);
+			ret = debugfs_map_shared_buf(arg2, PAGE_SIZE_4KB);
 			if (ret == 0) {
 				debugfs_initialized = true;
 				smc_ret = SMC_OK;
@@ -114,6 +253,15 @@ uintptr_t debugfs_smc_handler(unsigned int smc_fid,
 		}
 		break;
 
+	case INIT_BULK:
+		ret = debugfs_map_shared_buf(arg2, arg3);
+		if (ret == 0) {
+			debugfs_initialized = true;
+			smc_ret = SMC_OK;
+			smc_resp = arg3;
+		}
+		break;
+
 	case VERSION:
 		smc_ret = SMC_OK;
 		smc_resp = DEBUGFS_VERSION;
@@ -146,13 +294,39 @@ uintptr_t debugfs_smc_handler(unsigned int smc_fid,
 		break;
 
 	case READ:
-		ret = read(arg2, DEBUGFS_SHARED_BUF_VIRT, arg3);
+		if ((debugfs_initialized == false) ||
+		    (arg3 > debugfs_shared_buf_size)) {
+			break;
+		}
+		ret = read(arg2, debugfs_shared_buf, arg3);
 		if (ret >= 0) {
 			smc_ret = SMC_OK;
 			smc_resp = ret;
 		}
 		break;
 
+	case READ_BULK:
+		if (debugfs_initialized == false) {
+			break;
+		}
+		len = debugfs_read_bulk(arg2, arg3, arg4);
+		if (len >= 0) {
+			smc_ret = SMC_OK;
+			smc_resp = len;
+		}
+		break;
+
+	case READ_SG:
+		if (debugfs_initialized == false) {
+			break;
+		}
+		len = debugfs_read_sg(arg2);
+		if (len >= 0) {
+			smc_ret = SMC_OK;
+			smc_resp = len;
+		}
+		break;
+
 	case SEEK:
 		ret = seek(arg2, arg3, arg4);
 		if (ret == 0) {
@@ -172,7 +346,7 @@ uintptr_t debugfs_smc_handler(unsigned int smc_fid,
 	case STAT:
 		ret = stat(parms.stat.path, &parms.stat.dir);
 		if (ret == 0) {
-			memcpy((void *)DEBUGFS_SHARED_BUF_VIRT, &parms,
+			memcpy(debugfs_shared_buf, &parms,
 			       sizeof(union debugfs_parms));
 			smc_ret = SMC_OK;
 			smc_resp = 0;
@@ -203,6 +377,8 @@ uintptr_t debugfs_smc_handler(unsigned int smc_fid,
 int debugfs_smc_setup(void)
 {
 	debugfs_initialized = false;
+	debugfs_shared_buf = NULL;
+	debugfs_shared_buf_size = 0U;
 	debugfs_access_lock.lock = 0;
 
 	return 0;
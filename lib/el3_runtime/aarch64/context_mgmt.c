@@ -31,6 +31,7 @@
 #include <lib/extensions/trbe.h>
 #include <lib/extensions/trf.h>
 #include <lib/utils.h>
+#include <plat/common/platform.h>
 
 #if ENABLE_FEAT_TWED
 /* Make sure delay value fits within the range(0-15) */
@@ -449,6 +450,11 @@ void cm_setup_context(cpu_context_t *ctx, const entry_point_info_t *ep)
 		panic();
 		break;
 	}
+
+#if CTX_LAZY_EL2_REGS
+	/* The saved EL2 context no longer matches any live registers */
+	cm_el2_sysregs_context_invalidate();
+#endif
 }
 
 /*******************************************************************************
@@ -578,6 +584,11 @@ void cm_prepare_el3_exit(uint32_t security_state)
 
 	assert(ctx != NULL);
 
+#if CTX_LAZY_EL2_REGS
+	/* EL2 registers may be written directly below */
+	cm_el2_sysregs_context_invalidate();
+#endif
+
 	if (security_state == NON_SECURE) {
 		scr_el3 = read_ctx_reg(get_el3state_ctx(ctx),
 						 CTX_SCR_EL3);
@@ -785,6 +796,162 @@ void cm_prepare_el3_exit(uint32_t security_state)
 	cm_set_next_eret_context(security_state);
 }
 
+#if CTX_LAZY_EL2_REGS
+/*******************************************************************************
+ * Lazy EL2 sysreg context switch.
+ *
+ * Each EL2 register group is described by its save/restore helpers and by the
+ * SCR_EL3 bit which grants a lower EL access to it (0 if the group is always
+ * accessible). For every CPU the security state whose saved copy currently
+ * matches the live registers of a group is tracked, so that:
+ *  - a restore is skipped when the group already holds the values of the
+ *    target security state (e.g. the same world is re-entered),
+ *  - a save is skipped when the group holds the values of the security state
+ *    being saved and that state cannot modify the group.
+ * Any direct EL2 register update from EL3 must call
+ * cm_el2_sysregs_context_invalidate() to drop this knowledge.
+ ******************************************************************************/
+typedef struct el2_sysregs_grp {
+	void (*save)(el2_sysregs_t *regs);
+	void (*restore)(el2_sysregs_t *regs);
+	u_register_t scr_en_bit;
+} el2_sysregs_grp_t;
+
+static const el2_sysregs_grp_t el2_sysregs_grps[CM_EL2_GRP_MAX] = {
+	[CM_EL2_GRP_COMMON] = { el2_sysregs_context_save_common,
+				el2_sysregs_context_restore_common, 0U },
+#if ENABLE_SPE_FOR_LOWER_ELS
+	[CM_EL2_GRP_SPE] = { el2_sysregs_context_save_spe,
+			     el2_sysregs_context_restore_spe, 0U },
+#endif
+#if CTX_INCLUDE_MTE_REGS
+	[CM_EL2_GRP_MTE] = { el2_sysregs_context_save_mte,
+			     el2_sysregs_context_restore_mte, SCR_ATA_BIT },
+#endif
+#if ENABLE_MPAM_FOR_LOWER_ELS
+	[CM_EL2_GRP_MPAM] = { el2_sysregs_context_save_mpam,
+			      el2_sysregs_context_restore_mpam, 0U },
+#endif
+#if ENABLE_FEAT_FGT
+	[CM_EL2_GRP_FGT] = { el2_sysregs_context_save_fgt,
+			     el2_sysregs_context_restore_fgt, SCR_FGTEN_BIT },
+#endif
+#if ENABLE_FEAT_ECV
+	[CM_EL2_GRP_ECV] = { el2_sysregs_context_save_ecv,
+			     el2_sysregs_context_restore_ecv, SCR_ECVEN_BIT },
+#endif
+#if ENABLE_FEAT_VHE
+	[CM_EL2_GRP_VHE] = { el2_sysregs_context_save_vhe,
+			     el2_sysregs_context_restore_vhe, 0U },
+#endif
+#if RAS_EXTENSION
+	[CM_EL2_GRP_RAS] = { el2_sysregs_context_save_ras,
+			     el2_sysregs_context_restore_ras, 0U },
+#endif
+#if CTX_INCLUDE_NEVE_REGS
+	[CM_EL2_GRP_NV2] = { el2_sysregs_context_save_nv2,
+			     el2_sysregs_context_restore_nv2, 0U },
+#endif
+#if ENABLE_TRF_FOR_NS
+	[CM_EL2_GRP_TRF] = { el2_sysregs_context_save_trf,
+			     el2_sysregs_context_restore_trf, 0U },
+#endif
+#if ENABLE_FEAT_CSV2_2
+	[CM_EL2_GRP_CSV2] = { el2_sysregs_context_save_csv2,
+			      el2_sysregs_context_restore_csv2, 0U },
+#endif
+#if ENABLE_FEAT_HCX
+	[CM_EL2_GRP_HCX] = { el2_sysregs_context_save_hcx,
+			     el2_sysregs_context_restore_hcx, SCR_HXEn_BIT },
+#endif
+};
+
+/* Live owner encoding: security state + 1, 0 when unknown */
+#define EL2_GRP_OWNER_NONE	U(0)
+#define EL2_GRP_OWNER(_ss)	((uint8_t)((_ss) + 1U))
+
+static uint8_t el2_grp_owner[PLATFORM_CORE_COUNT][CM_EL2_GRP_MAX];
+static cm_el2_sysregs_stats_t el2_sysregs_stats[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * Forget which security state owns the live EL2 registers of this CPU. Must be
+ * called whenever EL2 registers are written directly or lost (power down).
+ ******************************************************************************/
+void cm_el2_sysregs_context_invalidate(void)
+{
+	zeromem(el2_grp_owner[plat_my_core_pos()],
+		sizeof(el2_grp_owner[0]));
+}
+
+/*******************************************************************************
+ * Return the lazy EL2 save/restore counters of a CPU for profiling.
+ ******************************************************************************/
+const cm_el2_sysregs_stats_t *cm_el2_sysregs_get_stats(unsigned int cpu_idx)
+{
+	assert(cpu_idx < PLATFORM_CORE_COUNT);
+
+	return &el2_sysregs_stats[cpu_idx];
+}
+
+static void el2_sysregs_context_save_lazy(uint32_t security_state,
+					  cpu_context_t *ctx)
+{
+	unsigned int cpu_idx = plat_my_core_pos();
+	uint8_t *owner = el2_grp_owner[cpu_idx];
+	cm_el2_sysregs_stats_t *stats = &el2_sysregs_stats[cpu_idx];
+	el2_sysregs_t *el2_sysregs_ctx = get_el2_sysregs_ctx(ctx);
+	u_register_t scr_el3 = read_ctx_reg(get_el3state_ctx(ctx),
+					    CTX_SCR_EL3);
+	unsigned int i;
+
+	for (i = 0U; i < CM_EL2_GRP_MAX; i++) {
+		const el2_sysregs_grp_t *grp = &el2_sysregs_grps[i];
+
+		if (grp->save == NULL) {
+			continue;
+		}
+
+		if ((owner[i] == EL2_GRP_OWNER(security_state)) &&
+		    (grp->scr_en_bit != 0U) &&
+		    ((scr_el3 & grp->scr_en_bit) == 0U)) {
+			stats->save_skipped[i]++;
+			continue;
+		}
+
+		grp->save(el2_sysregs_ctx);
+		owner[i] = EL2_GRP_OWNER(security_state);
+		stats->saved[i]++;
+	}
+}
+
+static void el2_sysregs_context_restore_lazy(uint32_t security_state,
+					     cpu_context_t *ctx)
+{
+	unsigned int cpu_idx = plat_my_core_pos();
+	uint8_t *owner = el2_grp_owner[cpu_idx];
+	cm_el2_sysregs_stats_t *stats = &el2_sysregs_stats[cpu_idx];
+	el2_sysregs_t *el2_sysregs_ctx = get_el2_sysregs_ctx(ctx);
+	unsigned int i;
+
+	for (i = 0U; i < CM_EL2_GRP_MAX; i++) {
+		const el2_sysregs_grp_t *grp = &el2_sysregs_grps[i];
+
+		if (grp->restore == NULL) {
+			continue;
+		}
+
+		if (owner[i] == EL2_GRP_OWNER(security_state)) {
+			stats->restore_skipped[i]++;
+			continue;
+		}
+
+		grp->restore(el2_sysregs_ctx);
+		owner[i] = EL2_GRP_OWNER(security_state);
+		stats->restored[i]++;
+	}
+}
+#endif /* CTX_LAZY_EL2_REGS */
+
 #if CTX_INCLUDE_EL2_REGS
 /*******************************************************************************
  * Save EL2 sysreg context
@@ -800,12 +967,14 @@ void cm_el2_sysregs_context_save(uint32_t security_state)
 	if ((security_state != SECURE) ||
 	    ((security_state == SECURE) && ((scr_el3 & SCR_EEL2_BIT) != 0U))) {
 		cpu_context_t *ctx;
-		el2_sysregs_t *el2_sysregs_ctx;
 
 		ctx = cm_get_context(security_state);
 		assert(ctx != NULL);
 
-		el2_sysregs_ctx = get_el2_sysregs_ctx(ctx);
+#if CTX_LAZY_EL2_REGS
+		el2_sysregs_context_save_lazy(security_state, ctx);
+#else
+		el2_sysregs_t *el2_sysregs_ctx = get_el2_sysregs_ctx(ctx);
 
 		el2_sysregs_context_save_common(el2_sysregs_ctx);
 #if ENABLE_SPE_FOR_LOWER_ELS
@@ -841,6 +1010,7 @@ void cm_el2_sysregs_context_save(uint32_t security_state)
 #if ENABLE_FEAT_HCX
 		el2_sysregs_context_save_hcx(el2_sysregs_ctx);
 #endif
+#endif /* CTX_LAZY_EL2_REGS */
 	}
 }
 
@@ -858,12 +1028,14 @@ void cm_el2_sysregs_context_restore(uint32_t security_state)
 	if ((security_state != SECURE) ||
 	    ((security_state == SECURE) && ((scr_el3 & SCR_EEL2_BIT) != 0U))) {
 		cpu_context_t *ctx;
-		el2_sysregs_t *el2_sysregs_ctx;
 
 		ctx = cm_get_context(security_state);
 		assert(ctx != NULL);
 
-		el2_sysregs_ctx = get_el2_sysregs_ctx(ctx);
+#if CTX_LAZY_EL2_REGS
+		el2_sysregs_context_restore_lazy(security_state, ctx);
+#else
+		el2_sysregs_t *el2_sysregs_ctx = get_el2_sysregs_ctx(ctx);
 
 		el2_sysregs_context_restore_common(el2_sysregs_ctx);
 #if ENABLE_SPE_FOR_LOWER_ELS
@@ -899,6 +1071,7 @@ void cm_el2_sysregs_context_restore(uint32_t security_state)
 #if ENABLE_FEAT_HCX
 		el2_sysregs_context_restore_hcx(el2_sysregs_ctx);
 #endif
+#endif /* CTX_LAZY_EL2_REGS */
 	}
 }
 #endif /* CTX_INCLUDE_EL2_REGS */
@@ -930,6 +1103,10 @@ void cm_prepare_el3_exit_ns(void)
 	 */
 	manage_extensions_nonsecure(0, ctx);
 
+#if CTX_LAZY_EL2_REGS
+	cm_el2_sysregs_context_invalidate();
+#endif
+
 	/*
 	 * Set the NS bit to be able to access the ICC_SRE_EL2
 	 * register when restoring context.
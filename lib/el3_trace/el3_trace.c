@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2023, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <lib/el3_trace/el3_trace.h>
+#include <lib/smccc.h>
+#include <lib/spinlock.h>
+#include <lib/utils_def.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+#include <plat/common/platform.h>
+#include <smccc_helpers.h>
+
+/* Rings of each CPU in the shared buffer, set up by EL3_TRACE_CMD_INIT */
+static el3_trace_cpu_t *el3_trace_cpu[PLATFORM_CORE_COUNT];
+static el3_trace_entry_t *el3_trace_ring[PLATFORM_CORE_COUNT];
+static uint64_t el3_trace_mask;
+
+static bool el3_trace_initialized;
+static volatile bool el3_trace_enabled;
+
+/* Serialises the SMC commands */
+static spinlock_t el3_trace_lock;
+
+/*******************************************************************************
+ * Record an event in the ring of the calling CPU. EL3 runs with interrupts
+ * masked and only the owning CPU writes to a ring, so no lock is needed. The
+ * entry is written before 'head' is published.
+ ******************************************************************************/
+void el3_trace_event(uint32_t id, uint32_t arg0, uint64_t arg1, uint64_t arg2)
+{
+	unsigned int cpu;
+	el3_trace_entry_t *entry;
+	uint64_t head;
+
+	if (!el3_trace_enabled) {
+		return;
+	}
+
+	cpu = plat_my_core_pos();
+	head = el3_trace_cpu[cpu]->head;
+	entry = &el3_trace_ring[cpu][head & el3_trace_mask];
+
+	entry->timestamp = read_cntpct_el0();
+	entry->id = id;
+	entry->arg0 = arg0;
+	entry->arg1 = arg1;
+	entry->arg2 = arg2;
+
+	dmbishst();
+	el3_trace_cpu[cpu]->head = head + 1U;
+}
+
+/*******************************************************************************
+ * Map the Normal world buffer and carve it into one ring per CPU. The number of
+ * entries of each ring is rounded down to a power of two. The buffer stays
+ * mapped until the next reset, as other CPUs may be writing to it at any time,
+ * so only the first call can succeed and later ones are denied.
+ ******************************************************************************/
+static int el3_trace_init(uint64_t pa, size_t size)
+{
+	el3_trace_hdr_t *hdr;
+	el3_trace_entry_t *ring;
+	uintptr_t va;
+	size_t ring_size;
+	uint64_t entries;
+	unsigned int i;
+
+	if (el3_trace_initialized) {
+		return EL3_TRACE_E_DENIED;
+	}
+
+	if (((pa & PAGE_SIZE_MASK) != 0U) || ((size & PAGE_SIZE_MASK) != 0U) ||
+	    (size <= (sizeof(el3_trace_hdr_t) +
+		      (PLATFORM_CORE_COUNT * sizeof(el3_trace_cpu_t))))) {
+		return EL3_TRACE_E_INVALID_PARAMS;
+	}
+
+	if (plat_validate_ns_region((uintptr_t)pa, size) != 0) {
+		return EL3_TRACE_E_INVALID_PARAMS;
+	}
+
+	ring_size = size - sizeof(el3_trace_hdr_t) -
+		    (PLATFORM_CORE_COUNT * sizeof(el3_trace_cpu_t));
+	entries = ring_size / (PLATFORM_CORE_COUNT * sizeof(el3_trace_entry_t));
+	if (entries == 0U) {
+		return EL3_TRACE_E_INVALID_PARAMS;
+	}
+
+	/* Round down to a power of two */
+	while ((entries & (entries - 1U)) != 0U) {
+		entries &= entries - 1U;
+	}
+
+	if (mmap_add_dynamic_region_alloc_va(pa, &va, size, MT_RW_DATA |
+					     MT_NS | MT_CONTIGUOUS) != 0) {
+		return EL3_TRACE_E_INVALID_PARAMS;
+	}
+
+	hdr = (el3_trace_hdr_t *)va;
+	hdr->magic = EL3_TRACE_MAGIC;
+	hdr->version = EL3_TRACE_VERSION;
+	hdr->num_cpus = PLATFORM_CORE_COUNT;
+	hdr->entries_per_cpu = (uint32_t)entries;
+	hdr->timer_freq = read_cntfrq_el0();
+
+	ring = (el3_trace_entry_t *)((el3_trace_cpu_t *)(hdr + 1) +
+				     PLATFORM_CORE_COUNT);
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		el3_trace_cpu[i] = (el3_trace_cpu_t *)(hdr + 1) + i;
+		el3_trace_cpu[i]->head = 0U;
+		el3_trace_ring[i] = ring + (i * entries);
+	}
+
+	el3_trace_mask = entries - 1U;
+	el3_trace_initialized = true;
+
+	INFO("EL3 trace: %llu entries per CPU at 0x%llx\n",
+	     (unsigned long long)entries, (unsigned long long)pa);
+
+	return EL3_TRACE_E_SUCCESS;
+}
+
+uintptr_t el3_trace_smc_handler(unsigned int smc_fid,
+				u_register_t x1,
+				u_register_t x2,
+				u_register_t x3,
+				u_register_t x4,
+				void *cookie,
+				void *handle,
+				u_register_t flags)
+{
+	int ret = EL3_TRACE_E_SUCCESS;
+
+	/* Allow calls from non-secure only */
+	if (is_caller_secure(flags)) {
+		SMC_RET1(handle, EL3_TRACE_E_DENIED);
+	}
+
+	if (smc_fid != EL3_TRACE_SMC_64) {
+		SMC_RET1(handle, SMC_UNK);
+	}
+
+	spin_lock(&el3_trace_lock);
+
+	switch (x1) {
+	case EL3_TRACE_CMD_INIT:
+		ret = el3_trace_init(x2, x3);
+		break;
+
+	case EL3_TRACE_CMD_START:
+		if (!el3_trace_initialized) {
+			ret = EL3_TRACE_E_DENIED;
+			break;
+		}
+		dmbish();
+		el3_trace_enabled = true;
+		break;
+
+	case EL3_TRACE_CMD_STOP:
+		el3_trace_enabled = false;
+		break;
+
+	default:
+		ret = EL3_TRACE_E_INVALID_PARAMS;
+		break;
+	}
+
+	spin_unlock(&el3_trace_lock);
+
+	SMC_RET1(handle, ret);
+}
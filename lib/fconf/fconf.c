@@ -1,14 +1,16 @@
 /*
- * Copyright (c) 2019-2022, ARM Limited. All rights reserved.
+ * Copyright (c) 2019-2023, ARM Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
+#include <errno.h>
 
 #include <common/debug.h>
 #include <common/fdt_wrappers.h>
 #include <lib/fconf/fconf.h>
+#include <lib/fconf/fconf_bin.h>
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
 #include <libfdt.h>
 #include <plat/common/platform.h>
@@ -47,18 +49,70 @@ int fconf_load_config(unsigned int image_id)
 	return 0;
 }
 
+#if FCONF_BIN_CONFIG
+/*
+ * Return the dtb embedded in a binary configuration, or 0 if there is none or
+ * if it is invalid.
+ */
+static uintptr_t fconf_bin_get_dtb(uintptr_t config)
+{
+	const void *dtb;
+	uint32_t size;
+
+	dtb = fconf_bin_get_section(config, FCONF_BIN_SEC_DTB, 1U, &size);
+	if ((dtb == NULL) || (size < sizeof(struct fdt_header)) ||
+	    (fdt_check_header(dtb) != 0) || (fdt_totalsize(dtb) > size)) {
+		return 0UL;
+	}
+
+	return (uintptr_t)dtb;
+}
+#endif /* FCONF_BIN_CONFIG */
+
+#ifdef PLAT_FCONF_FDT_INDEX_NODES
+/*
+ * The populators only read the DTB, index it so that their parent and phandle
+ * lookups don't rescan it.
+ */
+FDTW_INDEX_DECLARE(fconf_fdt_index, PLAT_FCONF_FDT_INDEX_NODES,
+		   PLAT_FCONF_FDT_INDEX_PHANDLES);
+#endif
+
 void fconf_populate(const char *config_type, uintptr_t config)
 {
+	uintptr_t dtb = config;
+	bool bin = false;
+
 	assert(config != 0UL);
 
+#if FCONF_BIN_CONFIG
+	int rc = fconf_bin_check(config);
+
+	if (rc == 0) {
+		bin = true;
+		dtb = fconf_bin_get_dtb(config);
+	} else if (rc != -ENOENT) {
+		ERROR("FCONF: Invalid binary config passed for %s\n",
+		      config_type);
+		panic();
+	}
+#endif
+
 	/* Check if the pointer to DTB is correct */
-	if (fdt_check_header((void *)config) != 0) {
+	if (!bin && (fdt_check_header((void *)dtb) != 0)) {
 		ERROR("FCONF: Invalid DTB file passed for %s\n", config_type);
 		panic();
 	}
 
 	INFO("FCONF: Reading %s firmware configuration file from: 0x%lx\n", config_type, config);
 
+#ifdef PLAT_FCONF_FDT_INDEX_NODES
+	if ((dtb != 0UL) &&
+	    (fdtw_index_init(&fconf_fdt_index, (const void *)dtb) != 0)) {
+		VERBOSE("FCONF: %s is not indexed\n", config_type);
+	}
+#endif
+
 	/* Go through all registered populate functions */
 	IMPORT_SYM(struct fconf_populator *, __FCONF_POPULATOR_START__, start);
 	IMPORT_SYM(struct fconf_populator *, __FCONF_POPULATOR_END__, end);
@@ -69,10 +123,25 @@ void fconf_populate(const char *config_type, uintptr_t config)
 
 		if (strcmp(populator->config_type, config_type) == 0) {
 			INFO("FCONF: Reading firmware configuration information for: %s\n", populator->info);
-			if (populator->populate(config) != 0) {
+			/* Fall back to the dtb for the populators that need it */
+			uintptr_t arg = (bin && !populator->bin) ? dtb : config;
+
+			if (arg == 0UL) {
+				ERROR("FCONF: No DTB in binary config for %s\n",
+				      populator->info);
+				panic();
+			}
+			if (populator->populate(arg) != 0) {
 				/* TODO: handle property miss */
 				panic();
 			}
 		}
 	}
+
+#ifdef PLAT_FCONF_FDT_INDEX_NODES
+	/* The DTB may be modified or reused once it has been parsed */
+	if (dtb != 0UL) {
+		fdtw_index_invalidate((const void *)dtb);
+	}
+#endif
 }
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2019-2021, ARM Limited. All rights reserved.
+# Copyright (c) 2019-2023, ARM Limited. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -12,6 +12,11 @@ FCONF_SOURCES		+=	${FDT_WRAPPERS_SOURCES}
 FCONF_DYN_SOURCES	:=	lib/fconf/fconf_dyn_cfg_getter.c
 FCONF_DYN_SOURCES	+=	${FDT_WRAPPERS_SOURCES}
 
+ifeq (${FCONF_BIN_CONFIG},1)
+FCONF_SOURCES		+=	lib/fconf/fconf_bin.c
+FCONF_DYN_SOURCES	+=	lib/fconf/fconf_bin.c
+endif
+
 FCONF_AMU_SOURCES	:=	lib/fconf/fconf_amu_getter.c
 FCONF_AMU_SOURCES	+=	${FDT_WRAPPERS_SOURCES}
 
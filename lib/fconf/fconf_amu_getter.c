@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -87,7 +87,7 @@ static int fconf_populate_amu_cpu(const void *fdt, int node, uintptr_t mpidr)
 		return ret;
 	}
 
-	node = fdt_node_offset_by_phandle(fdt, amu_phandle);
+	node = fdtw_node_offset_by_phandle(fdt, amu_phandle);
 	if (node < 0) {
 		return node;
 	}
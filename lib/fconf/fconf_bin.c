@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+
+#include <common/debug.h>
+#include <lib/fconf/fconf_bin.h>
+
+/*******************************************************************************
+ * Check that 'config' points to a binary configuration blob of a supported
+ * version, and that its section table fits in the blob. Returns 0 if so,
+ * -ENOENT if it is not a binary blob (e.g. a DTB) and -EINVAL if it is an
+ * unusable one.
+ ******************************************************************************/
+int fconf_bin_check(uintptr_t config)
+{
+	const struct fconf_bin_hdr *hdr = (const struct fconf_bin_hdr *)config;
+	const struct fconf_bin_section *sec;
+	uint64_t table_end;
+	unsigned int i;
+
+	assert(config != 0UL);
+
+	if (hdr->magic != FCONF_BIN_MAGIC) {
+		return -ENOENT;
+	}
+
+	if (hdr->version != FCONF_BIN_VERSION) {
+		ERROR("FCONF: Unsupported binary config version %u\n",
+		      hdr->version);
+		return -EINVAL;
+	}
+
+	table_end = sizeof(*hdr) +
+		    ((uint64_t)hdr->num_sections * sizeof(*sec));
+	if (table_end > hdr->total_size) {
+		ERROR("FCONF: Truncated binary config\n");
+		return -EINVAL;
+	}
+
+	sec = (const struct fconf_bin_section *)(hdr + 1);
+	for (i = 0U; i < hdr->num_sections; i++) {
+		if ((((uint64_t)sec[i].offset + sec[i].size) > hdr->total_size) ||
+		    ((sec[i].offset % FCONF_BIN_ALIGN) != 0U)) {
+			ERROR("FCONF: Invalid binary config section %u\n", i);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Return the first section of type 'type' of a blob already validated by
+ * fconf_bin_check(), and its number of entries in 'count'. The section must
+ * hold 'count' entries of 'entry_size' bytes. Returns NULL if there is no such
+ * section or if it is too small.
+ ******************************************************************************/
+const void *fconf_bin_get_section(uintptr_t config, uint32_t type,
+				  uint32_t entry_size, uint32_t *count)
+{
+	const struct fconf_bin_hdr *hdr = (const struct fconf_bin_hdr *)config;
+	const struct fconf_bin_section *sec;
+	unsigned int i;
+
+	assert(count != NULL);
+
+	sec = (const struct fconf_bin_section *)(hdr + 1);
+	for (i = 0U; i < hdr->num_sections; i++) {
+		if (sec[i].type != type) {
+			continue;
+		}
+
+		if (((uint64_t)sec[i].count * entry_size) > sec[i].size) {
+			ERROR("FCONF: Binary config section %u too small\n",
+			      type);
+			return NULL;
+		}
+
+		*count = sec[i].count;
+		return (const void *)(config + sec[i].offset);
+	}
+
+	return NULL;
+}
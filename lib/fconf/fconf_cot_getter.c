@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -196,7 +196,7 @@ static int get_oid(const void *dtb, int node, const char *prop, char **oid)
 		return rc;
 	}
 
-	node = fdt_node_offset_by_phandle(dtb, phandle);
+	node = fdtw_node_offset_by_phandle(dtb, phandle);
 	if (node < 0) {
 		return node;
 	}
@@ -295,7 +295,7 @@ static int get_parent_img_id(const void *dtb, int node,
 		return err;
 	}
 
-	node = fdt_node_offset_by_phandle(dtb, phandle);
+	node = fdtw_node_offset_by_phandle(dtb, phandle);
 	if (node < 0) {
 		ERROR("FCONF: Failed to locate node using its phandle\n");
 		return node;
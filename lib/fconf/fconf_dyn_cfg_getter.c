@@ -1,13 +1,15 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
+#include <errno.h>
 
 #include <common/debug.h>
 #include <common/fdt_wrappers.h>
+#include <lib/fconf/fconf_bin.h>
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
 #include <lib/object_pool.h>
 #include <libfdt.h>
@@ -73,6 +75,42 @@ struct dyn_cfg_dtb_info_t *dyn_cfg_dtb_info_getter(unsigned int config_id)
 	return NULL;
 }
 
+#if FCONF_BIN_CONFIG
+/*
+ * Populate the dtb registry from a pre-parsed binary FW_CONFIG, see
+ * fconf_bin.h. The entries are used in place.
+ */
+static int fconf_populate_dtb_registry_bin(uintptr_t config)
+{
+	const struct fconf_bin_hdr *hdr = (const struct fconf_bin_hdr *)config;
+	const struct fconf_bin_dtb_entry *entry;
+	uint32_t count, i;
+
+	/* See fconf_populate_dtb_registry() */
+	if (dtb_infos[0].config_id == 0U) {
+		set_config_info(config, ~0UL, hdr->total_size, FW_CONFIG_ID);
+	}
+
+	entry = fconf_bin_get_section(config, FCONF_BIN_SEC_DTB_REGISTRY,
+				      sizeof(*entry), &count);
+	if (entry == NULL) {
+		ERROR("FCONF: No dtb-registry in binary config\n");
+		return -1;
+	}
+
+	for (i = 0U; i < count; i++) {
+		VERBOSE("FCONF: dyn_cfg.dtb_registry entry %u: id %u at %llx\n",
+			i, entry[i].id, (unsigned long long)entry[i].load_addr);
+
+		set_config_info((uintptr_t)entry[i].load_addr,
+				(uintptr_t)entry[i].ns_load_addr,
+				entry[i].max_size, entry[i].id);
+	}
+
+	return 0;
+}
+#endif /* FCONF_BIN_CONFIG */
+
 int fconf_populate_dtb_registry(uintptr_t config)
 {
 	int rc;
@@ -81,6 +119,13 @@ int fconf_populate_dtb_registry(uintptr_t config)
 	/* As libfdt use void *, we can't avoid this cast */
 	const void *dtb = (void *)config;
 
+#if FCONF_BIN_CONFIG
+	rc = fconf_bin_check(config);
+	if (rc != -ENOENT) {
+		return (rc == 0) ? fconf_populate_dtb_registry_bin(config) : rc;
+	}
+#endif
+
 	/*
 	 * In case of BL1, fw_config dtb information is already
 	 * populated in global dtb_infos array by 'set_fw_config_info'
@@ -152,4 +197,4 @@ int fconf_populate_dtb_registry(uintptr_t config)
 	return 0;
 }
 
-FCONF_REGISTER_POPULATOR(FW_CONFIG, dyn_cfg, fconf_populate_dtb_registry);
+FCONF_REGISTER_BIN_POPULATOR(FW_CONFIG, dyn_cfg, fconf_populate_dtb_registry);
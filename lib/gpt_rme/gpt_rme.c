@@ -100,51 +100,56 @@ static bool gpt_is_gpi_valid(unsigned int gpi)
 }
 
 /*
- * This function checks to see if two PAS regions overlap.
- *
- * Parameters
- *   base_1: base address of first PAS
- *   size_1: size of first PAS
- *   base_2: base address of second PAS
- *   size_2: size of second PAS
- *
- * Return
- *   True if PAS regions overlap, false if they do not.
+ * Helper for gpt_sort_pas_regions, sifts PAS at index root down the max-heap
+ * made of the first cnt entries of the array, ordered by base address.
  */
-static bool gpt_check_pas_overlap(uintptr_t base_1, size_t size_1,
-				  uintptr_t base_2, size_t size_2)
+static void gpt_sift_down_pas(pas_region_t *pas, unsigned int root,
+			      unsigned int cnt)
 {
-	if (((base_1 + size_1) > base_2) && ((base_2 + size_2) > base_1)) {
-		return true;
+	pas_region_t tmp;
+	unsigned int child;
+
+	while ((2U * root + 1U) < cnt) {
+		child = 2U * root + 1U;
+		if (((child + 1U) < cnt) &&
+		    (pas[child + 1U].base_pa > pas[child].base_pa)) {
+			child++;
+		}
+
+		if (pas[root].base_pa >= pas[child].base_pa) {
+			return;
+		}
+
+		tmp = pas[root];
+		pas[root] = pas[child];
+		pas[child] = tmp;
+		root = child;
 	}
-	return false;
 }
 
 /*
- * This helper function checks to see if a PAS region from index 0 to
- * (pas_idx - 1) occupies the L0 region at index l0_idx in the L0 table.
+ * This function sorts an array of PAS regions by base address, in place. A
+ * heap sort is used as it needs neither recursion nor extra memory.
  *
  * Parameters
- *   l0_idx:      Index of the L0 entry to check
- *   pas_regions: PAS region array
- *   pas_idx:     Upper bound of the PAS array index.
- *
- * Return
- *   True if a PAS region occupies the L0 region in question, false if not.
+ *   *pas		Pointer to an array of PAS regions.
+ *   pas_count		Number of entries in the PAS array.
  */
-static bool gpt_does_previous_pas_exist_here(unsigned int l0_idx,
-					     pas_region_t *pas_regions,
-					     unsigned int pas_idx)
+static void gpt_sort_pas_regions(pas_region_t *pas, unsigned int pas_count)
 {
-	/* Iterate over PAS regions up to pas_idx. */
-	for (unsigned int i = 0U; i < pas_idx; i++) {
-		if (gpt_check_pas_overlap((GPT_L0GPTSZ_ACTUAL_SIZE * l0_idx),
-		    GPT_L0GPTSZ_ACTUAL_SIZE,
-		    pas_regions[i].base_pa, pas_regions[i].size)) {
-			return true;
-		}
+	pas_region_t tmp;
+	unsigned int i;
+
+	for (i = pas_count / 2U; i > 0U; i--) {
+		gpt_sift_down_pas(pas, i - 1U, pas_count);
+	}
+
+	for (i = pas_count - 1U; i > 0U; i--) {
+		tmp = pas[0];
+		pas[0] = pas[i];
+		pas[i] = tmp;
+		gpt_sift_down_pas(pas, 0U, i);
 	}
-	return false;
 }
 
 /*
@@ -155,6 +160,9 @@ static bool gpt_does_previous_pas_exist_here(unsigned int l0_idx,
  * is called multiple times to place L1 tables in different areas of memory. It
  * also counts the number of L1 tables needed and returns it on success.
  *
+ * The array is sorted by base address so that overlaps, and L1 tables shared
+ * between PAS regions, only need checking between neighbouring entries.
+ *
  * Parameters
  *   *pas_regions	Pointer to array of PAS region structures.
  *   pas_region_cnt	Total number of PAS regions in the array.
@@ -168,7 +176,9 @@ static int gpt_validate_pas_mappings(pas_region_t *pas_regions,
 {
 	unsigned int idx;
 	unsigned int l1_cnt = 0U;
-	unsigned int pas_l1_cnt;
+	unsigned int first_l0_idx;
+	unsigned int last_l0_idx;
+	unsigned int prev_l0_idx = UINT_MAX;
 	uint64_t *l0_desc = (uint64_t *)gpt_config.plat_gpt_l0_base;
 
 	assert(pas_regions != NULL);
@@ -190,22 +200,6 @@ static int gpt_validate_pas_mappings(pas_region_t *pas_regions,
 			return -EFAULT;
 		}
 
-		/*
-		 * Make sure this PAS does not overlap with another one. We
-		 * start from idx + 1 instead of 0 since prior PAS mappings will
-		 * have already checked themselves against this one.
-		 */
-		for (unsigned int i = idx + 1; i < pas_region_cnt; i++) {
-			if (gpt_check_pas_overlap(pas_regions[idx].base_pa,
-			    pas_regions[idx].size,
-			    pas_regions[i].base_pa,
-			    pas_regions[i].size)) {
-				ERROR("[GPT] PAS[%u] overlaps with PAS[%u]\n",
-					i, idx);
-				return -EFAULT;
-			}
-		}
-
 		/*
 		 * Since this function can be called multiple times with
 		 * separate L1 tables we need to check the existing L0 mapping
@@ -255,42 +249,6 @@ static int gpt_validate_pas_mappings(pas_region_t *pas_regions,
 				return -EFAULT;
 			}
 
-			/* Find how many L1 tables this PAS occupies. */
-			pas_l1_cnt = (GPT_L0_IDX(pas_regions[idx].base_pa +
-				     pas_regions[idx].size - 1) -
-				     GPT_L0_IDX(pas_regions[idx].base_pa) + 1);
-
-			/*
-			 * This creates a situation where, if multiple PAS
-			 * regions occupy the same table descriptor, we can get
-			 * an artificially high total L1 table count. The way we
-			 * handle this is by checking each PAS against those
-			 * before it in the array, and if they both occupy the
-			 * same PAS we subtract from pas_l1_cnt and only the
-			 * first PAS in the array gets to count it.
-			 */
-
-			/*
-			 * If L1 count is greater than 1 we know the start and
-			 * end PAs are in different L0 regions so we must check
-			 * both for overlap against other PAS.
-			 */
-			if (pas_l1_cnt > 1) {
-				if (gpt_does_previous_pas_exist_here(
-				    GPT_L0_IDX(pas_regions[idx].base_pa +
-				    pas_regions[idx].size - 1),
-				    pas_regions, idx)) {
-					pas_l1_cnt = pas_l1_cnt - 1;
-				}
-			}
-
-			if (gpt_does_previous_pas_exist_here(
-			    GPT_L0_IDX(pas_regions[idx].base_pa),
-			    pas_regions, idx)) {
-				pas_l1_cnt = pas_l1_cnt - 1;
-			}
-
-			l1_cnt += pas_l1_cnt;
 			continue;
 		}
 
@@ -300,6 +258,43 @@ static int gpt_validate_pas_mappings(pas_region_t *pas_regions,
 		return -EINVAL;
 	}
 
+	gpt_sort_pas_regions(pas_regions, pas_region_cnt);
+
+	for (idx = 0U; idx < pas_region_cnt; idx++) {
+		/*
+		 * Make sure this PAS does not overlap with another one. Once
+		 * sorted, it can only overlap with the one before it.
+		 */
+		if ((idx > 0U) &&
+		    ((pas_regions[idx - 1U].base_pa +
+		      pas_regions[idx - 1U].size) > pas_regions[idx].base_pa)) {
+			ERROR("[GPT] PAS at 0x%lx overlaps with PAS at 0x%lx\n",
+			      pas_regions[idx].base_pa,
+			      pas_regions[idx - 1U].base_pa);
+			return -EFAULT;
+		}
+
+		if (GPT_PAS_ATTR_MAP_TYPE(pas_regions[idx].attrs) !=
+		    GPT_PAS_ATTR_MAP_TYPE_GRANULE) {
+			continue;
+		}
+
+		/*
+		 * Find how many L1 tables this PAS occupies. If the previous
+		 * granule PAS ends in the L0 region this one starts in, the
+		 * table is shared and has already been counted.
+		 */
+		first_l0_idx = GPT_L0_IDX(pas_regions[idx].base_pa);
+		last_l0_idx = GPT_L0_IDX(pas_regions[idx].base_pa +
+					 pas_regions[idx].size - 1);
+		if (first_l0_idx == prev_l0_idx) {
+			first_l0_idx++;
+		}
+
+		l1_cnt += last_l0_idx + 1U - first_l0_idx;
+		prev_l0_idx = last_l0_idx;
+	}
+
 	return l1_cnt;
 }
 
@@ -481,9 +476,31 @@ static uintptr_t gpt_get_l1_end_pa(uintptr_t cur_pa, uintptr_t end_pa)
 	return (cur_idx + 1U) << GPT_L0_IDX_SHIFT;
 }
 
+/*
+ * Helper function to write the same L1 descriptor to the entries in the range
+ * [first_idx, last_idx) of an L1 table. These entries are entirely covered by
+ * the PAS being mapped so no masking is needed and the loop compiles down to
+ * plain (paired) 64-bit stores.
+ *
+ * Parameters
+ *   desc		L1 descriptor to write
+ *   l1			Pointer to L1 table to fill out
+ *   first_idx		Index of the first L1 entry to write.
+ *   last_idx		Index of the entry after the last one to write.
+ */
+static void gpt_fill_l1_entries(uint64_t desc, uint64_t *l1,
+				unsigned int first_idx, unsigned int last_idx)
+{
+	for (unsigned int i = first_idx; i < last_idx; i++) {
+		l1[i] = desc;
+	}
+}
+
 /*
  * Helper function to fill out GPI entries in a single L1 table. This function
- * fills out entire L1 descriptors at a time to save memory writes.
+ * fills out entire L1 descriptors at a time to save memory writes: only the
+ * first and last descriptors of the range may need to be merged with their
+ * current value, the ones in between are written directly.
  *
  * Parameters
  *   gpi		GPI to set this range to
@@ -495,7 +512,10 @@ static void gpt_fill_l1_tbl(uint64_t gpi, uint64_t *l1, uintptr_t first,
 			    uintptr_t last)
 {
 	uint64_t gpi_field = GPT_BUILD_L1_DESC(gpi);
-	uint64_t gpi_mask = 0xFFFFFFFFFFFFFFFF;
+	uint64_t first_mask;
+	uint64_t last_mask;
+	unsigned int first_idx;
+	unsigned int last_idx;
 
 	assert(first <= last);
 	assert((first & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) == 0U);
@@ -503,40 +523,60 @@ static void gpt_fill_l1_tbl(uint64_t gpi, uint64_t *l1, uintptr_t first,
 	assert(GPT_L0_IDX(first) == GPT_L0_IDX(last));
 	assert(l1 != NULL);
 
-	/* Shift the mask if we're starting in the middle of an L1 entry. */
-	gpi_mask = gpi_mask << (GPT_L1_GPI_IDX(gpt_config.p, first) << 2);
+	first_idx = GPT_L1_IDX(gpt_config.p, first);
+	last_idx = GPT_L1_IDX(gpt_config.p, last);
+
+	/* Account for starting and stopping in the middle of an L1 entry. */
+	first_mask = UINT64_MAX << (GPT_L1_GPI_IDX(gpt_config.p, first) << 2);
+	last_mask = UINT64_MAX >> ((15U -
+		    GPT_L1_GPI_IDX(gpt_config.p, last)) << 2);
+
+	if (first_idx == last_idx) {
+		first_mask &= last_mask;
+		assert((l1[first_idx] & first_mask) ==
+		       (GPT_BUILD_L1_DESC(GPT_GPI_ANY) & first_mask));
+		l1[first_idx] = (l1[first_idx] & ~first_mask) |
+				(first_mask & gpi_field);
+		return;
+	}
 
-	/* Fill out each L1 entry for this region. */
-	for (unsigned int i = GPT_L1_IDX(gpt_config.p, first);
-	     i <= GPT_L1_IDX(gpt_config.p, last); i++) {
-		/* Account for stopping in the middle of an L1 entry. */
-		if (i == GPT_L1_IDX(gpt_config.p, last)) {
-			gpi_mask &= (gpi_mask >> ((15 -
-				    GPT_L1_GPI_IDX(gpt_config.p, last)) << 2));
-		}
+#if ENABLE_ASSERTIONS
+	for (unsigned int i = first_idx; i <= last_idx; i++) {
+		uint64_t mask = UINT64_MAX;
 
-		/* Write GPI values. */
-		assert((l1[i] & gpi_mask) ==
-		       (GPT_BUILD_L1_DESC(GPT_GPI_ANY) & gpi_mask));
-		l1[i] = (l1[i] & ~gpi_mask) | (gpi_mask & gpi_field);
+		if (i == first_idx) {
+			mask = first_mask;
+		} else if (i == last_idx) {
+			mask = last_mask;
+		}
 
-		/* Reset mask. */
-		gpi_mask = 0xFFFFFFFFFFFFFFFF;
+		assert((l1[i] & mask) == (GPT_BUILD_L1_DESC(GPT_GPI_ANY) & mask));
 	}
+#endif
+
+	/* Write GPI values. */
+	l1[first_idx] = (l1[first_idx] & ~first_mask) | (first_mask & gpi_field);
+	gpt_fill_l1_entries(gpi_field, l1, first_idx + 1U, last_idx);
+	l1[last_idx] = (l1[last_idx] & ~last_mask) | (last_mask & gpi_field);
 }
 
 /*
- * This function finds the next available unused L1 table and initializes all
- * granules descriptor entries to GPI_ANY. This ensures that there are no chunks
- * of GPI_NO_ACCESS (0b0000) memory floating around in the system in the
- * event that a PAS region stops midway through an L1 table, thus guaranteeing
- * that all memory not explicitly assigned is GPI_ANY. This function does not
- * check for overflow conditions, that should be done by the caller.
+ * This function finds the next available unused L1 table and, if init is true,
+ * initializes all granules descriptor entries to GPI_ANY. This ensures that
+ * there are no chunks of GPI_NO_ACCESS (0b0000) memory floating around in the
+ * system in the event that a PAS region stops midway through an L1 table, thus
+ * guaranteeing that all memory not explicitly assigned is GPI_ANY. The caller
+ * can skip the initialization when it is about to fill the whole table. This
+ * function does not check for overflow conditions, that should be done by the
+ * caller.
+ *
+ * Parameters
+ *   init		Whether to initialize the table to GPI_ANY.
  *
  * Return
  *   Pointer to the next available L1 table.
  */
-static uint64_t *gpt_get_new_l1_tbl(void)
+static uint64_t *gpt_get_new_l1_tbl(bool init)
 {
 	/* Retrieve the next L1 table. */
 	uint64_t *l1 = (uint64_t *)((uint64_t)(gpt_l1_tbl) +
@@ -547,8 +587,9 @@ static uint64_t *gpt_get_new_l1_tbl(void)
 	gpt_next_l1_tbl_idx++;
 
 	/* Initialize all GPIs to GPT_GPI_ANY */
-	for (unsigned int i = 0U; i < GPT_L1_ENTRY_COUNT(gpt_config.p); i++) {
-		l1[i] = GPT_BUILD_L1_DESC(GPT_GPI_ANY);
+	if (init) {
+		gpt_fill_l1_entries(GPT_BUILD_L1_DESC(GPT_GPI_ANY), l1, 0U,
+				    GPT_L1_ENTRY_COUNT(gpt_config.p));
 	}
 
 	return l1;
@@ -570,6 +611,8 @@ static void gpt_generate_l0_tbl_desc(pas_region_t *pas)
 	uint64_t *l0_gpt_base;
 	uint64_t *l1_gpt_arr;
 	unsigned int l0_idx;
+	bool full;
+	bool filled;
 
 	assert(gpt_config.plat_gpt_l0_base != 0U);
 	assert(pas != NULL);
@@ -590,6 +633,18 @@ static void gpt_generate_l0_tbl_desc(pas_region_t *pas)
 	     l0_idx <= GPT_L0_IDX(end_pa - 1U);
 	     l0_idx++) {
 
+		/*
+		 * Determine the PA of the last granule in this L0 descriptor.
+		 */
+		last_gran_pa = gpt_get_l1_end_pa(cur_pa, end_pa) -
+			       GPT_PGS_ACTUAL_SIZE(gpt_config.p);
+
+		/* Check whether the PAS covers the whole L0 region. */
+		full = GPT_IS_L0_ALIGNED(cur_pa) &&
+		       GPT_IS_L0_ALIGNED(last_gran_pa +
+					 GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+		filled = false;
+
 		/*
 		 * See if the L0 entry is already a table descriptor or if we
 		 * need to create one.
@@ -598,8 +653,19 @@ static void gpt_generate_l0_tbl_desc(pas_region_t *pas)
 			/* Get the L1 array from the L0 entry. */
 			l1_gpt_arr = GPT_L0_TBLD_ADDR(l0_gpt_base[l0_idx]);
 		} else {
-			/* Get a new L1 table from the L1 memory space. */
-			l1_gpt_arr = gpt_get_new_l1_tbl();
+			/*
+			 * Get a new L1 table from the L1 memory space. If the
+			 * PAS covers all of it, write its GPI directly instead
+			 * of initializing the table to GPI_ANY first.
+			 */
+			l1_gpt_arr = gpt_get_new_l1_tbl(!full);
+			if (full) {
+				gpt_fill_l1_entries(GPT_BUILD_L1_DESC(
+						GPT_PAS_ATTR_GPI(pas->attrs)),
+						l1_gpt_arr, 0U,
+						GPT_L1_ENTRY_COUNT(gpt_config.p));
+				filled = true;
+			}
 
 			/* Fill out the L0 descriptor and flush it. */
 			l0_gpt_base[l0_idx] = GPT_L0_TBL_DESC(l1_gpt_arr);
@@ -610,19 +676,15 @@ static void gpt_generate_l0_tbl_desc(pas_region_t *pas)
 			(unsigned long long)(l1_gpt_arr),
 			l0_gpt_base[l0_idx]);
 
-		/*
-		 * Determine the PA of the last granule in this L0 descriptor.
-		 */
-		last_gran_pa = gpt_get_l1_end_pa(cur_pa, end_pa) -
-			       GPT_PGS_ACTUAL_SIZE(gpt_config.p);
-
 		/*
 		 * Fill up L1 GPT entries between these two addresses. This
 		 * function needs the addresses of the first granule and last
 		 * granule in the range.
 		 */
-		gpt_fill_l1_tbl(GPT_PAS_ATTR_GPI(pas->attrs), l1_gpt_arr,
-				cur_pa, last_gran_pa);
+		if (!filled) {
+			gpt_fill_l1_tbl(GPT_PAS_ATTR_GPI(pas->attrs),
+					l1_gpt_arr, cur_pa, last_gran_pa);
+		}
 
 		/* Advance cur_pa to first granule in next L0 region. */
 		cur_pa = gpt_get_l1_end_pa(cur_pa, end_pa);
@@ -822,10 +884,17 @@ int gpt_init_pas_l1_tables(gpccr_pgs_e pgs, uintptr_t l1_mem_base,
 {
 	int ret;
 	int l1_gpt_cnt;
+	uint64_t start_cnt;
 
 	/* Ensure that MMU and Data caches are enabled. */
 	assert((read_sctlr_el3() & SCTLR_C_BIT) != 0U);
 
+	/*
+	 * The tables are built before any runtime instrumentation exists, so
+	 * use the generic timer to report how long this takes.
+	 */
+	start_cnt = read_cntpct_el0();
+
 	/* PGS is needed for gpt_validate_pas_mappings so check it now. */
 	if (pgs > GPT_PGS_MAX) {
 		ERROR("[GPT] Invalid PGS: 0x%x\n", pgs);
@@ -901,6 +970,10 @@ int gpt_init_pas_l1_tables(gpccr_pgs_e pgs, uintptr_t l1_mem_base,
 	dsb();
 	isb();
 
+	INFO("[GPT] L1 tables generated in %llu us\n",
+	     (unsigned long long)(((read_cntpct_el0() - start_cnt) * 1000000U) /
+				  read_cntfrq_el0()));
+
 	return 0;
 }
 
@@ -1000,6 +1073,74 @@ static int get_gpi_params(uint64_t base, gpi_info_t *gpi_info)
 	return 0;
 }
 
+/*
+ * Public API to retrieve the GPI of the granule containing the physical address
+ * 'base', as currently programmed in the GPT. Both L0 block descriptors and L1
+ * granule descriptors are handled.
+ *
+ * Return
+ *   Negative Linux error code in the event of a failure, 0 for success.
+ */
+int gpt_get_gpi(uint64_t base, unsigned int *gpi)
+{
+	uint64_t gpt_l0_desc, *gpt_l0_base;
+	gpi_info_t gpi_info;
+	int res;
+
+	assert(gpi != NULL);
+
+	/* Ensure that the tables have been set up before taking requests. */
+	assert(gpt_config.plat_gpt_l0_base != 0UL);
+
+	if (base >= GPT_PPS_ACTUAL_SIZE(gpt_config.t)) {
+		return -EINVAL;
+	}
+
+	gpt_l0_base = (uint64_t *)gpt_config.plat_gpt_l0_base;
+	gpt_l0_desc = gpt_l0_base[GPT_L0_IDX(base)];
+	if (GPT_L0_TYPE(gpt_l0_desc) == GPT_L0_TYPE_BLK_DESC) {
+		*gpi = (unsigned int)GPT_L0_BLKD_GPI(gpt_l0_desc);
+		return 0;
+	}
+
+	res = get_gpi_params(base, &gpi_info);
+	if (res != 0) {
+		return res;
+	}
+
+	*gpi = gpi_info.gpi;
+	return 0;
+}
+
+/*
+ * Public API to access a Non-secure granule from EL3 without racing with a
+ * transition of its PAS on another CPU. If the granule containing 'base' is in
+ * the Non-secure PAS, the GPT lock is taken and kept until
+ * gpt_unlock_ns_granule() is called, so the granule stays Non-secure and can
+ * be accessed through a Non-secure mapping in the meantime.
+ *
+ * Return
+ *   Negative Linux error code in the event of a failure, 0 for success.
+ */
+int gpt_lock_ns_granule(uint64_t base)
+{
+	unsigned int gpi;
+
+	spin_lock(&gpt_lock);
+
+	if ((gpt_get_gpi(base, &gpi) != 0) || (gpi != GPT_GPI_NS)) {
+		spin_unlock(&gpt_lock);
+		return -EPERM;
+	}
+
+	return 0;
+}
+
+void gpt_unlock_ns_granule(void)
+{
+	spin_unlock(&gpt_lock);
+}
+
 /*
  * This function is the granule transition delegate service. When a granule
  * transition request occurs it is routed to this function to have the request,
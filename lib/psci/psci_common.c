@@ -14,6 +14,7 @@
 #include <context.h>
 #include <drivers/delay_timer.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/el3_trace/el3_trace.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
 
@@ -783,6 +784,11 @@ void psci_warmboot_entrypoint(void)
 		panic();
 	}
 
+#if CTX_LAZY_EL2_REGS
+	/* The EL2 registers of this CPU have lost their state */
+	cm_el2_sysregs_context_invalidate();
+#endif
+
 	/*
 	 * Get the maximum power domain level to traverse to after this cpu
 	 * has been physically powered up.
@@ -828,6 +834,8 @@ void psci_warmboot_entrypoint(void)
 	 */
 	psci_set_pwr_domains_to_run(end_pwrlvl);
 
+	EL3_TRACE_EVENT(EL3_TRACE_EV_PSCI_WAKEUP, end_pwrlvl, 0U, 0U);
+
 #if ENABLE_PSCI_STAT
 	/*
 	 * Update PSCI stats.
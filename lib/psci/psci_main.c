@@ -10,6 +10,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/debug.h>
+#include <lib/el3_trace/el3_trace.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
 #include <lib/smccc.h>
@@ -39,6 +40,8 @@ int psci_cpu_on(u_register_t target_cpu,
 	if (rc != PSCI_E_SUCCESS)
 		return rc;
 
+	EL3_TRACE_EVENT(EL3_TRACE_EV_PSCI_CPU_ON, 0U, target_cpu, entrypoint);
+
 	/*
 	 * To turn this cpu on, specify which power
 	 * levels need to be turned on
@@ -68,6 +71,9 @@ int psci_cpu_suspend(unsigned int power_state,
 		return rc;
 	}
 
+	EL3_TRACE_EVENT(EL3_TRACE_EV_PSCI_CPU_SUSPEND, power_state, entrypoint,
+			0U);
+
 	/*
 	 * Get the value of the state type bit from the power state parameter.
 	 */
@@ -200,6 +206,8 @@ int psci_cpu_off(void)
 	int rc;
 	unsigned int target_pwrlvl = PLAT_MAX_PWR_LVL;
 
+	EL3_TRACE_EVENT(EL3_TRACE_EV_PSCI_CPU_OFF, 0U, 0U, 0U);
+
 	/*
 	 * Do what is needed to power off this CPU and possible higher power
 	 * levels if it able to do so. Upon success, enter the final wfi
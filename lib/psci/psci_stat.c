@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <cdefs.h>
 
 #include <platform_def.h>
 
@@ -23,6 +24,14 @@ typedef struct psci_stat {
 	u_register_t count;
 } psci_stat_t;
 
+/*
+ * Stats of one power domain. Each instance sits in its own cache line(s) so
+ * that CPUs updating their own stats do not contend with each other.
+ */
+typedef struct psci_pd_stat {
+	psci_stat_t stat[PLAT_MAX_PWR_LVL_STATES];
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_pd_stat_t;
+
 /*
  * Following is used to keep track of the last cpu
  * that goes to power down in non cpu power domains.
@@ -34,10 +43,8 @@ static int last_cpu_in_non_cpu_pd[PSCI_NUM_NON_CPU_PWR_DOMAINS] = {
  * Following are used to store PSCI STAT values for
  * CPU and non CPU power domains.
  */
-static psci_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT]
-				[PLAT_MAX_PWR_LVL_STATES];
-static psci_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS]
-				[PLAT_MAX_PWR_LVL_STATES];
+static psci_pd_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT];
+static psci_pd_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS];
 
 /*
  * This functions returns the index into the `psci_stat_t` array given the
@@ -127,8 +134,8 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	    state_info, cpu_idx);
 
 	/* Update CPU stats. */
-	psci_cpu_stat[cpu_idx][stat_idx].residency += residency;
-	psci_cpu_stat[cpu_idx][stat_idx].count++;
+	psci_cpu_stat[cpu_idx].stat[stat_idx].residency += residency;
+	psci_cpu_stat[cpu_idx].stat[stat_idx].count++;
 
 	/*
 	 * Check what power domains above CPU were off
@@ -159,8 +166,8 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 		stat_idx = get_stat_idx(local_state, lvl);
 
 		/* Update non cpu stats */
-		psci_non_cpu_stat[parent_idx][stat_idx].residency += residency;
-		psci_non_cpu_stat[parent_idx][stat_idx].count++;
+		psci_non_cpu_stat[parent_idx].stat[stat_idx].residency += residency;
+		psci_non_cpu_stat[parent_idx].stat[stat_idx].count++;
 
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
@@ -214,10 +221,10 @@ static int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 			parent_idx = SPECULATION_SAFE_VALUE(psci_non_cpu_pd_nodes[parent_idx].parent_node);
 
 		/* Get the non cpu power domain stats */
-		*psci_stat = psci_non_cpu_stat[parent_idx][stat_idx];
+		*psci_stat = psci_non_cpu_stat[parent_idx].stat[stat_idx];
 	} else {
 		/* Get the cpu power domain stats */
-		*psci_stat = psci_cpu_stat[target_idx][stat_idx];
+		*psci_stat = psci_cpu_stat[target_idx].stat[stat_idx];
 	}
 
 	return PSCI_E_SUCCESS;
@@ -248,3 +255,67 @@ u_register_t psci_stat_count(u_register_t target_cpu,
 	else
 		return 0;
 }
+
+#if PSCI_STAT_EXPORT
+/* Size of the buffer needed by psci_stat_export() */
+size_t psci_stat_export_size(void)
+{
+	return sizeof(psci_stat_export_hdr_t) +
+		(PLATFORM_CORE_COUNT * sizeof(uint64_t)) +
+		((PLATFORM_CORE_COUNT + PSCI_NUM_NON_CPU_PWR_DOMAINS) *
+		 PLAT_MAX_PWR_LVL_STATES * sizeof(psci_stat_export_entry_t));
+}
+
+static psci_stat_export_entry_t *psci_stat_export_pd(
+		psci_stat_export_entry_t *entry, const psci_pd_stat_t *pd_stat)
+{
+	unsigned int i;
+
+	for (i = 0U; i < PLAT_MAX_PWR_LVL_STATES; i++) {
+		entry->residency = pd_stat->stat[i].residency;
+		entry->count = pd_stat->stat[i].count;
+		entry++;
+	}
+
+	return entry;
+}
+
+/*******************************************************************************
+ * This function copies the stats of all the CPU and non-CPU power domains to
+ * 'buf' in the layout described by psci_stat_export_hdr_t. The stats of other
+ * CPUs are read while they may be updated, so each counter is coherent but
+ * the snapshot as a whole is not atomic.
+ ******************************************************************************/
+int psci_stat_export(void *buf, size_t size)
+{
+	psci_stat_export_hdr_t *hdr = buf;
+	psci_stat_export_entry_t *entry;
+	uint64_t *mpidr;
+	unsigned int i;
+
+	if ((buf == NULL) || (size < psci_stat_export_size())) {
+		return PSCI_E_INVALID_PARAMS;
+	}
+
+	hdr->version = PSCI_STAT_EXPORT_VERSION;
+	hdr->num_cpus = PLATFORM_CORE_COUNT;
+	hdr->num_non_cpu_pds = PSCI_NUM_NON_CPU_PWR_DOMAINS;
+	hdr->num_states = PLAT_MAX_PWR_LVL_STATES;
+
+	mpidr = (uint64_t *)(hdr + 1);
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		mpidr[i] = psci_cpu_pd_nodes[i].mpidr;
+	}
+
+	entry = (psci_stat_export_entry_t *)&mpidr[PLATFORM_CORE_COUNT];
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		entry = psci_stat_export_pd(entry, &psci_cpu_stat[i]);
+	}
+
+	for (i = 0U; i < PSCI_NUM_NON_CPU_PWR_DOMAINS; i++) {
+		entry = psci_stat_export_pd(entry, &psci_non_cpu_stat[i]);
+	}
+
+	return PSCI_E_SUCCESS;
+}
+#endif /* PSCI_STAT_EXPORT */
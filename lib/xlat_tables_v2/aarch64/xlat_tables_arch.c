@@ -212,6 +212,107 @@ void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 	}
 }
 
+/*
+ * Invalidate 'pages' pages from 'va' with TLBI range instructions. Each one
+ * covers (NUM + 1) * 2^(5 * SCALE + 1) pages, so the range is split into at
+ * most one instruction per SCALE value, plus one TLBI by VA if the number of
+ * pages is odd. This only works for fewer than TLBIR_MAX_PAGES pages.
+ */
+static void xlat_arch_tlbi_range(uintptr_t va, size_t pages, int xlat_regime)
+{
+	unsigned int scale = 0U;
+	uint64_t num;
+	uint64_t op;
+
+	assert(pages < TLBIR_MAX_PAGES);
+
+	while (pages > 0U) {
+		if ((pages % 2U) != 0U) {
+			if (xlat_regime == EL1_EL0_REGIME) {
+				tlbivaae1is(TLBI_ADDR(va));
+			} else if (xlat_regime == EL2_REGIME) {
+				tlbivae2is(TLBI_ADDR(va));
+			} else {
+				tlbivae3is(TLBI_ADDR(va));
+			}
+			va += PAGE_SIZE;
+			pages--;
+			continue;
+		}
+
+		num = (pages >> ((5U * scale) + 1U)) & TLBIR_NUM_MASK;
+		if (num != 0U) {
+			op = ((va >> PAGE_SIZE_SHIFT) & TLBIR_BADDR_MASK) |
+			     ((num - 1U) << TLBIR_NUM_SHIFT) |
+			     ((uint64_t)scale << TLBIR_SCALE_SHIFT) |
+			     (TLBIR_TG_4K << TLBIR_TG_SHIFT);
+
+			if (xlat_regime == EL1_EL0_REGIME) {
+				tlbirvaae1is(op);
+			} else if (xlat_regime == EL2_REGIME) {
+				tlbirvae2is(op);
+			} else {
+				tlbirvae3is(op);
+			}
+
+			va += TLBIR_PAGES(num - 1U, scale) << PAGE_SIZE_SHIFT;
+			pages -= TLBIR_PAGES(num - 1U, scale);
+		}
+
+		scale++;
+	}
+}
+
+void xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime)
+{
+	size_t pages = size >> PAGE_SIZE_SHIFT;
+
+	assert(IS_PAGE_ALIGNED(va) && IS_PAGE_ALIGNED(size));
+	CASSERT(PAGE_SIZE == PAGE_SIZE_4KB, assert_tlbir_page_size);
+
+	/*
+	 * Ensure the translation table writes have drained into memory before
+	 * invalidating the TLB entries.
+	 */
+	dsbishst();
+
+	if (xlat_regime == EL1_EL0_REGIME) {
+		assert(xlat_arch_current_el() >= 1U);
+	} else if (xlat_regime == EL2_REGIME) {
+		assert(xlat_arch_current_el() >= 2U);
+	} else {
+		assert(xlat_regime == EL3_REGIME);
+		assert(xlat_arch_current_el() >= 3U);
+	}
+
+	if (is_feat_tlbirange_present() && (pages < TLBIR_MAX_PAGES)) {
+		xlat_arch_tlbi_range(va, pages, xlat_regime);
+		return;
+	}
+
+	if (pages > XLAT_TLBI_VA_MAX_PAGES) {
+		if (xlat_regime == EL1_EL0_REGIME) {
+			tlbivmalle1is();
+		} else if (xlat_regime == EL2_REGIME) {
+			tlbialle2is();
+		} else {
+			tlbialle3is();
+		}
+		return;
+	}
+
+	for (; pages > 0U; pages--) {
+		if (xlat_regime == EL1_EL0_REGIME) {
+			tlbivaae1is(TLBI_ADDR(va));
+		} else if (xlat_regime == EL2_REGIME) {
+			tlbivae2is(TLBI_ADDR(va));
+		} else {
+			tlbivae3is(TLBI_ADDR(va));
+		}
+		va += PAGE_SIZE;
+	}
+}
+
 void xlat_arch_tlbi_va_sync(void)
 {
 	/*
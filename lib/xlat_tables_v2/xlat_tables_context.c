@@ -10,7 +10,9 @@
 #include <platform_def.h>
 
 #include <common/debug.h>
+#include <lib/spinlock.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
+#include <lib/xlat_tables/xlat_tables_prebuilt.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 
 #include "xlat_tables_private.h"
@@ -28,6 +30,26 @@ uint64_t mmu_cfg_params[MMU_CFG_PARAM_MAX];
 REGISTER_XLAT_CONTEXT(tf, MAX_MMAP_REGIONS, MAX_XLAT_TABLES,
 		      PLAT_VIRT_ADDR_SPACE_SIZE, PLAT_PHY_ADDR_SPACE_SIZE);
 
+#if XLAT_TABLES_PREBUILT && defined(IMAGE_BL31)
+/*
+ * Parameters of the default translation context, extracted from the object
+ * file at build time to generate the prebuilt translation tables. Not used at
+ * run time.
+ */
+const struct xlat_prebuilt_params xlat_prebuilt_params
+	__section(".rodata.xlat_prebuilt_params") = {
+	.magic = XLAT_PREBUILT_MAGIC,
+	.flags = XLAT_PREBUILT_FLAGS,
+	.va_space_size = PLAT_VIRT_ADDR_SPACE_SIZE,
+	.pa_space_size = PLAT_PHY_ADDR_SPACE_SIZE,
+	.image_base = BL31_BASE,
+	.image_limit = BL31_LIMIT,
+	.max_regions = MAX_MMAP_REGIONS,
+	.max_tables = MAX_XLAT_TABLES,
+	.mmap_region_size = sizeof(mmap_region_t),
+};
+#endif
+
 void mmap_add_region(unsigned long long base_pa, uintptr_t base_va, size_t size,
 		     unsigned int attr)
 {
@@ -62,12 +84,52 @@ void mmap_add_alloc_va(mmap_region_t *mm)
 
 #if PLAT_XLAT_TABLES_DYNAMIC
 
+#if defined(IMAGE_BL31) || defined(IMAGE_BL32)
+/*
+ * The runtime images may add and remove dynamic regions of the default context
+ * from several CPUs at the same time, e.g. from SMC handlers. Only the primary
+ * CPU runs before the MMU is enabled, and exclusive accesses may not work then.
+ */
+static spinlock_t xlat_dynamic_lock;
+
+static bool xlat_dynamic_lock_acquire(void)
+{
+	if (!is_mmu_enabled_ctx(&tf_xlat_ctx)) {
+		return false;
+	}
+
+	spin_lock(&xlat_dynamic_lock);
+
+	return true;
+}
+
+static void xlat_dynamic_lock_release(bool locked)
+{
+	if (locked) {
+		spin_unlock(&xlat_dynamic_lock);
+	}
+}
+#else
+static inline bool xlat_dynamic_lock_acquire(void)
+{
+	return false;
+}
+
+static inline void xlat_dynamic_lock_release(bool locked)
+{
+}
+#endif /* defined(IMAGE_BL31) || defined(IMAGE_BL32) */
+
 int mmap_add_dynamic_region(unsigned long long base_pa, uintptr_t base_va,
 			    size_t size, unsigned int attr)
 {
 	mmap_region_t mm = MAP_REGION(base_pa, base_va, size, attr);
+	bool locked = xlat_dynamic_lock_acquire();
+	int rc = mmap_add_dynamic_region_ctx(&tf_xlat_ctx, &mm);
+
+	xlat_dynamic_lock_release(locked);
 
-	return mmap_add_dynamic_region_ctx(&tf_xlat_ctx, &mm);
+	return rc;
 }
 
 int mmap_add_dynamic_region_alloc_va(unsigned long long base_pa,
@@ -75,9 +137,11 @@ int mmap_add_dynamic_region_alloc_va(unsigned long long base_pa,
 				     unsigned int attr)
 {
 	mmap_region_t mm = MAP_REGION_ALLOC_VA(base_pa, size, attr);
-
+	bool locked = xlat_dynamic_lock_acquire();
 	int rc = mmap_add_dynamic_region_alloc_va_ctx(&tf_xlat_ctx, &mm);
 
+	xlat_dynamic_lock_release(locked);
+
 	*base_va = mm.base_va;
 
 	return rc;
@@ -86,14 +150,44 @@ int mmap_add_dynamic_region_alloc_va(unsigned long long base_pa,
 
 int mmap_remove_dynamic_region(uintptr_t base_va, size_t size)
 {
-	return mmap_remove_dynamic_region_ctx(&tf_xlat_ctx,
+	bool locked = xlat_dynamic_lock_acquire();
+	int rc = mmap_remove_dynamic_region_ctx(&tf_xlat_ctx,
 					base_va, size);
+
+	xlat_dynamic_lock_release(locked);
+
+	return rc;
+}
+
+int mmap_add_dynamic_regions(mmap_region_t *mm, unsigned int count)
+{
+	bool locked = xlat_dynamic_lock_acquire();
+	int rc = mmap_add_dynamic_regions_ctx(&tf_xlat_ctx, mm, count);
+
+	xlat_dynamic_lock_release(locked);
+
+	return rc;
+}
+
+int mmap_remove_dynamic_regions(const mmap_region_t *mm, unsigned int count)
+{
+	bool locked = xlat_dynamic_lock_acquire();
+	int rc = mmap_remove_dynamic_regions_ctx(&tf_xlat_ctx, mm, count);
+
+	xlat_dynamic_lock_release(locked);
+
+	return rc;
 }
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 void __init init_xlat_tables(void)
 {
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+	/* Time the initialisation, to compare it with XLAT_TABLES_PREBUILT */
+	uint64_t start = read_cntpct_el0();
+#endif
+
 	assert(tf_xlat_ctx.xlat_regime == EL_REGIME_INVALID);
 
 	unsigned int current_el = xlat_arch_current_el();
@@ -107,7 +201,16 @@ void __init init_xlat_tables(void)
 		tf_xlat_ctx.xlat_regime = EL3_REGIME;
 	}
 
+#if XLAT_TABLES_PREBUILT && defined(IMAGE_BL31)
+	init_xlat_tables_prebuilt_ctx(&tf_xlat_ctx, &xlat_tables_prebuilt);
+#else
 	init_xlat_tables_ctx(&tf_xlat_ctx);
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+	VERBOSE("Translation tables initialised in %llu system counter ticks\n",
+		(unsigned long long)(read_cntpct_el0() - start));
+#endif
 }
 
 int xlat_get_mem_attributes(uintptr_t base_va, uint32_t *attr)
@@ -17,6 +17,7 @@
 #include <common/debug.h>
 #include <lib/utils_def.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
+#include <lib/xlat_tables/xlat_tables_prebuilt.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 
 #include "xlat_tables_private.h"
@@ -352,7 +353,9 @@ static action_t xlat_tables_unmap_region_action(const mmap_region_t *mm,
 }
 /*
  * Recursive function that writes to the translation tables and unmaps the
- * specified region.
+ * specified region. It doesn't invalidate the TLB entries of the descriptors
+ * it removes, the caller must do it for the whole region afterwards with
+ * xlat_arch_tlbi_va_range().
  */
 static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 				     const uintptr_t table_base_va,
@@ -389,7 +392,6 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
 			table_base[table_idx] = INVALID_DESC;
-			xlat_arch_tlbi_va(table_idx_va, ctx->xlat_regime);
 
 		} else if (action == ACTION_RECURSE_INTO_TABLE) {
 
@@ -408,8 +410,6 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 			 */
 			if (xlat_table_is_empty(ctx, subtable)) {
 				table_base[table_idx] = INVALID_DESC;
-				xlat_arch_tlbi_va(table_idx_va,
-						  ctx->xlat_regime);
 			}
 
 		} else {
@@ -561,6 +561,52 @@ static action_t xlat_tables_map_region_action(const mmap_region_t *mm,
 	}
 }
 
+/*
+ * Returns true if the group of XLAT_CONTIG_ENTRIES descriptors that starts at
+ * table_idx can be written with the Contiguous bit set when mapping the
+ * specified region. The region must allow it, cover the whole group with a
+ * physical address aligned to the size of the group, and none of the
+ * descriptors of the group may be in use. In that case, all of them are
+ * written as block or page descriptors of this level while mapping the region.
+ */
+static bool xlat_tables_contig_group(const mmap_region_t *mm,
+				     uintptr_t table_base_va,
+				     const uint64_t *table_base,
+				     unsigned int table_entries,
+				     unsigned int table_idx,
+				     unsigned int level)
+{
+	unsigned long long group_size = XLAT_CONTIG_SIZE(level);
+	unsigned long long group_va, group_pa;
+
+	if (((mm->attr & MT_CONTIGUOUS) == 0U) ||
+	    ((table_idx & (XLAT_CONTIG_ENTRIES - 1U)) != 0U) ||
+	    ((table_idx + XLAT_CONTIG_ENTRIES) > table_entries)) {
+		return false;
+	}
+
+	group_va = (unsigned long long)table_base_va +
+		   ((unsigned long long)table_idx << XLAT_ADDR_SHIFT(level));
+	if ((group_va < mm->base_va) ||
+	    ((group_va + group_size - 1ULL) >
+	     ((unsigned long long)mm->base_va + mm->size - 1ULL))) {
+		return false;
+	}
+
+	group_pa = mm->base_pa + (group_va - mm->base_va);
+	if ((group_pa & (group_size - 1ULL)) != 0ULL) {
+		return false;
+	}
+
+	for (unsigned int i = 0U; i < XLAT_CONTIG_ENTRIES; i++) {
+		if ((table_base[table_idx + i] & DESC_MASK) != INVALID_DESC) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /*
  * Recursive function that writes to the translation tables and maps the
  * specified region. On success, it returns the VA of the last byte that was
@@ -584,6 +630,8 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 	uint64_t desc;
 
 	unsigned int table_idx;
+	/* Index of the first entry after the current contiguous group */
+	unsigned int contig_end_idx = 0U;
 
 	table_idx_va = xlat_tables_find_start_va(mm, table_base_va, level);
 	table_idx = xlat_tables_va_to_index(table_base_va, table_idx_va, level);
@@ -603,11 +651,24 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 			(uint32_t)(desc & DESC_MASK), table_idx_pa,
 			table_idx_va, level);
 
+		assert((table_idx >= contig_end_idx) ||
+		       (action == ACTION_WRITE_BLOCK_ENTRY));
+
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
-			table_base[table_idx] =
-				xlat_desc(ctx, (uint32_t)mm->attr, table_idx_pa,
-					  level);
+			if ((table_idx >= contig_end_idx) &&
+			    xlat_tables_contig_group(mm, table_base_va,
+						     table_base, table_entries,
+						     table_idx, level)) {
+				contig_end_idx = table_idx + XLAT_CONTIG_ENTRIES;
+			}
+
+			desc = xlat_desc(ctx, (uint32_t)mm->attr, table_idx_pa,
+					 level);
+			if (table_idx < contig_end_idx) {
+				desc |= UPPER_ATTRS(CONT_HINT);
+			}
+			table_base[table_idx] = desc;
 
 		} else if (action == ACTION_CREATE_NEW_TABLE) {
 			uintptr_t end_va;
@@ -771,9 +832,58 @@ static int mmap_add_region_check(const xlat_ctx_t *ctx, const mmap_region_t *mm)
 	return 0;
 }
 
+/*
+ * The mmap array is kept sorted by end VA and then by size, with the unused
+ * entries at the end (see mmap_add_region_ctx()). Returns the index of the
+ * first entry that goes after a region ending at end_va of the given size, that
+ * is, the index at which such a region is inserted, or at which it is found if
+ * it is already in the array.
+ */
+static unsigned int mmap_find_region_idx(const xlat_ctx_t *ctx,
+					 uintptr_t end_va, size_t size)
+{
+	unsigned int low = 0U;
+	unsigned int high = ctx->mmap_num;
+
+	while (low < high) {
+		unsigned int mid = low + ((high - low) / 2U);
+		const mmap_region_t *mm = &ctx->mmap[mid];
+		uintptr_t mm_end_va = mm->base_va + mm->size - 1U;
+
+		if ((mm->size != 0U) &&
+		    ((mm_end_va < end_va) ||
+		     ((mm_end_va == end_va) && (mm->size < size)))) {
+			low = mid + 1U;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+/* Returns the number of regions in the mmap array. */
+static unsigned int mmap_count_regions(const xlat_ctx_t *ctx)
+{
+	unsigned int low = 0U;
+	unsigned int high = ctx->mmap_num;
+
+	while (low < high) {
+		unsigned int mid = low + ((high - low) / 2U);
+
+		if (ctx->mmap[mid].size != 0U) {
+			low = mid + 1U;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
 void mmap_add_region_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
 {
-	mmap_region_t *mm_cursor = ctx->mmap, *mm_destination;
+	mmap_region_t *mm_cursor, *mm_destination;
 	const mmap_region_t *mm_end = ctx->mmap + ctx->mmap_num;
 	const mmap_region_t *mm_last;
 	unsigned long long end_pa = mm->base_pa + mm->size - 1U;
@@ -817,24 +927,12 @@ void mmap_add_region_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
 	 *
 	 * Overlapping is only allowed for static regions.
 	 */
-
-	while (((mm_cursor->base_va + mm_cursor->size - 1U) < end_va)
-	       && (mm_cursor->size != 0U)) {
-		++mm_cursor;
-	}
-
-	while (((mm_cursor->base_va + mm_cursor->size - 1U) == end_va) &&
-	       (mm_cursor->size != 0U) && (mm_cursor->size < mm->size)) {
-		++mm_cursor;
-	}
+	mm_cursor = &ctx->mmap[mmap_find_region_idx(ctx, end_va, mm->size)];
 
 	/*
 	 * Find the last entry marker in the mmap
 	 */
-	mm_last = ctx->mmap;
-	while ((mm_last->size != 0U) && (mm_last < mm_end)) {
-		++mm_last;
-	}
+	mm_last = &ctx->mmap[mmap_count_regions(ctx)];
 
 	/*
 	 * Check if we have enough space in the memory mapping table.
@@ -921,6 +1019,17 @@ static void mmap_alloc_va_align_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 		mm->base_va = round_up(mm->base_va, XLAT_BLOCK_SIZE(level));
 		return;
 	}
+
+	/*
+	 * Groups of pages of a region with MT_CONTIGUOUS can only use the
+	 * Contiguous bit if they are aligned to their size in VA as in PA.
+	 */
+	if (((mm->attr & MT_CONTIGUOUS) != 0U) &&
+	    ((mm->base_pa &
+	      (XLAT_CONTIG_SIZE(XLAT_TABLE_LEVEL_MAX) - 1ULL)) == 0ULL)) {
+		mm->base_va = round_up(mm->base_va,
+			(uintptr_t)XLAT_CONTIG_SIZE(XLAT_TABLE_LEVEL_MAX));
+	}
 }
 
 void mmap_add_region_alloc_va_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
@@ -949,10 +1058,17 @@ void mmap_add_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
 
 #if PLAT_XLAT_TABLES_DYNAMIC
 
-int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
+/*
+ * Adds a dynamic region to the mmap array and maps it if the translation
+ * tables are initialized. It doesn't wait for the new descriptors to be written
+ * to memory, the caller must do it with dsbishst().
+ */
+static int mmap_add_dynamic_region_no_sync(xlat_ctx_t *ctx,
+					   mmap_region_t *mm)
 {
-	mmap_region_t *mm_cursor = ctx->mmap;
-	const mmap_region_t *mm_last = mm_cursor + ctx->mmap_num;
+	mmap_region_t *mm_cursor;
+	unsigned int mm_idx;
+	unsigned int mm_count;
 	unsigned long long end_pa = mm->base_pa + mm->size - 1U;
 	uintptr_t end_va = mm->base_va + mm->size - 1U;
 	int ret;
@@ -972,27 +1088,20 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 	 * Find the adequate entry in the mmap array in the same way done for
 	 * static regions in mmap_add_region_ctx().
 	 */
-
-	while (((mm_cursor->base_va + mm_cursor->size - 1U) < end_va)
-	       && (mm_cursor->size != 0U)) {
-		++mm_cursor;
-	}
-
-	while (((mm_cursor->base_va + mm_cursor->size - 1U) == end_va) &&
-	       (mm_cursor->size != 0U) && (mm_cursor->size < mm->size)) {
-		++mm_cursor;
-	}
+	mm_idx = mmap_find_region_idx(ctx, end_va, mm->size);
+	mm_count = mmap_count_regions(ctx);
+	mm_cursor = &ctx->mmap[mm_idx];
 
 	/* Make room for new region by moving other regions up by one place */
 	(void)memmove(mm_cursor + 1U, mm_cursor,
-		     (uintptr_t)mm_last - (uintptr_t)mm_cursor);
+		      (mm_count - mm_idx) * sizeof(mmap_region_t));
 
 	/*
 	 * Check we haven't lost the empty sentinal from the end of the array.
 	 * This shouldn't happen as we have checked in mmap_add_region_check
 	 * that there is free space.
 	 */
-	assert(mm_last->size == 0U);
+	assert(ctx->mmap[ctx->mmap_num].size == 0U);
 
 	*mm_cursor = *mm;
 
@@ -1011,7 +1120,9 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 		/* Failed to map, remove mmap entry, unmap and return error. */
 		if (end_va != (mm_cursor->base_va + mm_cursor->size - 1U)) {
 			(void)memmove(mm_cursor, mm_cursor + 1U,
-				(uintptr_t)mm_last - (uintptr_t)mm_cursor);
+				(mm_count - mm_idx) * sizeof(mmap_region_t));
+			(void)memset(&ctx->mmap[mm_count], 0,
+				     sizeof(mmap_region_t));
 
 			/*
 			 * Check if the mapping function actually managed to map
@@ -1037,16 +1148,12 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 			xlat_clean_dcache_range((uintptr_t)ctx->base_table,
 				ctx->base_table_entries * sizeof(uint64_t));
 #endif
+			xlat_arch_tlbi_va_range(unmap_mm.base_va,
+						round_up(unmap_mm.size, PAGE_SIZE),
+						ctx->xlat_regime);
+			xlat_arch_tlbi_va_sync();
 			return -ENOMEM;
 		}
-
-		/*
-		 * Make sure that all entries are written to the memory. There
-		 * is no need to invalidate entries when mapping dynamic regions
-		 * because new table/block/page descriptors only replace old
-		 * invalid descriptors, that aren't TLB cached.
-		 */
-		dsbishst();
 	}
 
 	if (end_pa > ctx->max_pa)
@@ -1057,6 +1164,22 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 	return 0;
 }
 
+int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
+{
+	int ret = mmap_add_dynamic_region_no_sync(ctx, mm);
+
+	/*
+	 * Make sure that all entries are written to the memory. There is no
+	 * need to invalidate entries when mapping dynamic regions because new
+	 * table/block/page descriptors only replace old invalid descriptors,
+	 * that aren't TLB cached.
+	 */
+	if ((ret == 0) && ctx->initialized)
+		dsbishst();
+
+	return ret;
+}
+
 int mmap_add_dynamic_region_alloc_va_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 {
 	mm->base_va = ctx->max_va + 1UL;
@@ -1075,39 +1198,62 @@ int mmap_add_dynamic_region_alloc_va_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 }
 
 /*
- * Removes the region with given base Virtual Address and size from the given
- * context.
+ * Finds the region with given base Virtual Address and size in the mmap array
+ * and returns its index in 'mm_idx'.
  *
  * Returns:
  *        0: Success.
- *   EINVAL: Invalid values were used as arguments (region not found).
- *    EPERM: Tried to remove a static region.
+ *   EINVAL: The region wasn't found.
+ *    EPERM: The region is static.
  */
-int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
-				   size_t size)
+static int mmap_find_dynamic_region(const xlat_ctx_t *ctx, uintptr_t base_va,
+				    size_t size, unsigned int *mm_idx)
 {
-	mmap_region_t *mm = ctx->mmap;
-	const mmap_region_t *mm_last = mm + ctx->mmap_num;
-	int update_max_va_needed = 0;
-	int update_max_pa_needed = 0;
+	const mmap_region_t *mm;
 
 	/* Check sanity of mmap array. */
-	assert(mm[ctx->mmap_num].size == 0U);
+	assert(ctx->mmap[ctx->mmap_num].size == 0U);
 
-	while (mm->size != 0U) {
-		if ((mm->base_va == base_va) && (mm->size == size))
-			break;
-		++mm;
-	}
+	if (size == 0U)
+		return -EINVAL;
+
+	*mm_idx = mmap_find_region_idx(ctx, base_va + size - 1U, size);
+	mm = &ctx->mmap[*mm_idx];
 
 	/* Check that the region was found */
-	if (mm->size == 0U)
+	if ((mm->size != size) || (mm->base_va != base_va))
 		return -EINVAL;
 
 	/* If the region is static it can't be removed */
 	if ((mm->attr & MT_DYNAMIC) == 0U)
 		return -EPERM;
 
+	return 0;
+}
+
+/*
+ * Removes a dynamic region from the mmap array and unmaps it if the
+ * translation tables are initialized. It issues the TLB invalidations but
+ * doesn't wait for them to complete, the caller must do it with
+ * xlat_arch_tlbi_va_sync().
+ */
+static int mmap_remove_dynamic_region_no_sync(xlat_ctx_t *ctx,
+					      uintptr_t base_va, size_t size)
+{
+	mmap_region_t *mm;
+	unsigned int mm_idx;
+	unsigned int mm_count;
+	int update_max_va_needed = 0;
+	int update_max_pa_needed = 0;
+	int ret;
+
+	ret = mmap_find_dynamic_region(ctx, base_va, size, &mm_idx);
+	if (ret != 0)
+		return ret;
+
+	mm = &ctx->mmap[mm_idx];
+	mm_count = mmap_count_regions(ctx);
+
 	/* Check if this region is using the top VAs or PAs. */
 	if ((mm->base_va + mm->size - 1U) == ctx->max_va)
 		update_max_va_needed = 1;
@@ -1123,11 +1269,14 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 		xlat_clean_dcache_range((uintptr_t)ctx->base_table,
 			ctx->base_table_entries * sizeof(uint64_t));
 #endif
-		xlat_arch_tlbi_va_sync();
+		xlat_arch_tlbi_va_range(mm->base_va, mm->size,
+					ctx->xlat_regime);
 	}
 
 	/* Remove this region by moving the rest down by one place. */
-	(void)memmove(mm, mm + 1U, (uintptr_t)mm_last - (uintptr_t)mm);
+	(void)memmove(mm, mm + 1U,
+		      (mm_count - mm_idx - 1U) * sizeof(mmap_region_t));
+	(void)memset(&ctx->mmap[mm_count - 1U], 0, sizeof(mmap_region_t));
 
 	/* Check if we need to update the max VAs and PAs */
 	if (update_max_va_needed == 1) {
@@ -1153,6 +1302,93 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 	return 0;
 }
 
+/*
+ * Removes the region with given base Virtual Address and size from the given
+ * context.
+ *
+ * Returns:
+ *        0: Success.
+ *   EINVAL: Invalid values were used as arguments (region not found).
+ *    EPERM: Tried to remove a static region.
+ */
+int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
+				   size_t size)
+{
+	int ret = mmap_remove_dynamic_region_no_sync(ctx, base_va, size);
+
+	if ((ret == 0) && ctx->initialized)
+		xlat_arch_tlbi_va_sync();
+
+	return ret;
+}
+
+int mmap_add_dynamic_regions_ctx(xlat_ctx_t *ctx, mmap_region_t *mm,
+				 unsigned int count)
+{
+	unsigned int i;
+	int ret = 0;
+
+	for (i = 0U; i < count; i++) {
+		ret = mmap_add_dynamic_region_no_sync(ctx, &mm[i]);
+		if (ret != 0)
+			break;
+	}
+
+	if (ret != 0) {
+		/* Remove the regions added before the one that failed. */
+		while (i > 0U) {
+			i--;
+			if (mm[i].size != 0U) {
+				(void)mmap_remove_dynamic_region_no_sync(ctx,
+						mm[i].base_va, mm[i].size);
+			}
+		}
+
+		if (ctx->initialized)
+			xlat_arch_tlbi_va_sync();
+
+		return ret;
+	}
+
+	/* See mmap_add_dynamic_region_ctx(). */
+	if (ctx->initialized)
+		dsbishst();
+
+	return 0;
+}
+
+int mmap_remove_dynamic_regions_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm,
+				    unsigned int count)
+{
+	unsigned int mm_idx;
+	int ret;
+
+	/* Check all regions first so that either all or none are removed. */
+	for (unsigned int i = 0U; i < count; i++) {
+		ret = mmap_find_dynamic_region(ctx, mm[i].base_va, mm[i].size,
+					       &mm_idx);
+		if (ret != 0)
+			return ret;
+
+		for (unsigned int j = 0U; j < i; j++) {
+			if ((mm[j].base_va == mm[i].base_va) &&
+			    (mm[j].size == mm[i].size))
+				return -EINVAL;
+		}
+	}
+
+	for (unsigned int i = 0U; i < count; i++) {
+		ret = mmap_remove_dynamic_region_no_sync(ctx, mm[i].base_va,
+							 mm[i].size);
+		assert(ret == 0);
+	}
+
+	if (ctx->initialized)
+		xlat_arch_tlbi_va_sync();
+
+	return 0;
+}
+
 void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 			    uintptr_t va_max, struct mmap_region *mmap,
 			    unsigned int mmap_num, uint64_t **tables,
@@ -1185,7 +1421,56 @@ void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
-void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
+#if XLAT_TABLES_PREBUILT
+/*
+ * Write the descriptors of the translation tables generated at build time into
+ * the tables of the context, which must be empty.
+ */
+static void __init xlat_tables_install_prebuilt(xlat_ctx_t *ctx,
+				const struct xlat_prebuilt *prebuilt)
+{
+	assert(prebuilt->num_tables <= (unsigned int)ctx->tables_num);
+
+	for (unsigned int i = 0U; i < prebuilt->num_entries; i++) {
+		const struct xlat_prebuilt_entry *entry = &prebuilt->entries[i];
+		uint64_t desc = entry->desc;
+		uint64_t *table;
+
+		if (entry->table == XLAT_PREBUILT_BASE_TABLE) {
+			assert(entry->idx < ctx->base_table_entries);
+			table = ctx->base_table;
+		} else {
+			assert((entry->table < prebuilt->num_tables) &&
+			       (entry->idx < XLAT_TABLE_ENTRIES));
+			table = ctx->tables[entry->table];
+		}
+
+		if (desc == TABLE_DESC) {
+			assert(entry->subtable < prebuilt->num_tables);
+			desc |= (uintptr_t)ctx->tables[entry->subtable];
+		}
+
+		table[entry->idx] = desc;
+	}
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+	for (unsigned int i = 0U; i < prebuilt->num_tables; i++)
+		ctx->tables_mapped_regions[i] = prebuilt->mapped_regions[i];
+#else
+	ctx->next_table = (int)prebuilt->num_tables;
+#endif
+
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	xlat_clean_dcache_range((uintptr_t)ctx->base_table,
+				ctx->base_table_entries * sizeof(uint64_t));
+	xlat_clean_dcache_range((uintptr_t)ctx->tables,
+				prebuilt->num_tables * XLAT_TABLE_SIZE);
+#endif
+}
+#endif /* XLAT_TABLES_PREBUILT */
+
+static void __init xlat_tables_init_internal(xlat_ctx_t *ctx,
+				__unused const struct xlat_prebuilt *prebuilt)
 {
 	assert(ctx != NULL);
 	assert(!ctx->initialized);
@@ -1216,7 +1501,19 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 			ctx->tables[j][i] = INVALID_DESC;
 	}
 
+#if XLAT_TABLES_PREBUILT
+	if (prebuilt != NULL)
+		xlat_tables_install_prebuilt(ctx, prebuilt);
+#endif
+
 	while (mm->size != 0U) {
+#if XLAT_TABLES_PREBUILT
+		/* Already mapped by the prebuilt translation tables. */
+		if ((mm->attr & MT_PREBUILT) != 0U) {
+			mm++;
+			continue;
+		}
+#endif
 		uintptr_t end_va = xlat_tables_map_region(ctx, mm, 0U,
 				ctx->base_table, ctx->base_table_entries,
 				ctx->base_level);
@@ -1242,3 +1539,77 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 
 	xlat_tables_print(ctx);
 }
+
+void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
+{
+	xlat_tables_init_internal(ctx, NULL);
+}
+
+#if XLAT_TABLES_PREBUILT
+void __init init_xlat_tables_prebuilt_ctx(xlat_ctx_t *ctx,
+				const struct xlat_prebuilt *prebuilt)
+{
+	assert(ctx != NULL);
+	assert(!ctx->initialized);
+	/* The generated descriptors are only valid for these parameters. */
+	assert(ctx->xlat_regime == EL3_REGIME);
+	assert(prebuilt->flags == XLAT_PREBUILT_FLAGS);
+	assert(prebuilt->va_space_size ==
+	       ((unsigned long long)ctx->va_max_address + 1ULL));
+	assert(prebuilt->pa_space_size == (ctx->pa_max_address + 1ULL));
+
+	for (unsigned int i = 0U; i < prebuilt->num_regions; i++) {
+		mmap_region_t mm = prebuilt->mmap[i];
+		mmap_region_t *mm_cursor = &ctx->mmap[mmap_find_region_idx(ctx,
+					mm.base_va + mm.size - 1U, mm.size)];
+
+		/* The platform may also have added the region at run time. */
+		if ((mm_cursor->base_va == mm.base_va) &&
+		    (mm_cursor->size == mm.size) &&
+		    (mm_cursor->base_pa == mm.base_pa) &&
+		    (mm_cursor->attr == mm.attr) &&
+		    (mm_cursor->granularity == mm.granularity)) {
+			mm_cursor->attr |= MT_PREBUILT;
+			continue;
+		}
+
+		/*
+		 * The descriptors of the region are installed anyway, so this
+		 * can't be left to the assertion in mmap_add_region_ctx().
+		 */
+		mm.attr |= MT_PREBUILT;
+		if (mmap_add_region_check(ctx, &mm) != 0) {
+			ERROR("Prebuilt region conflicts with the memory map:\n"
+			      " VA:0x%lx  PA:0x%llx  size:0x%zx  attr:0x%x\n",
+			      mm.base_va, mm.base_pa, mm.size, mm.attr);
+			panic();
+		}
+		mmap_add_region_ctx(ctx, &mm);
+	}
+
+	/*
+	 * Prebuilt regions are mapped first, so they can't contain a region
+	 * that is mapped at run time.
+	 */
+	for (const mmap_region_t *mm = ctx->mmap; mm->size != 0U; mm++) {
+		if ((mm->attr & MT_PREBUILT) == 0U) {
+			continue;
+		}
+
+		for (const mmap_region_t *mm_cursor = ctx->mmap;
+		     mm_cursor->size != 0U; mm_cursor++) {
+			if (((mm_cursor->attr & MT_PREBUILT) == 0U) &&
+			    (mm_cursor->base_va >= mm->base_va) &&
+			    ((mm_cursor->base_va + mm_cursor->size) <=
+			     (mm->base_va + mm->size))) {
+				ERROR("Region nested in a prebuilt region:\n"
+				      " VA:0x%lx  size:0x%zx\n",
+				      mm_cursor->base_va, mm_cursor->size);
+				panic();
+			}
+		}
+	}
+
+	xlat_tables_init_internal(ctx, prebuilt);
+}
+#endif /* XLAT_TABLES_PREBUILT */
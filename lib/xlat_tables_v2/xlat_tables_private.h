@@ -38,6 +38,15 @@
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+#if XLAT_TABLES_PREBUILT
+/*
+ * Static region already mapped by the translation tables generated at build
+ * time, see XLAT_TABLES_PREBUILT.
+ */
+#define MT_PREBUILT_SHIFT	U(30)
+#define MT_PREBUILT		(U(1) << MT_PREBUILT_SHIFT)
+#endif /* XLAT_TABLES_PREBUILT */
+
 extern uint64_t mmu_cfg_params[MMU_CFG_PARAM_MAX];
 
 /* Determine the physical address space encoded in the 'attr' parameter. */
@@ -62,9 +71,20 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime);
  */
 void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime);
 
+/*
+ * Invalidate all TLB entries that match a virtual address in the range
+ * [va, va + size). It is equivalent to calling xlat_arch_tlbi_va() for every
+ * page of the range, but it uses TLBI range instructions when available.
+ * Otherwise, ranges of more than XLAT_TLBI_VA_MAX_PAGES pages invalidate all
+ * the TLB entries of the translation regime instead.
+ */
+void xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime);
+
+#define XLAT_TLBI_VA_MAX_PAGES	U(64)
+
 /*
  * This function has to be called at the end of any code that uses the function
- * xlat_arch_tlbi_va().
+ * xlat_arch_tlbi_va() or xlat_arch_tlbi_va_range().
  */
 void xlat_arch_tlbi_va_sync(void);
 
@@ -114,6 +114,10 @@ static void xlat_desc_print(const xlat_ctx_t *ctx, uint64_t desc)
 	printf(((LOWER_ATTRS(NS) & desc) != 0ULL) ? "-NS" : "-S");
 #endif
 
+	if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL) {
+		printf("-CONT");
+	}
+
 #ifdef __aarch64__
 	/* Check Guarded Page bit */
 	if ((desc & GP) != 0ULL) {
@@ -219,8 +223,41 @@ static void xlat_tables_print_internal(xlat_ctx_t *ctx, uintptr_t table_base_va,
 	}
 }
 
+/*
+ * Recursive function that counts the block and page descriptors of the
+ * translation tables passed as an argument, and how many of them have the
+ * Contiguous bit set.
+ */
+static void xlat_tables_count_descs(const uint64_t *table_base,
+		unsigned int table_entries, unsigned int level,
+		unsigned int *descs, unsigned int *contig_descs)
+{
+	for (unsigned int i = 0U; i < table_entries; i++) {
+		uint64_t desc = table_base[i];
+
+		if ((desc & DESC_MASK) == INVALID_DESC) {
+			continue;
+		}
+
+		if (((desc & DESC_MASK) == TABLE_DESC) &&
+		    (level < XLAT_TABLE_LEVEL_MAX)) {
+			xlat_tables_count_descs(
+				(uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK),
+				XLAT_TABLE_ENTRIES, level + 1U, descs,
+				contig_descs);
+			continue;
+		}
+
+		(*descs)++;
+		if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL) {
+			(*contig_descs)++;
+		}
+	}
+}
+
 void xlat_tables_print(xlat_ctx_t *ctx)
 {
+	unsigned int descs = 0U, contig_descs = 0U;
 	const char *xlat_regime_str;
 	int used_page_tables;
 
@@ -258,6 +295,16 @@ void xlat_tables_print(xlat_ctx_t *ctx)
 
 	xlat_tables_print_internal(ctx, 0U, ctx->base_table,
 				   ctx->base_table_entries, ctx->base_level);
+
+	/*
+	 * Each block or page descriptor needs its own TLB entry, except those
+	 * with the Contiguous bit set, which share one per group.
+	 */
+	xlat_tables_count_descs(ctx->base_table, ctx->base_table_entries,
+				ctx->base_level, &descs, &contig_descs);
+	VERBOSE("  TLB entries to cover all mappings: %u (%u without the Contiguous bit)\n",
+		descs - contig_descs + (contig_descs / XLAT_CONTIG_ENTRIES),
+		descs);
 }
 
 #endif /* LOG_LEVEL >= LOG_LEVEL_VERBOSE */
@@ -444,6 +491,44 @@ int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 }
 
 
+/*
+ * Clear the Contiguous bit of the group of level 3 descriptors that contains
+ * the page descriptor 'entry', which maps base_va. The TLBs may hold a single
+ * entry for the whole group, so all of its descriptors have to go through the
+ * break-before-make sequence.
+ */
+static void xlat_split_contig_group(const xlat_ctx_t *ctx, uint64_t *entry,
+				    uintptr_t base_va)
+{
+	uint64_t descs[XLAT_CONTIG_ENTRIES];
+	uint64_t *group = entry - (XLAT_TABLE_IDX(base_va, XLAT_TABLE_LEVEL_MAX) &
+				   (XLAT_CONTIG_ENTRIES - 1U));
+	uintptr_t group_va = base_va &
+		~(uintptr_t)(XLAT_CONTIG_SIZE(XLAT_TABLE_LEVEL_MAX) - 1ULL);
+
+	for (unsigned int i = 0U; i < XLAT_CONTIG_ENTRIES; i++) {
+		descs[i] = group[i];
+		assert((descs[i] & UPPER_ATTRS(CONT_HINT)) != 0ULL);
+		group[i] = INVALID_DESC;
+	}
+#if !HW_ASSISTED_COHERENCY
+	clean_dcache_range((uintptr_t)group, sizeof(descs));
+#endif
+
+	/* Also issues the barrier that makes the writes above visible. */
+	xlat_arch_tlbi_va_range(group_va,
+				(size_t)XLAT_CONTIG_SIZE(XLAT_TABLE_LEVEL_MAX),
+				ctx->xlat_regime);
+	xlat_arch_tlbi_va_sync();
+
+	for (unsigned int i = 0U; i < XLAT_CONTIG_ENTRIES; i++) {
+		group[i] = descs[i] & ~UPPER_ATTRS(CONT_HINT);
+	}
+#if !HW_ASSISTED_COHERENCY
+	clean_dcache_range((uintptr_t)group, sizeof(descs));
+#endif
+}
+
 int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size, uint32_t attr)
 {
@@ -562,6 +647,15 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 		 */
 		new_attr |= attr & (MT_RW | MT_EXECUTE_NEVER | MT_USER);
 
+		/*
+		 * The descriptors of a contiguous group must all have the same
+		 * attributes, so the page has to be removed from its group
+		 * first.
+		 */
+		if ((*entry & UPPER_ATTRS(CONT_HINT)) != 0ULL) {
+			xlat_split_contig_group(ctx, entry, base_va);
+		}
+
 		/*
 		 * The break-before-make sequence requires writing an invalid
 		 * descriptor and making sure that the system sees the change
@@ -617,3 +617,41 @@ define MAKE_DTBS
 dtbs: $(DTBS)
 all: dtbs
 endef
+
+# MAKE_FCONF_BIN converts a FW_CONFIG blob into the pre-parsed FCONF binary
+# format, see FCONF_BIN_CONFIG
+#   $(1) = input DTB
+#   $(2) = output binary config
+define MAKE_FCONF_BIN
+
+$(2): $(1) $${FCONF_BIN_TOOL}
+	$${ECHO} "  FCONF   $$@"
+	$$(Q)$${PYTHON} $${FCONF_BIN_TOOL} $$< -o $$@
+
+endef
+
+# MAKE_XLAT_PREBUILT generates the translation tables of the static regions of
+# BL31, see XLAT_TABLES_PREBUILT
+#   $(1) = object file defining the regions marked with XLAT_PREBUILT_MMAP
+#   $(2) = object file defining the translation context parameters
+#   $(3) = output C file
+# The sections are extracted from relocatable objects, so relocations are not
+# applied: a field holding the address of a symbol would read as 0. Fail the
+# build if the sections have any relocation.
+define MAKE_XLAT_PREBUILT
+
+$(3): $(1) $(2) | $${XLATTOOL}
+	$${ECHO} "  XLAT    $$@"
+	$$(Q)if $${OD} -r -j .rodata.xlat_prebuilt_mmap $(1) | grep -q "RELOCATION RECORDS"; then \
+		echo "ERROR: $(1): regions marked with XLAT_PREBUILT_MMAP must not use symbol addresses" >&2; \
+		exit 1; \
+	fi
+	$$(Q)if $${OD} -r -j .rodata.xlat_prebuilt_params $(2) | grep -q "RELOCATION RECORDS"; then \
+		echo "ERROR: $(2): xlat_prebuilt_params must not use symbol addresses" >&2; \
+		exit 1; \
+	fi
+	$$(Q)$${OC} -O binary -j .rodata.xlat_prebuilt_mmap $(1) $$(@:.c=_mmap.bin)
+	$$(Q)$${OC} -O binary -j .rodata.xlat_prebuilt_params $(2) $$(@:.c=_params.bin)
+	$$(Q)$${XLATTOOL} $$(@:.c=_params.bin) $$(@:.c=_mmap.bin) -o $$@
+
+endef
@@ -45,6 +45,10 @@ BL2_INV_DCACHE			:= 1
 # Select the branch protection features to use.
 BRANCH_PROTECTION		:= 0
 
+# Directory where the certificate generation tool caches the certificates, to
+# reuse them when their content does not change. Empty to disable the cache.
+CERT_CACHE_DIR			:=
+
 # By default, consider that the platform may release several CPUs out of reset.
 # The platform Makefile is free to override this value.
 COLD_BOOT_SINGLE_CPU		:= 0
@@ -56,6 +60,9 @@ COREBOOT			:= 0
 # For Chain of Trust
 CREATE_KEYS			:= 1
 
+# Reuse the image digests calculated during authentication for measured boot
+CRYPTO_DIGEST_CACHE		:= 0
+
 # Build flag to include AArch32 registers in cpu context save and restore during
 # world switch. This flag must be set to 0 for AArch64-only platforms.
 CTX_INCLUDE_AARCH32_REGS	:= 1
@@ -79,6 +86,10 @@ DEBUG				:= 0
 # By default disable authenticated decryption support.
 DECRYPTION_SUPPORT		:= none
 
+# Buffer the console output of the boot state in memory and send it to the
+# consoles at flush points. Default is 0.
+DEFERRED_CONSOLE		:= 0
+
 # Build platform
 DEFAULT_PLAT			:= fvp
 
@@ -117,6 +128,9 @@ ENABLE_RME			:= 0
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
+# Flag to hash images with the Armv8 SHA instructions when they are implemented
+ENABLE_SHA_CE			:= 0
+
 # Flag to enable stack corruption protection
 ENABLE_STACK_PROTECTOR		:= 0
 
@@ -255,6 +269,9 @@ PROGRAMMABLE_RESET_ADDRESS	:= 0
 # Flag used to choose the power state format: Extended State-ID or Original
 PSCI_EXTENDED_STATE_ID		:= 0
 
+# Build option to export the PSCI stats of all power domains with a single SMC
+PSCI_STAT_EXPORT		:= 0
+
 # Enable RAS support
 RAS_EXTENSION			:= 0
 
@@ -304,6 +321,13 @@ SPMC_AT_EL3			:= 0
 # Use SPM at S-EL2 as a default config for SPMD
 SPMD_SPM_AT_SEL2		:= 1
 
+# Let the SPMD switch the normal world EL1 context on every forwarded FF-A call.
+# Setting this to 1 is only valid when the S-EL2 SPMC preserves that context.
+SPMD_SKIP_NS_EL1_CTX		:= 0
+
+# Let the RMMD accept batches of RMI calls from the Normal world.
+RMMD_RMI_BATCH_SUPPORT		:= 0
+
 # Flag to introduce an infinite loop in BL1 just before it exits into the next
 # image. This is meant to help debugging the post-BL2 phase.
 SPIN_ON_BL1_EXIT		:= 0
@@ -317,9 +341,15 @@ USE_COHERENT_MEM		:= 1
 # Build option to add debugfs support
 USE_DEBUGFS			:= 0
 
+# Build option to add the per-CPU EL3 event trace
+EL3_TRACE			:= 0
+
 # Build option to fconf based io
 ARM_IO_IN_DTB			:= 0
 
+# Build option to pass FW_CONFIG in the pre-parsed FCONF binary format
+FCONF_BIN_CONFIG		:= 0
+
 # Build option to support SDEI through fconf
 SDEI_IN_FCONF			:= 0
 
@@ -336,6 +366,11 @@ USE_ROMLIB			:= 0
 # level makefile where we can check for incompatible features/build options.
 ALLOW_RO_XLAT_TABLES		:= 0
 
+# Build option to generate the translation tables of the static regions of
+# BL31 at build time. The platform names the source file of these regions in
+# XLAT_TABLES_PREBUILT_MMAP_SOURCE.
+XLAT_TABLES_PREBUILT		:= 0
+
 # Chain of trust.
 COT				:= tbbr
 
@@ -405,6 +440,11 @@ ENABLE_LTO			:= 0
 # Default is 0.
 CTX_INCLUDE_EL2_REGS		:= 0
 
+# Build flag to skip EL2 sysreg group saves/restores that are known to be
+# redundant when switching worlds. Requires CTX_INCLUDE_EL2_REGS.
+# Default is 0.
+CTX_LAZY_EL2_REGS		:= 0
+
 # Enable Memory tag extension which is supported for architecture greater
 # than Armv8.5-A
 # By default it is set to "no"
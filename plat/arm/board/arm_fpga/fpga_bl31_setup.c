@@ -234,7 +234,7 @@ static void fpga_dtb_update_clock(void *fdt, unsigned int freq)
 		return;
 	}
 
-	node = fdt_node_offset_by_phandle(fdt, phandle);
+	node = fdtw_node_offset_by_phandle(fdt, phandle);
 	if (node < 0) {
 		WARN("Cannot get phandle\n");
 
@@ -341,6 +341,9 @@ static void fpga_prepare_dtb(void)
 				FPGA_MAX_CPUS_PER_CLUSTER,
 				FPGA_MAX_CLUSTER_COUNT);
 
+	/* The GIC and clock fixups below only patch the DTB in place */
+	fdt_fixup_index(fdt);
+
 	if (err == -EEXIST) {
 		WARN("Not overwriting already existing /cpus node in DTB\n");
 	} else {
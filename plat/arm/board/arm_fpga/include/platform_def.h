@@ -85,4 +85,8 @@
 #define PLAT_FPGA_HOLD_STATE_WAIT	0
 #define PLAT_FPGA_HOLD_STATE_GO		1
 
+/* Size of the index of the DTB fixed up by BL31, see fdt_fixup_index() */
+#define PLAT_FCONF_FDT_INDEX_NODES	256
+#define PLAT_FCONF_FDT_INDEX_PHANDLES	64
+
 #endif
@@ -413,4 +413,13 @@
  */
 #define PLAT_DRTM_MMAP_ENTRIES			PLAT_ARM_MMAP_ENTRIES
 
+/*
+ * Size of the index of the HW_CONFIG DTB parsed by fconf in BL31, which has
+ * about 60 nodes and 20 phandles with the default topology.
+ */
+#ifdef IMAGE_BL31
+#define PLAT_FCONF_FDT_INDEX_NODES		128
+#define PLAT_FCONF_FDT_INDEX_PHANDLES		32
+#endif
+
 #endif /* PLATFORM_DEF_H */
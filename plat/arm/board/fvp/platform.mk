@@ -289,6 +289,13 @@ FVP_TOS_FW_CONFIG	:=	${BUILD_PLAT}/fdts/$(notdir $(basename ${ARM_SPMC_MANIFEST_
 $(eval $(call TOOL_ADD_PAYLOAD,${FVP_TOS_FW_CONFIG},--tos-fw-config,${FVP_TOS_FW_CONFIG}))
 endif
 
+ifeq (${FCONF_BIN_CONFIG},1)
+# Pack the FW_CONFIG in the pre-parsed binary format
+FVP_FW_CONFIG_BIN	:=	${BUILD_PLAT}/fdts/${PLAT}_fw_config.fconf
+$(eval $(call MAKE_FCONF_BIN,${FVP_FW_CONFIG},${FVP_FW_CONFIG_BIN}))
+FVP_FW_CONFIG		:=	${FVP_FW_CONFIG_BIN}
+endif
+
 # Add the FW_CONFIG to FIP and specify the same to certtool
 $(eval $(call TOOL_ADD_PAYLOAD,${FVP_FW_CONFIG},--fw-config,${FVP_FW_CONFIG}))
 # Add the TB_FW_CONFIG to FIP and specify the same to certtool
@@ -136,6 +136,12 @@ endif
 ENABLE_PSCI_STAT		:=	1
 ENABLE_PMF			:=	1
 
+# The PSCI stats export buffer is mapped on demand
+ifeq (${PSCI_STAT_EXPORT},1)
+PLAT_XLAT_TABLES_DYNAMIC	:=	1
+$(eval $(call add_define,PLAT_XLAT_TABLES_DYNAMIC))
+endif
+
 # Override the standard libc with optimised libc_asm
 OVERRIDE_LIBC			:=	1
 ifeq (${OVERRIDE_LIBC},1)
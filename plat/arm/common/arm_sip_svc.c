@@ -4,15 +4,25 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#include <platform_def.h>
+
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <drivers/arm/ethosn.h>
 #include <lib/debugfs.h>
+#include <lib/el3_trace/el3_trace.h>
+#if ENABLE_RME
+#include <lib/gpt_rme/gpt_rme.h>
+#endif
 #include <lib/pmf/pmf.h>
+#include <lib/psci/psci.h>
+#include <lib/xlat_tables/xlat_tables_compat.h>
 #include <plat/arm/common/arm_sip_svc.h>
 #include <plat/arm/common/plat_arm.h>
+#include <plat/common/platform.h>
 #include <tools_share/uuid.h>
 
 /* ARM SiP Service UUID */
@@ -37,6 +47,89 @@ static int arm_sip_setup(void)
 	return 0;
 }
 
+static bool arm_ns_dram_contains(uintptr_t base, uintptr_t end)
+{
+	if ((base >= ARM_NS_DRAM1_BASE) &&
+	    (end <= (ARM_NS_DRAM1_BASE + ARM_NS_DRAM1_SIZE - 1U))) {
+		return true;
+	}
+#ifdef __aarch64__
+	if ((base >= ARM_DRAM2_BASE) &&
+	    (end <= (ARM_DRAM2_BASE + ARM_DRAM2_SIZE - 1U))) {
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+/*
+ * Check that a buffer passed by the Normal world lies in Non-secure DRAM and,
+ * with RME, that all its granules are in the Non-secure PAS. Returns 0 if the
+ * buffer is valid, or -1 otherwise.
+ */
+int plat_validate_ns_region(uintptr_t base, size_t size)
+{
+	uintptr_t end = base + size - 1U;
+#if ENABLE_RME
+	unsigned int gpi;
+	uintptr_t pa;
+#endif
+
+	if ((size == 0U) || (end < base) || !arm_ns_dram_contains(base, end)) {
+		return -1;
+	}
+
+#if ENABLE_RME
+	for (pa = base & ~((uintptr_t)PAGE_SIZE_4KB - 1U); pa <= end;
+	     pa += PAGE_SIZE_4KB) {
+		if ((gpt_get_gpi(pa, &gpi) != 0) || (gpi != GPT_GPI_NS)) {
+			return -1;
+		}
+	}
+#endif
+
+	return 0;
+}
+
+#if PSCI_STAT_EXPORT
+/*
+ * Copy the PSCI stats of all power domains to the Non-secure buffer at 'pa'.
+ * Returns the status and the size needed for the export, so that the caller
+ * can size its buffer with a first call.
+ */
+static uintptr_t arm_sip_psci_stat_export(u_register_t pa, u_register_t size,
+					  void *handle)
+{
+	size_t export_size = psci_stat_export_size();
+	size_t map_size;
+	uintptr_t va;
+	int rc;
+
+	if ((size < export_size) || ((pa & PAGE_SIZE_MASK) != 0U)) {
+		SMC_RET2(handle, PSCI_E_INVALID_PARAMS, export_size);
+	}
+
+	map_size = round_up(export_size, PAGE_SIZE);
+
+	if (plat_validate_ns_region(pa, map_size) != 0) {
+		SMC_RET2(handle, PSCI_E_INVALID_ADDRESS, export_size);
+	}
+
+	/* Each call maps the buffer at its own VA */
+	rc = mmap_add_dynamic_region_alloc_va(pa, &va, map_size,
+					      MT_RW_DATA | MT_NS);
+	if (rc == 0) {
+		rc = psci_stat_export((void *)va, export_size);
+		(void)mmap_remove_dynamic_region(va, map_size);
+	} else {
+		rc = PSCI_E_INVALID_ADDRESS;
+	}
+
+	SMC_RET2(handle, rc, export_size);
+}
+#endif /* PSCI_STAT_EXPORT */
+
 /*
  * This function handles ARM defined SiP Calls
  */
@@ -73,6 +166,15 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 
 #endif /* USE_DEBUGFS */
 
+#if EL3_TRACE
+
+	if (is_el3_trace_fid(smc_fid)) {
+		return el3_trace_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					     handle, flags);
+	}
+
+#endif /* EL3_TRACE */
+
 #if ARM_ETHOSN_NPU_DRIVER
 
 	if (is_ethosn_fid(smc_fid)) {
@@ -83,6 +185,15 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 #endif /* ARM_ETHOSN_NPU_DRIVER */
 
 	switch (smc_fid) {
+#if PSCI_STAT_EXPORT
+	case ARM_SIP_SVC_PSCI_STAT_EXPORT:
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, PSCI_E_DENIED);
+
+		return arm_sip_psci_stat_export(x1, x2, handle);
+#endif /* PSCI_STAT_EXPORT */
+
 	case ARM_SIP_SVC_EXE_STATE_SWITCH: {
 		/* Execution state can be switched only if EL3 is AArch64 */
 #ifdef __aarch64__
@@ -114,6 +225,16 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 		/* State switch call */
 		call_count += 1;
 
+#if PSCI_STAT_EXPORT
+		/* PSCI stats export call */
+		call_count += 1;
+#endif /* PSCI_STAT_EXPORT */
+
+#if EL3_TRACE
+		/* EL3 trace call */
+		call_count += 1;
+#endif /* EL3_TRACE */
+
 		SMC_RET1(handle, call_count);
 
 	case ARM_SIP_SVC_UID:
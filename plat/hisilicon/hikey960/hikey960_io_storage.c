@@ -302,7 +302,7 @@ int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
 
 size_t ufs_read_lun3_blks(int lba, uintptr_t buf, size_t size)
 {
-	return ufs_read_blocks(3, lba, buf, size);
+	return ufs_read_blocks_queued(3, lba, buf, size);
 }
 
 size_t ufs_write_lun3_blks(int lba, const uintptr_t buf, size_t size)
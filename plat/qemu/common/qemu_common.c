@@ -9,6 +9,7 @@
 
 #include <arch_helpers.h>
 #include <common/bl_common.h>
+#include <lib/xlat_tables/xlat_tables_prebuilt.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
 
 #include <plat/common/platform.h>
@@ -88,7 +89,7 @@ static const mmap_region_t plat_qemu_mmap[] = {
 };
 #endif
 #ifdef IMAGE_BL31
-static const mmap_region_t plat_qemu_mmap[] = {
+static const mmap_region_t plat_qemu_mmap[] XLAT_PREBUILT_MMAP = {
 	MAP_SHARED_RAM,
 	MAP_DEVICE0,
 #ifdef MAP_DEVICE1
@@ -216,6 +216,9 @@ BL31_SOURCES		+=	plat/qemu/common/qemu_spmd_manifest.c
 endif
 endif
 
+# BL31 source file with the memory map used by XLAT_TABLES_PREBUILT
+XLAT_TABLES_PREBUILT_MMAP_SOURCE :=	${PLAT_QEMU_COMMON_PATH}/qemu_common.c
+
 # Add the build options to pack Trusted OS Extra1 and Trusted OS Extra2 images
 # in the FIP if the platform requires.
 ifneq ($(BL32_EXTRA1),)
@@ -40,7 +40,7 @@ static int drtm_event_log_measure_and_record(uintptr_t data_base,
 					     unsigned int pcr)
 {
 	int rc;
-	unsigned char hash_data[CRYPTO_MD_MAX_SIZE];
+	uint8_t *digest;
 	event_log_metadata_t metadata = {0};
 
 	metadata.name = event_name;
@@ -48,15 +48,17 @@ static int drtm_event_log_measure_and_record(uintptr_t data_base,
 
 	/*
 	 * Measure the payloads requested by D-CRTM and DCE commponents
-	 * Hash algorithm decided by the Event Log driver at build-time
+	 * Hash algorithm decided by the Event Log driver at build-time.
+	 * The digest is written straight into the EventLog buffer.
 	 */
-	rc = event_log_measure(data_base, data_size, hash_data);
+	digest = event_log_record_begin(event_type, &metadata);
+	rc = event_log_measure(data_base, data_size, digest);
 	if (rc != 0) {
 		return rc;
 	}
 
 	/* Record the mesasurement in the EventLog buffer */
-	event_log_record(hash_data, event_type, &metadata);
+	event_log_record_end(&metadata);
 
 	return 0;
 }
@@ -17,3 +17,9 @@ RMMD_SOURCES	+=	$(addprefix services/std_svc/rmmd/,	\
 
 # Let the top-level Makefile know that we intend to include RMM image
 NEED_RMM	:=	yes
+
+ifeq (${RMMD_RMI_BATCH_SUPPORT},1)
+# The batch page is mapped on demand for the duration of the call
+PLAT_XLAT_TABLES_DYNAMIC :=	1
+$(eval $(call add_define,PLAT_XLAT_TABLES_DYNAMIC))
+endif
@@ -275,6 +275,173 @@ static uint64_t	rmmd_smc_forward(uint32_t src_sec_state,
 	SMC_RET5(ctx, x0, x1, x2, x3, x4);
 }
 
+#if RMMD_RMI_BATCH_SUPPORT
+CASSERT(sizeof(rmi_batch_entry_t) == RMI_BATCH_ENTRY_SIZE,
+	assert_rmi_batch_entry_size_mismatch);
+CASSERT(sizeof(rmi_batch_page_t) <= RMI_BATCH_PAGE_SIZE,
+	assert_rmi_batch_page_size_mismatch);
+
+/*******************************************************************************
+ * Copy entry 'idx' of the batch page mapped at 'batch' to 'entry' if 'copy_in'
+ * is true, or the results of 'entry' back to the page otherwise. The page is
+ * only accessed with the GPT lock held: a request of the batch, or a delegation
+ * on another CPU, could otherwise move it out of the Non-secure PAS while EL3
+ * is accessing it.
+ ******************************************************************************/
+static int rmi_batch_copy(uint64_t batch_pa, rmi_batch_page_t *batch,
+			  uint64_t idx, rmi_batch_entry_t *entry, bool copy_in)
+{
+	if (gpt_lock_ns_granule(batch_pa) != 0) {
+		return E_RMM_BAD_PAS;
+	}
+
+	if (copy_in) {
+		(void)memcpy(entry, &batch->entries[idx], sizeof(*entry));
+	} else {
+		(void)memcpy(batch->entries[idx].ret, entry->ret,
+			     sizeof(entry->ret));
+	}
+
+	gpt_unlock_ns_granule();
+
+	return E_RMM_OK;
+}
+
+/*******************************************************************************
+ * Forward the RMI requests queued in the Non-secure page at 'batch_pa' to the
+ * RMM one after the other. The Normal world and Realm system register contexts
+ * are switched once for the whole batch, the RMM is then entered synchronously
+ * for each request and returns through RMM_RMI_REQ_COMPLETE. Each request is
+ * copied to the stack just before it is forwarded, and its results are written
+ * back right after.
+ ******************************************************************************/
+static uint64_t rmmd_rmi_batch(uint64_t batch_pa, void *handle)
+{
+	rmmd_rmm_context_t *ctx = &rmm_context[plat_my_core_pos()];
+	gp_regs_t *gpregs = get_gpregs_ctx(&ctx->cpu_ctx);
+	rmi_batch_entry_t entry;
+	rmi_batch_page_t *batch;
+	uintptr_t batch_va;
+	uint64_t count, done = 0ULL;
+	unsigned int i;
+	int ret;
+
+	if ((batch_pa & (RMI_BATCH_PAGE_SIZE - 1U)) != 0ULL) {
+		SMC_RET2(handle, E_RMM_BAD_ADDR, 0ULL);
+	}
+
+	ret = mmap_add_dynamic_region_alloc_va(batch_pa, &batch_va,
+					       RMI_BATCH_PAGE_SIZE,
+					       MT_RW_DATA | MT_NS);
+	if (ret != 0) {
+		WARN("RMMD: Failed to map RMI batch page (%d)\n", ret);
+		SMC_RET2(handle, E_RMM_NOMEM, 0ULL);
+	}
+
+	batch = (rmi_batch_page_t *)batch_va;
+
+	if (gpt_lock_ns_granule(batch_pa) != 0) {
+		ret = E_RMM_BAD_PAS;
+		goto unmap;
+	}
+	count = batch->count;
+	gpt_unlock_ns_granule();
+
+	if (count > RMI_BATCH_MAX_ENTRIES) {
+		ret = E_RMM_INVAL;
+		goto unmap;
+	}
+
+	/* Leave the Normal world once for the whole batch */
+	cm_el1_sysregs_context_save(NON_SECURE);
+	cm_el2_sysregs_context_save(NON_SECURE);
+	cm_el1_sysregs_context_restore(REALM);
+	cm_el2_sysregs_context_restore(REALM);
+
+	ctx->rmi_batch_active = true;
+
+	ret = E_RMM_OK;
+	for (done = 0ULL; done < count; done++) {
+		ret = rmi_batch_copy(batch_pa, batch, done, &entry, true);
+		if (ret != E_RMM_OK) {
+			break;
+		}
+
+		if (!is_rmi_fid(entry.fid) ||
+		    (entry.fid == RMM_RMI_REQ_COMPLETE)) {
+			ret = E_RMM_INVAL;
+			break;
+		}
+
+		write_ctx_reg(gpregs, CTX_GPREG_X0, entry.fid);
+		for (i = 0U; i < RMI_BATCH_NUM_ARGS; i++) {
+			write_ctx_reg(gpregs, CTX_GPREG_X1 + (i << 3),
+				      entry.args[i]);
+		}
+
+		cm_set_next_eret_context(REALM);
+		(void)rmmd_rmm_enter(&ctx->c_rt_ctx);
+
+		for (i = 0U; i < RMI_BATCH_NUM_RETS; i++) {
+			entry.ret[i] = read_ctx_reg(gpregs,
+						    CTX_GPREG_X1 + (i << 3));
+		}
+
+		/*
+		 * The request was forwarded even if its results can't be
+		 * written back, e.g. if it delegated the batch page.
+		 */
+		ret = rmi_batch_copy(batch_pa, batch, done, &entry, false);
+		if (ret != E_RMM_OK) {
+			done++;
+			break;
+		}
+	}
+
+	ctx->rmi_batch_active = false;
+
+	/* Return to the Normal world */
+	cm_el1_sysregs_context_save(REALM);
+	cm_el2_sysregs_context_save(REALM);
+	cm_el1_sysregs_context_restore(NON_SECURE);
+	cm_el2_sysregs_context_restore(NON_SECURE);
+	cm_set_next_eret_context(NON_SECURE);
+
+unmap:
+	if (mmap_remove_dynamic_region(batch_va, RMI_BATCH_PAGE_SIZE) != 0) {
+		assert(false);
+	}
+
+	SMC_RET2(handle, ret, done);
+}
+
+/*******************************************************************************
+ * This function handles the Vendor Specific EL3 Monitor SMCs. RMMD_RMI_BATCH is
+ * the only one of them, and may only be invoked by the Normal world.
+ ******************************************************************************/
+static uintptr_t rmmd_ven_el3_handler(uint32_t smc_fid, u_register_t x1,
+				      u_register_t x2, u_register_t x3,
+				      u_register_t x4, void *cookie,
+				      void *handle, u_register_t flags)
+{
+	if (rmm_boot_failed || (smc_fid != RMMD_RMI_BATCH) ||
+	    (caller_sec_state(flags) != SMC_FROM_NON_SECURE)) {
+		SMC_RET1(handle, SMC_UNK);
+	}
+
+	return rmmd_rmi_batch(x1, handle);
+}
+
+DECLARE_RT_SVC(
+	rmmd_ven_el3,
+	OEN_VEN_EL3_START,
+	OEN_VEN_EL3_END,
+	SMC_TYPE_FAST,
+	NULL,
+	rmmd_ven_el3_handler
+);
+#endif /* RMMD_RMI_BATCH_SUPPORT */
+
 /*******************************************************************************
  * This function handles all SMCs in the range reserved for RMI. Each call is
  * either forwarded to the other security state or handled by the RMM dispatcher
@@ -318,6 +485,13 @@ uint64_t rmmd_rmi_handler(uint32_t smc_fid, uint64_t x1, uint64_t x2,
 	case RMM_RMI_REQ_COMPLETE: {
 		uint64_t x5 = SMC_GET_GP(handle, CTX_GPREG_X5);
 
+#if RMMD_RMI_BATCH_SUPPORT
+		/* Return to the batch loop, results are read from the context */
+		if (rmm_context[plat_my_core_pos()].rmi_batch_active) {
+			rmmd_rmm_sync_exit(0ULL);
+		}
+#endif
+
 		return rmmd_smc_forward(REALM, NON_SECURE, x1,
 					x2, x3, x4, x5, handle);
 	}
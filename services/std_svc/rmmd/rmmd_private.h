@@ -30,6 +30,7 @@
 #define RMMD_C_RT_CTX_ENTRIES		(RMMD_C_RT_CTX_SIZE >> DWORD_SHIFT)
 
 #ifndef __ASSEMBLER__
+#include <stdbool.h>
 #include <stdint.h>
 
 /*
@@ -39,6 +40,9 @@
 typedef struct rmmd_rmm_context {
 	uint64_t c_rt_ctx;
 	cpu_context_t cpu_ctx;
+#if RMMD_RMI_BATCH_SUPPORT
+	bool rmi_batch_active;
+#endif
 } rmmd_rmm_context_t;
 
 /* Functions used to enter/exit the RMM synchronously */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -12,6 +12,23 @@
 
 #define MAP_OFF(_map, _mapping) ((_map) - (_mapping)->map)
 
+/*
+ * Interrupt IDs below this value are looked up through sdei_intr_index. This
+ * covers the SGIs, PPIs and SPIs, but not the extended PPI and SPI ranges,
+ * which fall back to a linear search.
+ */
+#define SDEI_INTR_INDEX_SIZE	1020U
+
+/*
+ * Index of the mapping bound to each interrupt, plus one, in the private or
+ * shared mapping array. 0 means that no mapping is bound to the interrupt, or
+ * that the index doesn't fit, in which case the mappings are searched.
+ */
+static uint8_t sdei_intr_index[SDEI_INTR_INDEX_SIZE];
+
+/* Whether each mapping array is sorted by event number, as it should be */
+static bool sdei_mapping_sorted[SDEI_MAP_IDX_MAX_];
+
 /*
  * Get SDEI entry with the given mapping: on success, returns pointer to SDEI
  * entry. On error, returns NULL.
@@ -52,20 +69,65 @@ sdei_entry_t *get_event_entry(sdei_ev_map_t *map)
 }
 
 /*
- * Find event mapping for a given interrupt number: On success, returns pointer
- * to the event mapping. On error, returns NULL.
+ * Record in the interrupt index that a mapping is bound to its interrupt, or
+ * that it no longer is. Mappings that don't fit in the index are left to the
+ * linear search.
  */
-sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
+void sdei_intr_index_update(sdei_ev_map_t *map, bool bound)
+{
+	const sdei_mapping_t *mapping;
+	long int idx;
+
+	if ((map->intr == SDEI_DYN_IRQ) || (map->intr >= SDEI_INTR_INDEX_SIZE))
+		return;
+
+	mapping = is_event_private(map) ? SDEI_PRIVATE_MAPPING() :
+		SDEI_SHARED_MAPPING();
+	idx = MAP_OFF(map, mapping);
+
+	if (bound) {
+		if (idx < UINT8_MAX)
+			sdei_intr_index[map->intr] = (uint8_t) (idx + 1);
+	} else if (sdei_intr_index[map->intr] == (uint8_t) (idx + 1)) {
+		sdei_intr_index[map->intr] = 0U;
+	}
+}
+
+/*
+ * Build the lookup indices from the platform mappings. Called once at
+ * initialisation, interrupts bound later are added by SDEI_INTERRUPT_BIND.
+ */
+void sdei_index_init(void)
+{
+	const sdei_mapping_t *mapping;
+	sdei_ev_map_t *map;
+	unsigned int i, j;
+
+	for_each_mapping_type(i, mapping) {
+		sdei_mapping_sorted[i] = true;
+		iterate_mapping(mapping, j, map) {
+			if ((j > 0U) && (map->ev_num <= map[-1].ev_num))
+				sdei_mapping_sorted[i] = false;
+
+			/*
+			 * Explicit events and free dynamic slots have no
+			 * interrupt, and are skipped.
+			 */
+			sdei_intr_index_update(map, true);
+		}
+
+		if (!sdei_mapping_sorted[i])
+			WARN("SDEI: mappings not sorted by event number\n");
+	}
+}
+
+static sdei_ev_map_t *find_event_map_by_intr_linear(unsigned int intr_num,
+		bool shared)
 {
 	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
 	unsigned int i;
 
-	/*
-	 * Look for a match in private and shared mappings, as requested. This
-	 * is a linear search. However, if the mappings are required to be
-	 * sorted, for large maps, we could consider binary search.
-	 */
 	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
 	iterate_mapping(mapping, i, map) {
 		if (map->intr == intr_num)
@@ -75,6 +137,45 @@ sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
 	return NULL;
 }
 
+/*
+ * Find event mapping for a given interrupt number: On success, returns pointer
+ * to the event mapping. On error, returns NULL.
+ */
+sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
+{
+	const sdei_mapping_t *mapping;
+	sdei_ev_map_t *map;
+	unsigned int idx;
+
+	/* Free dynamic slots and interrupts out of the index are searched */
+	if ((intr_num == SDEI_DYN_IRQ) || (intr_num >= SDEI_INTR_INDEX_SIZE))
+		return find_event_map_by_intr_linear(intr_num, shared);
+
+	idx = sdei_intr_index[intr_num];
+	if (idx == 0U) {
+		/* Mapping arrays too large for the index are searched too */
+		mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
+		if (mapping->num_maps >= UINT8_MAX)
+			return find_event_map_by_intr_linear(intr_num, shared);
+
+		return NULL;
+	}
+
+	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
+	if (idx > mapping->num_maps)
+		return NULL;
+
+	/*
+	 * The interrupt may have been released and bound to another event
+	 * since the index was read, so check the mapping itself.
+	 */
+	map = &mapping->map[idx - 1U];
+	if (map->intr != intr_num)
+		return NULL;
+
+	return map;
+}
+
 /*
  * Find event mapping for a given event number: On success returns pointer to
  * the event mapping. On error, returns NULL.
@@ -84,16 +185,33 @@ sdei_ev_map_t *find_event_map(int ev_num)
 	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
 	unsigned int i, j;
+	size_t lo, hi, mid;
 
 	/*
-	 * Iterate through mappings to find a match. This is a linear search.
-	 * However, if the mappings are required to be sorted, for large maps,
-	 * we could consider binary search.
+	 * The mappings are required to be sorted by event number, so look for
+	 * the event by binary search in each of them.
 	 */
 	for_each_mapping_type(i, mapping) {
-		iterate_mapping(mapping, j, map) {
+		if (!sdei_mapping_sorted[i]) {
+			iterate_mapping(mapping, j, map) {
+				if (map->ev_num == ev_num)
+					return map;
+			}
+			continue;
+		}
+
+		lo = 0U;
+		hi = mapping->num_maps;
+		while (lo < hi) {
+			mid = lo + ((hi - lo) / 2U);
+			map = &mapping->map[mid];
 			if (map->ev_num == ev_num)
 				return map;
+
+			if (map->ev_num < ev_num)
+				lo = mid + 1U;
+			else
+				hi = mid;
 		}
 	}
 
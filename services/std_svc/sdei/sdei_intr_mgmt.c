@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -17,6 +17,8 @@
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <lib/cassert.h>
+#include <lib/pmf/pmf.h>
+#include <lib/runtime_instr.h>
 #include <services/sdei.h>
 
 #include "sdei_private.h"
@@ -417,6 +419,12 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 	jmp_buf dispatch_jmp;
 	const uint64_t mpidr = read_mpidr_el1();
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_ENTER_SDEI_INTR,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
 	/*
 	 * To handle an event, the following conditions must be true:
 	 *
@@ -549,6 +557,14 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 
 	/* Synchronously dispatch event */
 	setup_ns_dispatch(map, se, ctx, &dispatch_jmp);
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	/* The next ERET enters the client handler */
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_EXIT_SDEI_INTR,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
 	begin_sdei_synchronous_dispatch(&dispatch_jmp);
 
 	/*
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -232,6 +232,8 @@ void init_sdei_state(void);
 
 sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared);
 sdei_ev_map_t *find_event_map(int ev_num);
+void sdei_index_init(void);
+void sdei_intr_index_update(sdei_ev_map_t *map, bool bound);
 sdei_entry_t *get_event_entry(sdei_ev_map_t *map);
 
 int64_t sdei_event_context(void *handle, unsigned int param);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -603,6 +603,12 @@ static uint64_t rxtx_map_handler(uint32_t smc_fid,
 	uintptr_t rx_address = x2;
 	uint32_t page_count = x3 & FFA_RXTX_PAGE_COUNT_MASK; /* Bits [5:0] */
 	uint32_t buf_size = page_count * FFA_PAGE_SIZE;
+	mmap_region_t rxtx_regions[] = {
+		MAP_REGION_FLAT(tx_address, buf_size,
+				mem_atts | MT_RO_DATA | MT_CONTIGUOUS),
+		MAP_REGION_FLAT(rx_address, buf_size,
+				mem_atts | MT_RW_DATA | MT_CONTIGUOUS),
+	};
 
 	/*
 	 * The SPMC does not support mapping of VM RX/TX pairs to facilitate
@@ -652,31 +658,13 @@ static uint64_t rxtx_map_handler(uint32_t smc_fid,
 		goto err;
 	}
 
-	/* memmap the TX buffer as read only. */
-	ret = mmap_add_dynamic_region(tx_address, /* PA */
-			tx_address, /* VA */
-			buf_size, /* size */
-			mem_atts | MT_RO_DATA); /* attrs */
+	/* memmap the TX buffer as read only and the RX buffer as read write. */
+	ret = mmap_add_dynamic_regions(rxtx_regions, ARRAY_SIZE(rxtx_regions));
 	if (ret != 0) {
 		/* Return the correct error code. */
 		error_code = (ret == -ENOMEM) ? FFA_ERROR_NO_MEMORY :
 						FFA_ERROR_INVALID_PARAMETER;
-		WARN("Unable to map TX buffer: %d\n", error_code);
-		goto err;
-	}
-
-	/* memmap the RX buffer as read write. */
-	ret = mmap_add_dynamic_region(rx_address, /* PA */
-			rx_address, /* VA */
-			buf_size, /* size */
-			mem_atts | MT_RW_DATA); /* attrs */
-
-	if (ret != 0) {
-		error_code = (ret == -ENOMEM) ? FFA_ERROR_NO_MEMORY :
-						FFA_ERROR_INVALID_PARAMETER;
-		WARN("Unable to map RX buffer: %d\n", error_code);
-		/* Unmap the TX buffer again. */
-		mmap_remove_dynamic_region(tx_address, buf_size);
+		WARN("Unable to map RX/TX buffers: %d\n", error_code);
 		goto err;
 	}
 
@@ -724,20 +712,18 @@ static uint64_t rxtx_unmap_handler(uint32_t smc_fid,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
 
-	/* Unmap RX Buffer */
-	if (mmap_remove_dynamic_region((uintptr_t) mbox->rx_buffer,
-				       buf_size) != 0) {
-		WARN("Unable to unmap RX buffer!\n");
-	}
+	/* Unmap RX and TX Buffers */
+	mmap_region_t rxtx_regions[] = {
+		MAP_REGION_FLAT((uintptr_t)mbox->rx_buffer, buf_size, 0U),
+		MAP_REGION_FLAT((uintptr_t)mbox->tx_buffer, buf_size, 0U),
+	};
 
-	mbox->rx_buffer = 0;
-
-	/* Unmap TX Buffer */
-	if (mmap_remove_dynamic_region((uintptr_t) mbox->tx_buffer,
-				       buf_size) != 0) {
-		WARN("Unable to unmap TX buffer!\n");
+	if (mmap_remove_dynamic_regions(rxtx_regions,
+					ARRAY_SIZE(rxtx_regions)) != 0) {
+		WARN("Unable to unmap RX/TX buffers!\n");
 	}
 
+	mbox->rx_buffer = 0;
 	mbox->tx_buffer = 0;
 	mbox->rxtx_page_count = 0;
 
@@ -1782,6 +1768,7 @@ int32_t spmc_setup(void)
 		return ret;
 	}
 	memset(spmc_shmem_obj_state.data, 0, spmc_shmem_obj_state.data_size);
+	spmc_shmem_obj_state_init(&spmc_shmem_obj_state);
 
 	/* Setup logical SPs. */
 	ret = logical_sp_init();
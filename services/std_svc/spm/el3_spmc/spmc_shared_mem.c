@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -19,6 +19,20 @@
 
 /**
  * struct spmc_shmem_obj - Shared memory object.
+ * @order:          The object lives in a block of the datastore of
+ *                  SPMC_SHMEM_BLOCK_MIN << @order bytes.
+ * @is_free:        Set while the block is on the free list of its order.
+ * @next_free:      Next free block of the same order.
+ * @prev_free:      Previous free block of the same order.
+ * @lock:           Serialises the FF-A calls operating on the object.
+ * @refs:           Number of CPUs between spmc_shmem_obj_get() or
+ *                  spmc_shmem_obj_new() and spmc_shmem_obj_put().
+ * @handle:         Handle the object is looked up with, 0 until the first
+ *                  fragment has been received and for temporary objects.
+ * @complete:       The whole descriptor has been received and validated, so
+ *                  @desc no longer changes.
+ * @removed:        The object can no longer be looked up and is freed once
+ *                  @refs drops to 0.
  * @desc_size:      Size of @desc.
  * @desc_filled:    Size of @desc already received.
  * @in_use:         Number of clients that have called ffa_mem_retrieve_req
@@ -26,12 +40,25 @@
  * @desc:           FF-A memory region descriptor passed in ffa_mem_share.
  */
 struct spmc_shmem_obj {
+	uint32_t order;
+	bool is_free;
+	struct spmc_shmem_obj *next_free;
+	struct spmc_shmem_obj *prev_free;
+	spinlock_t lock;
+	unsigned int refs;
+	uint64_t handle;
+	bool complete;
+	bool removed;
 	size_t desc_size;
 	size_t desc_filled;
 	size_t in_use;
 	struct ffa_mtd desc;
 };
 
+/* Smallest block of the datastore */
+#define SPMC_SHMEM_BLOCK_MIN_SHIFT	U(7)
+#define SPMC_SHMEM_BLOCK_MIN		(U(1) << SPMC_SHMEM_BLOCK_MIN_SHIFT)
+
 /*
  * Declare our data structure to store the metadata of memory share requests.
  * The main datastore is allocated on a per platform basis to ensure enough
@@ -56,6 +83,130 @@ static size_t spmc_shmem_obj_size(size_t desc_size)
 	return desc_size + offsetof(struct spmc_shmem_obj, desc);
 }
 
+/**
+ * spmc_shmem_block_size - Size of a block of the datastore.
+ * @order:      Order of the block.
+ *
+ * Return: Size of the block in bytes.
+ */
+static size_t spmc_shmem_block_size(uint32_t order)
+{
+	return (size_t)SPMC_SHMEM_BLOCK_MIN << order;
+}
+
+static void spmc_shmem_free_list_add(struct spmc_shmem_obj_state *state,
+				     struct spmc_shmem_obj *blk, uint32_t order)
+{
+	struct spmc_shmem_obj *head = state->free_list[order];
+
+	blk->order = order;
+	blk->is_free = true;
+	blk->prev_free = NULL;
+	blk->next_free = head;
+	if (head != NULL) {
+		head->prev_free = blk;
+	}
+	state->free_list[order] = blk;
+}
+
+static void spmc_shmem_free_list_del(struct spmc_shmem_obj_state *state,
+				     struct spmc_shmem_obj *blk)
+{
+	if (blk->prev_free != NULL) {
+		blk->prev_free->next_free = blk->next_free;
+	} else {
+		state->free_list[blk->order] = blk->next_free;
+	}
+	if (blk->next_free != NULL) {
+		blk->next_free->prev_free = blk->prev_free;
+	}
+	blk->is_free = false;
+}
+
+/**
+ * spmc_shmem_obj_state_init - Prepare the datastore for allocations.
+ * @state:      Global state, with @state->data and @state->data_size set.
+ *
+ * The datastore is managed as a buddy allocator: it is carved into the largest
+ * naturally aligned power of two blocks that fit, which are split on
+ * allocation and merged back with their buddy on free. Objects never move, and
+ * the part of the datastore that does not fill a minimum block is left unused.
+ */
+void spmc_shmem_obj_state_init(struct spmc_shmem_obj_state *state)
+{
+	uintptr_t base = round_up((uintptr_t)state->data, sizeof(uint64_t));
+	size_t offset = 0U;
+	uint32_t order;
+
+	if ((state->data == NULL) ||
+	    (state->data_size < (base - (uintptr_t)state->data))) {
+		state->data_size = 0U;
+		return;
+	}
+
+	state->data_size -= base - (uintptr_t)state->data;
+	state->data_size &= ~(size_t)(SPMC_SHMEM_BLOCK_MIN - 1U);
+	state->data = (uint8_t *)base;
+	state->allocated = 0U;
+
+	for (order = SPMC_SHMEM_BLOCK_ORDERS; order-- > 0U;) {
+		state->free_list[order] = NULL;
+		while ((state->data_size - offset) >=
+		       spmc_shmem_block_size(order)) {
+			spmc_shmem_free_list_add(state,
+				(struct spmc_shmem_obj *)(state->data + offset),
+				order);
+			offset += spmc_shmem_block_size(order);
+		}
+	}
+}
+
+/**
+ * spmc_shmem_obj_report - Print the fragmentation of the datastore.
+ * @state:      Global state.
+ *
+ * Internal fragmentation is the part of the allocated blocks not used by the
+ * objects they hold, external fragmentation shows as free space spread over
+ * blocks too small for a given request.
+ */
+static void spmc_shmem_obj_report(struct spmc_shmem_obj_state *state)
+{
+	struct spmc_shmem_obj *blk;
+	size_t offset = 0U;
+	size_t used = 0U;
+	size_t largest = 0U;
+	unsigned int objs = 0U;
+	unsigned int count;
+	uint32_t order;
+
+	while (offset < state->data_size) {
+		blk = (struct spmc_shmem_obj *)(state->data + offset);
+		if (!blk->is_free) {
+			used += spmc_shmem_obj_size(blk->desc_size);
+			objs++;
+		}
+		offset += spmc_shmem_block_size(blk->order);
+	}
+
+	WARN("shmem datastore: %u objects, 0x%zx/0x%zx bytes allocated, 0x%zx used\n",
+	     objs, state->allocated, state->data_size, used);
+
+	for (order = 0U; order < SPMC_SHMEM_BLOCK_ORDERS; order++) {
+		count = 0U;
+		for (blk = state->free_list[order]; blk != NULL;
+		     blk = blk->next_free) {
+			count++;
+		}
+		if (count != 0U) {
+			WARN("  free blocks of 0x%zx bytes: %u\n",
+			     spmc_shmem_block_size(order), count);
+			largest = spmc_shmem_block_size(order);
+		}
+	}
+
+	WARN("  largest free block: 0x%zx bytes\n", largest);
+}
+
 /**
  * spmc_shmem_obj_alloc - Allocate struct spmc_shmem_obj.
  * @state:      Global state.
@@ -63,32 +214,63 @@ static size_t spmc_shmem_obj_size(size_t desc_size)
  *              allocated object will hold.
  *
  * Return: Pointer to newly allocated object, or %NULL if there not enough space
- *         left. The returned pointer is only valid while @state is locked, to
- *         used it again after unlocking @state, spmc_shmem_obj_lookup must be
- *         called.
+ *         left. The object does not move until it is freed.
  */
 static struct spmc_shmem_obj *
 spmc_shmem_obj_alloc(struct spmc_shmem_obj_state *state, size_t desc_size)
 {
 	struct spmc_shmem_obj *obj;
-	size_t free = state->data_size - state->allocated;
+	size_t obj_size = spmc_shmem_obj_size(desc_size);
+	uint32_t order = 0U;
+	uint32_t split;
 
 	if (state->data == NULL) {
 		ERROR("Missing shmem datastore!\n");
 		return NULL;
 	}
 
-	if (spmc_shmem_obj_size(desc_size) > free) {
+	while ((order < SPMC_SHMEM_BLOCK_ORDERS) &&
+	       (spmc_shmem_block_size(order) < obj_size)) {
+		order++;
+	}
+
+	/* Take the smallest free block that is large enough */
+	for (split = order; split < SPMC_SHMEM_BLOCK_ORDERS; split++) {
+		if (state->free_list[split] != NULL) {
+			break;
+		}
+	}
+
+	if (split >= SPMC_SHMEM_BLOCK_ORDERS) {
 		WARN("%s(0x%zx) failed, free 0x%zx\n",
-		     __func__, desc_size, free);
+		     __func__, desc_size, state->data_size - state->allocated);
+		spmc_shmem_obj_report(state);
 		return NULL;
 	}
-	obj = (struct spmc_shmem_obj *)(state->data + state->allocated);
+
+	obj = state->free_list[split];
+	spmc_shmem_free_list_del(state, obj);
+
+	/* Give back the upper halves of the block until it has the right size */
+	while (split > order) {
+		split--;
+		spmc_shmem_free_list_add(state, (struct spmc_shmem_obj *)
+					 ((uint8_t *)obj +
+					  spmc_shmem_block_size(split)),
+					 split);
+	}
+
+	obj->order = order;
+	obj->lock = (spinlock_t) {0};
+	obj->refs = 0U;
+	obj->handle = 0U;
+	obj->complete = false;
+	obj->removed = false;
 	obj->desc = (struct ffa_mtd) {0};
 	obj->desc_size = desc_size;
 	obj->desc_filled = 0;
 	obj->in_use = 0;
-	state->allocated += spmc_shmem_obj_size(desc_size);
+	state->allocated += spmc_shmem_block_size(order);
 	return obj;
 }
 
@@ -97,26 +279,69 @@ spmc_shmem_obj_alloc(struct spmc_shmem_obj_state *state, size_t desc_size)
  * @state:      Global state.
  * @obj:        Object to free.
  *
- * Release memory used by @obj. Other objects may move, so on return all
- * pointers to struct spmc_shmem_obj object should be considered invalid, not
- * just @obj.
- *
- * The current implementation always compacts the remaining objects to simplify
- * the allocator and to avoid fragmentation.
+ * Release memory used by @obj. The block of @obj is merged with its buddy for
+ * as long as the buddy is free as well. Other objects are not affected.
  */
 
 static void spmc_shmem_obj_free(struct spmc_shmem_obj_state *state,
 				  struct spmc_shmem_obj *obj)
 {
-	size_t free_size = spmc_shmem_obj_size(obj->desc_size);
-	uint8_t *shift_dest = (uint8_t *)obj;
-	uint8_t *shift_src = shift_dest + free_size;
-	size_t shift_size = state->allocated - (shift_src - state->data);
+	size_t offset = (uint8_t *)obj - state->data;
+	size_t merged;
+	uint32_t order = obj->order;
+	struct spmc_shmem_obj *buddy;
+
+	state->allocated -= spmc_shmem_block_size(order);
+
+	while ((order + 1U) < SPMC_SHMEM_BLOCK_ORDERS) {
+		/*
+		 * A merged block that fits in the datastore never straddles two
+		 * of the blocks it was initially carved into.
+		 */
+		merged = offset & ~(spmc_shmem_block_size(order + 1U) - 1U);
+		if ((merged + spmc_shmem_block_size(order + 1U)) >
+		    state->data_size) {
+			break;
+		}
+
+		buddy = (struct spmc_shmem_obj *)
+			(state->data + (offset ^ spmc_shmem_block_size(order)));
+		if (!buddy->is_free || (buddy->order != order)) {
+			break;
+		}
+
+		spmc_shmem_free_list_del(state, buddy);
+		offset = merged;
+		order++;
+	}
+
+	spmc_shmem_free_list_add(state,
+				 (struct spmc_shmem_obj *)(state->data + offset),
+				 order);
+}
+
+/**
+ * spmc_shmem_obj_get_next - Get the next memory object from an offset.
+ * @offset:     Offset used to track which objects have previously been
+ *              returned.
+ *
+ * Return: the next struct spmc_shmem_obj_state object from the provided
+ *	   offset.
+ *	   %NULL, if there are no more objects.
+ */
+static struct spmc_shmem_obj *
+spmc_shmem_obj_get_next(struct spmc_shmem_obj_state *state, size_t *offset)
+{
+	struct spmc_shmem_obj *obj;
 
-	if (shift_size != 0U) {
-		memmove(shift_dest, shift_src, shift_size);
+	while (*offset < state->data_size) {
+		obj = (struct spmc_shmem_obj *)(state->data + *offset);
+		*offset += spmc_shmem_block_size(obj->order);
+		if (!obj->is_free) {
+			return obj;
+		}
 	}
-	state->allocated -= free_size;
+	return NULL;
 }
 
 /**
@@ -130,41 +355,121 @@ static void spmc_shmem_obj_free(struct spmc_shmem_obj_state *state,
 static struct spmc_shmem_obj *
 spmc_shmem_obj_lookup(struct spmc_shmem_obj_state *state, uint64_t handle)
 {
-	uint8_t *curr = state->data;
+	struct spmc_shmem_obj *obj;
+	size_t offset = 0U;
 
-	while (curr - state->data < state->allocated) {
-		struct spmc_shmem_obj *obj = (struct spmc_shmem_obj *)curr;
+	/* Objects without a handle cannot be looked up */
+	if (handle == 0U) {
+		return NULL;
+	}
 
-		if (obj->desc.handle == handle) {
+	while ((obj = spmc_shmem_obj_get_next(state, &offset)) != NULL) {
+		if ((obj->handle == handle) && !obj->removed) {
 			return obj;
 		}
-		curr += spmc_shmem_obj_size(obj->desc_size);
 	}
 	return NULL;
 }
 
+/*
+ * Objects are used under a two level locking scheme. @spmc_shmem_obj_state.lock
+ * only covers the allocator, handles, lookups and the fields of the objects
+ * read by lookups and walks, and is never held for long. Each FF-A call then
+ * works on its object under the lock of the object, which covers the
+ * descriptor and @in_use. A reference keeps the object from being freed while
+ * a CPU waits for its lock.
+ *
+ * Lock order: mailbox of the SP, object, mailbox of the NWd, global state.
+ */
+
 /**
- * spmc_shmem_obj_get_next - Get the next memory object from an offset.
- * @offset:     Offset used to track which objects have previously been
- *              returned.
+ * spmc_shmem_obj_new - Allocate an object and lock it.
+ * @desc_size:  Size of the descriptor the object will hold.
  *
- * Return: the next struct spmc_shmem_obj_state object from the provided
- *	   offset.
- *	   %NULL, if there are no more objects.
+ * Return: the new object, locked and referenced, or %NULL if there is not
+ *         enough space left. The object cannot be looked up until it has a
+ *         handle.
  */
-static struct spmc_shmem_obj *
-spmc_shmem_obj_get_next(struct spmc_shmem_obj_state *state, size_t *offset)
+static struct spmc_shmem_obj *spmc_shmem_obj_new(size_t desc_size)
 {
-	uint8_t *curr = state->data + *offset;
+	struct spmc_shmem_obj *obj;
+
+	spin_lock(&spmc_shmem_obj_state.lock);
+	obj = spmc_shmem_obj_alloc(&spmc_shmem_obj_state, desc_size);
+	if (obj != NULL) {
+		obj->refs = 1U;
+	}
+	spin_unlock(&spmc_shmem_obj_state.lock);
 
-	if (curr - state->data < state->allocated) {
-		struct spmc_shmem_obj *obj = (struct spmc_shmem_obj *)curr;
+	if (obj != NULL) {
+		spin_lock(&obj->lock);
+	}
 
-		*offset += spmc_shmem_obj_size(obj->desc_size);
+	return obj;
+}
+
+/**
+ * spmc_shmem_obj_put - Unlock an object and drop the reference to it.
+ * @obj:        Object returned by spmc_shmem_obj_new() or spmc_shmem_obj_get().
+ *
+ * If @obj has been removed and this was the last reference, it is freed.
+ */
+static void spmc_shmem_obj_put(struct spmc_shmem_obj *obj)
+{
+	spin_unlock(&obj->lock);
 
-		return obj;
+	spin_lock(&spmc_shmem_obj_state.lock);
+	assert(obj->refs != 0U);
+	obj->refs--;
+	if (obj->removed && (obj->refs == 0U)) {
+		spmc_shmem_obj_free(&spmc_shmem_obj_state, obj);
 	}
-	return NULL;
+	spin_unlock(&spmc_shmem_obj_state.lock);
+}
+
+/**
+ * spmc_shmem_obj_get - Look up an object by handle and lock it.
+ * @handle:     Unique handle of the object.
+ *
+ * Return: the object, locked and referenced, or %NULL if no object has
+ *         @handle or if it was removed while waiting for its lock.
+ */
+static struct spmc_shmem_obj *spmc_shmem_obj_get(uint64_t handle)
+{
+	struct spmc_shmem_obj *obj;
+
+	spin_lock(&spmc_shmem_obj_state.lock);
+	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, handle);
+	if (obj != NULL) {
+		obj->refs++;
+	}
+	spin_unlock(&spmc_shmem_obj_state.lock);
+
+	if (obj == NULL) {
+		return NULL;
+	}
+
+	spin_lock(&obj->lock);
+	if (obj->removed) {
+		spmc_shmem_obj_put(obj);
+		return NULL;
+	}
+
+	return obj;
+}
+
+/**
+ * spmc_shmem_obj_remove - Remove a locked object.
+ * @obj:        Object returned by spmc_shmem_obj_new() or spmc_shmem_obj_get().
+ *
+ * The object can no longer be looked up or retrieved. It is freed by the
+ * spmc_shmem_obj_put() call that drops the last reference.
+ */
+static void spmc_shmem_obj_remove(struct spmc_shmem_obj *obj)
+{
+	spin_lock(&spmc_shmem_obj_state.lock);
+	obj->removed = true;
+	spin_unlock(&spmc_shmem_obj_state.lock);
 }
 
 /*******************************************************************************
@@ -617,8 +922,6 @@ spmc_shm_convert_mtd_to_v1_0(struct spmc_shmem_obj *out_obj,
  *                  descriptor.
  *
  * Return: 0 if conversion and population succeeded.
- * Note: This function invalidates the reference to @orig therefore
- * `spmc_shmem_obj_lookup` must be called if further usage is required.
  */
 static uint32_t
 spmc_populate_ffa_v1_0_descriptor(void *dst, struct spmc_shmem_obj *orig_obj,
@@ -637,9 +940,11 @@ spmc_populate_ffa_v1_0_descriptor(void *dst, struct spmc_shmem_obj *orig_obj,
 			return FFA_ERROR_INVALID_PARAMETER;
 		}
 
-		/* Get a new obj to store the v1.0 descriptor. */
-		v1_0_obj = spmc_shmem_obj_alloc(&spmc_shmem_obj_state,
-						*v1_0_desc_size);
+		/*
+		 * Get a new obj to store the v1.0 descriptor. It has no handle
+		 * so no other CPU can find it.
+		 */
+		v1_0_obj = spmc_shmem_obj_new(*v1_0_desc_size);
 
 		if (!v1_0_obj) {
 			return FFA_ERROR_NO_MEMORY;
@@ -647,19 +952,17 @@ spmc_populate_ffa_v1_0_descriptor(void *dst, struct spmc_shmem_obj *orig_obj,
 
 		/* Perform the conversion from v1.1 to v1.0. */
 		if (!spmc_shm_convert_mtd_to_v1_0(v1_0_obj, orig_obj)) {
-			spmc_shmem_obj_free(&spmc_shmem_obj_state, v1_0_obj);
+			spmc_shmem_obj_remove(v1_0_obj);
+			spmc_shmem_obj_put(v1_0_obj);
 			return FFA_ERROR_INVALID_PARAMETER;
 		}
 
 		*copy_size = MIN(v1_0_obj->desc_size - offset, buf_size);
 		memcpy(dst, (uint8_t *) &v1_0_obj->desc + offset, *copy_size);
 
-		/*
-		 * We're finished with the v1.0 descriptor for now so free it.
-		 * Note that this will invalidate any references to the v1.1
-		 * descriptor.
-		 */
-		spmc_shmem_obj_free(&spmc_shmem_obj_state, v1_0_obj);
+		/* We're finished with the v1.0 descriptor for now so free it. */
+		spmc_shmem_obj_remove(v1_0_obj);
+		spmc_shmem_obj_put(v1_0_obj);
 
 		return 0;
 }
@@ -816,6 +1119,9 @@ static int spmc_shmem_check_obj(struct spmc_shmem_obj *obj,
  *				the memory is not in a valid state for lending.
  * @obj:    Object containing ffa_memory_region_descriptor.
  *
+ * Must be called with spmc_shmem_obj_state.lock held, so that the objects
+ * completed concurrently are checked against each other.
+ *
  * Return: 0 if object is valid, -EINVAL if invalid memory state.
  */
 static int spmc_shmem_check_state_obj(struct spmc_shmem_obj *obj,
@@ -837,11 +1143,12 @@ static int spmc_shmem_check_state_obj(struct spmc_shmem_obj *obj,
 
 	while (inflight_obj != NULL) {
 		/*
-		 * Don't compare the transaction to itself or to partially
-		 * transmitted descriptors.
+		 * Don't compare the transaction to itself or to descriptors
+		 * that are still being transmitted or validated, whose content
+		 * may be changing.
 		 */
-		if ((obj->desc.handle != inflight_obj->desc.handle) &&
-		    (obj->desc_size == obj->desc_filled)) {
+		if ((obj != inflight_obj) && inflight_obj->complete &&
+		    !inflight_obj->removed) {
 			other_mrd = spmc_shmem_obj_get_comp_mrd(inflight_obj,
 							  FFA_VERSION_COMPILED);
 			if (other_mrd == NULL) {
@@ -859,6 +1166,18 @@ static int spmc_shmem_check_state_obj(struct spmc_shmem_obj *obj,
 	return 0;
 }
 
+/**
+ * spmc_ffa_fill_desc - Copy a fragment of a descriptor into its object.
+ * @mbox:             Mailbox of the sender, locked.
+ * @obj:              Object returned by spmc_shmem_obj_new() or
+ *                    spmc_shmem_obj_get(). It is released on return.
+ * @fragment_length:  Length of the fragment in the TX buffer of @mbox.
+ * @mtd_flag:         Type of transaction for the first fragment, 0 otherwise.
+ * @ffa_version:      FF-A version of the sender.
+ * @smc_handle:       Handle passed to smc call.
+ *
+ * Return: @smc_handle on success, error code on failure.
+ */
 static long spmc_ffa_fill_desc(struct mailbox *mbox,
 			       struct spmc_shmem_obj *obj,
 			       uint32_t fragment_length,
@@ -870,6 +1189,8 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 	size_t emad_size;
 	uint32_t handle_low;
 	uint32_t handle_high;
+	size_t desc_filled;
+	uint32_t desc_sender_id;
 	struct ffa_emad_v1_0 *emad;
 	struct ffa_emad_v1_0 *other_emad;
 
@@ -886,9 +1207,6 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 		goto err_arg;
 	}
 
-	memcpy((uint8_t *)&obj->desc + obj->desc_filled,
-	       (uint8_t *) mbox->tx_buffer, fragment_length);
-
 	if (fragment_length > obj->desc_size - obj->desc_filled) {
 		WARN("%s: bad fragment size %u > %zu remaining\n", __func__,
 		     fragment_length, obj->desc_size - obj->desc_filled);
@@ -896,6 +1214,10 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 		goto err_arg;
 	}
 
+	/* Only @obj is locked while copying, other objects remain usable. */
+	memcpy((uint8_t *)&obj->desc + obj->desc_filled,
+	       (uint8_t *) mbox->tx_buffer, fragment_length);
+
 	/* Ensure that the sender ID resides in the normal world. */
 	if (ffa_is_secure_world_id(obj->desc.sender_id)) {
 		WARN("%s: Invalid sender ID 0x%x.\n",
@@ -925,7 +1247,10 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 
 	if (obj->desc_filled == 0U) {
 		/* First fragment, descriptor header has been copied */
-		obj->desc.handle = spmc_shmem_obj_state.next_handle++;
+		spin_lock(&spmc_shmem_obj_state.lock);
+		obj->handle = spmc_shmem_obj_state.next_handle++;
+		spin_unlock(&spmc_shmem_obj_state.lock);
+		obj->desc.handle = obj->handle;
 		obj->desc.flags |= mtd_flag;
 	}
 
@@ -940,9 +1265,11 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 	handle_high = obj->desc.handle >> 32;
 
 	if (obj->desc_filled != obj->desc_size) {
+		desc_filled = obj->desc_filled;
+		desc_sender_id = (uint32_t)obj->desc.sender_id << 16;
+		spmc_shmem_obj_put(obj);
 		SMC_RET8(smc_handle, FFA_MEM_FRAG_RX, handle_low,
-			 handle_high, obj->desc_filled,
-			 (uint32_t)obj->desc.sender_id << 16, 0, 0, 0);
+			 handle_high, desc_filled, desc_sender_id, 0, 0, 0);
 	}
 
 	/* The full descriptor has been received, perform any final checks. */
@@ -1000,20 +1327,12 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 		}
 	}
 
-	ret = spmc_shmem_check_state_obj(obj, ffa_version);
-	if (ret) {
-		ERROR("%s: invalid memory region descriptor.\n", __func__);
-		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_bad_desc;
-	}
-
 	/*
 	 * Everything checks out, if the sender was using FF-A v1.0, convert
 	 * the descriptor format to use the v1.1 structures.
 	 */
 	if (ffa_version == MAKE_FFA_VERSION(1, 0)) {
 		struct spmc_shmem_obj *v1_1_obj;
-		uint64_t mem_handle;
 
 		/* Calculate the size that the v1.1 descriptor will required. */
 		size_t v1_1_desc_size =
@@ -1023,14 +1342,14 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 		if (v1_1_desc_size == 0U) {
 			ERROR("%s: cannot determine size of descriptor.\n",
 			      __func__);
+			ret = FFA_ERROR_INVALID_PARAMETER;
 			goto err_arg;
 		}
 
 		/* Get a new obj to store the v1.1 descriptor. */
-		v1_1_obj =
-		    spmc_shmem_obj_alloc(&spmc_shmem_obj_state, v1_1_desc_size);
+		v1_1_obj = spmc_shmem_obj_new(v1_1_desc_size);
 
-		if (!obj) {
+		if (v1_1_obj == NULL) {
 			ret = FFA_ERROR_NO_MEMORY;
 			goto err_arg;
 		}
@@ -1040,23 +1359,40 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 		v1_1_obj->desc_filled = v1_1_desc_size;
 		if (!spmc_shm_convert_shmem_obj_from_v1_0(v1_1_obj, obj)) {
 			ERROR("%s: Could not convert mtd!\n", __func__);
-			spmc_shmem_obj_free(&spmc_shmem_obj_state, v1_1_obj);
+			ret = FFA_ERROR_INVALID_PARAMETER;
+			spmc_shmem_obj_remove(v1_1_obj);
+			spmc_shmem_obj_put(v1_1_obj);
 			goto err_arg;
 		}
 
 		/*
 		 * We're finished with the v1.0 descriptor so free it
-		 * and continue our checks with the new v1.1 descriptor.
+		 * and continue our checks with the new v1.1 descriptor,
+		 * which takes over the handle.
 		 */
-		mem_handle = obj->desc.handle;
-		spmc_shmem_obj_free(&spmc_shmem_obj_state, obj);
-		obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, mem_handle);
-		if (obj == NULL) {
-			ERROR("%s: Failed to find converted descriptor.\n",
-			     __func__);
-			ret = FFA_ERROR_INVALID_PARAMETER;
-			return spmc_ffa_error_return(smc_handle, ret);
-		}
+		spin_lock(&spmc_shmem_obj_state.lock);
+		v1_1_obj->handle = obj->handle;
+		obj->removed = true;
+		spin_unlock(&spmc_shmem_obj_state.lock);
+		spmc_shmem_obj_put(obj);
+		obj = v1_1_obj;
+	}
+
+	/*
+	 * The overlap check and the completion of the object are atomic, so
+	 * that two descriptors completed at the same time are checked against
+	 * each other.
+	 */
+	spin_lock(&spmc_shmem_obj_state.lock);
+	ret = spmc_shmem_check_state_obj(obj, FFA_VERSION_COMPILED);
+	if (ret == 0) {
+		obj->complete = true;
+	}
+	spin_unlock(&spmc_shmem_obj_state.lock);
+	if (ret != 0) {
+		ERROR("%s: invalid memory region descriptor.\n", __func__);
+		ret = FFA_ERROR_INVALID_PARAMETER;
+		goto err_bad_desc;
 	}
 
 	/* Allow for platform specific operations to be performed. */
@@ -1065,12 +1401,15 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 		goto err_arg;
 	}
 
+	spmc_shmem_obj_put(obj);
+
 	SMC_RET8(smc_handle, FFA_SUCCESS_SMC32, 0, handle_low, handle_high, 0,
 		 0, 0, 0);
 
 err_bad_desc:
 err_arg:
-	spmc_shmem_obj_free(&spmc_shmem_obj_state, obj);
+	spmc_shmem_obj_remove(obj);
+	spmc_shmem_obj_put(obj);
 	return spmc_ffa_error_return(smc_handle, ret);
 }
 
@@ -1142,11 +1481,9 @@ long spmc_ffa_mem_send(uint32_t smc_fid,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
 
-	spin_lock(&spmc_shmem_obj_state.lock);
-	obj = spmc_shmem_obj_alloc(&spmc_shmem_obj_state, total_length);
+	obj = spmc_shmem_obj_new(total_length);
 	if (obj == NULL) {
-		ret = FFA_ERROR_NO_MEMORY;
-		goto err_unlock;
+		return spmc_ffa_error_return(handle, FFA_ERROR_NO_MEMORY);
 	}
 
 	spin_lock(&mbox->lock);
@@ -1154,12 +1491,7 @@ long spmc_ffa_mem_send(uint32_t smc_fid,
 				 ffa_version, handle);
 	spin_unlock(&mbox->lock);
 
-	spin_unlock(&spmc_shmem_obj_state.lock);
 	return ret;
-
-err_unlock:
-	spin_unlock(&spmc_shmem_obj_state.lock);
-	return spmc_ffa_error_return(handle, ret);
 }
 
 /**
@@ -1192,14 +1524,12 @@ long spmc_ffa_mem_frag_tx(uint32_t smc_fid,
 	struct spmc_shmem_obj *obj;
 	uint64_t mem_handle = handle_low | (((uint64_t)handle_high) << 32);
 
-	spin_lock(&spmc_shmem_obj_state.lock);
-
-	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, mem_handle);
+	obj = spmc_shmem_obj_get(mem_handle);
 	if (obj == NULL) {
 		WARN("%s: invalid handle, 0x%lx, not a valid handle.\n",
 		     __func__, mem_handle);
-		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock;
+		return spmc_ffa_error_return(handle,
+					     FFA_ERROR_INVALID_PARAMETER);
 	}
 
 	desc_sender_id = (uint32_t)obj->desc.sender_id << 16;
@@ -1207,14 +1537,14 @@ long spmc_ffa_mem_frag_tx(uint32_t smc_fid,
 		WARN("%s: invalid sender_id 0x%x != 0x%x\n", __func__,
 		     sender_id, desc_sender_id);
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock;
+		goto err_put;
 	}
 
 	if (obj->desc_filled == obj->desc_size) {
 		WARN("%s: object desc already filled, %zu\n", __func__,
 		     obj->desc_filled);
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock;
+		goto err_put;
 	}
 
 	spin_lock(&mbox->lock);
@@ -1222,11 +1552,10 @@ long spmc_ffa_mem_frag_tx(uint32_t smc_fid,
 				 handle);
 	spin_unlock(&mbox->lock);
 
-	spin_unlock(&spmc_shmem_obj_state.lock);
 	return ret;
 
-err_unlock:
-	spin_unlock(&spmc_shmem_obj_state.lock);
+err_put:
+	spmc_shmem_obj_put(obj);
 	return spmc_ffa_error_return(handle, ret);
 }
 
@@ -1346,8 +1675,9 @@ spmc_ffa_mem_retrieve_req(uint32_t smc_fid,
 
 	if (req->emad_count == 0U) {
 		WARN("%s: unsupported attribute desc count %u.\n",
-		     __func__, obj->desc.emad_count);
-		return -EINVAL;
+		     __func__, req->emad_count);
+		ret = FFA_ERROR_INVALID_PARAMETER;
+		goto err_unlock_mailbox;
 	}
 
 	/* Determine the appropriate minimum descriptor size. */
@@ -1363,12 +1693,10 @@ spmc_ffa_mem_retrieve_req(uint32_t smc_fid,
 		goto err_unlock_mailbox;
 	}
 
-	spin_lock(&spmc_shmem_obj_state.lock);
-
-	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, req->handle);
+	obj = spmc_shmem_obj_get(req->handle);
 	if (obj == NULL) {
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock_all;
+		goto err_unlock_mailbox;
 	}
 
 	if (obj->desc_filled != obj->desc_size) {
@@ -1533,14 +1861,14 @@ spmc_ffa_mem_retrieve_req(uint32_t smc_fid,
 	/* Set the NS bit in the response if applicable. */
 	spmc_ffa_mem_retrieve_set_ns_bit(resp, sp_ctx);
 
-	spin_unlock(&spmc_shmem_obj_state.lock);
+	spmc_shmem_obj_put(obj);
 	spin_unlock(&mbox->lock);
 
 	SMC_RET8(handle, FFA_MEM_RETRIEVE_RESP, out_desc_size,
 		 copy_size, 0, 0, 0, 0, 0);
 
 err_unlock_all:
-	spin_unlock(&spmc_shmem_obj_state.lock);
+	spmc_shmem_obj_put(obj);
 err_unlock_mailbox:
 	spin_unlock(&mbox->lock);
 	return spmc_ffa_error_return(handle, ret);
@@ -1587,14 +1915,14 @@ long spmc_ffa_mem_frag_rx(uint32_t smc_fid,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
 
-	spin_lock(&spmc_shmem_obj_state.lock);
+	spin_lock(&mbox->lock);
 
-	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, mem_handle);
+	obj = spmc_shmem_obj_get(mem_handle);
 	if (obj == NULL) {
 		WARN("%s: invalid handle, 0x%lx, not a valid handle.\n",
 		     __func__, mem_handle);
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock_shmem;
+		goto err_unlock_mailbox;
 	}
 
 	desc_sender_id = (uint32_t)obj->desc.sender_id << 16;
@@ -1602,18 +1930,16 @@ long spmc_ffa_mem_frag_rx(uint32_t smc_fid,
 		WARN("%s: invalid sender_id 0x%x != 0x%x\n", __func__,
 		     sender_id, desc_sender_id);
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock_shmem;
+		goto err_unlock_all;
 	}
 
 	if (fragment_offset >= obj->desc_size) {
 		WARN("%s: invalid fragment_offset 0x%x >= 0x%zx\n",
 		     __func__, fragment_offset, obj->desc_size);
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock_shmem;
+		goto err_unlock_all;
 	}
 
-	spin_lock(&mbox->lock);
-
 	if (mbox->rxtx_page_count == 0U) {
 		WARN("%s: buffer pair not registered.\n", __func__);
 		ret = FFA_ERROR_INVALID_PARAMETER;
@@ -1655,16 +1981,16 @@ long spmc_ffa_mem_frag_rx(uint32_t smc_fid,
 		memcpy(mbox->rx_buffer, src + fragment_offset, copy_size);
 	}
 
+	spmc_shmem_obj_put(obj);
 	spin_unlock(&mbox->lock);
-	spin_unlock(&spmc_shmem_obj_state.lock);
 
 	SMC_RET8(handle, FFA_MEM_FRAG_TX, handle_low, handle_high,
 		 copy_size, sender_id, 0, 0, 0);
 
 err_unlock_all:
+	spmc_shmem_obj_put(obj);
+err_unlock_mailbox:
 	spin_unlock(&mbox->lock);
-err_unlock_shmem:
-	spin_unlock(&spmc_shmem_obj_state.lock);
 	return spmc_ffa_error_return(handle, ret);
 }
 
@@ -1723,12 +2049,10 @@ int spmc_ffa_mem_relinquish(uint32_t smc_fid,
 		goto err_unlock_mailbox;
 	}
 
-	spin_lock(&spmc_shmem_obj_state.lock);
-
-	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, req->handle);
+	obj = spmc_shmem_obj_get(req->handle);
 	if (obj == NULL) {
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock_all;
+		goto err_unlock_mailbox;
 	}
 
 	/*
@@ -1764,13 +2088,13 @@ int spmc_ffa_mem_relinquish(uint32_t smc_fid,
 	}
 	obj->in_use--;
 
-	spin_unlock(&spmc_shmem_obj_state.lock);
+	spmc_shmem_obj_put(obj);
 	spin_unlock(&mbox->lock);
 
 	SMC_RET1(handle, FFA_SUCCESS_SMC32);
 
 err_unlock_all:
-	spin_unlock(&spmc_shmem_obj_state.lock);
+	spmc_shmem_obj_put(obj);
 err_unlock_mailbox:
 	spin_unlock(&mbox->lock);
 	return spmc_ffa_error_return(handle, ret);
@@ -1815,30 +2139,28 @@ int spmc_ffa_mem_reclaim(uint32_t smc_fid,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
 
-	spin_lock(&spmc_shmem_obj_state.lock);
-
-	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, mem_handle);
+	obj = spmc_shmem_obj_get(mem_handle);
 	if (obj == NULL) {
-		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock;
+		return spmc_ffa_error_return(handle,
+					     FFA_ERROR_INVALID_PARAMETER);
 	}
 	if (obj->in_use != 0U) {
 		ret = FFA_ERROR_DENIED;
-		goto err_unlock;
+		goto err_put;
 	}
 
 	/* Allow for platform specific operations to be performed. */
 	ret = plat_spmc_shmem_reclaim(&obj->desc);
 	if (ret != 0) {
-		goto err_unlock;
+		goto err_put;
 	}
 
-	spmc_shmem_obj_free(&spmc_shmem_obj_state, obj);
-	spin_unlock(&spmc_shmem_obj_state.lock);
+	spmc_shmem_obj_remove(obj);
+	spmc_shmem_obj_put(obj);
 
 	SMC_RET1(handle, FFA_SUCCESS_SMC32);
 
-err_unlock:
-	spin_unlock(&spmc_shmem_obj_state.lock);
+err_put:
+	spmc_shmem_obj_put(obj);
 	return spmc_ffa_error_return(handle, ret);
 }
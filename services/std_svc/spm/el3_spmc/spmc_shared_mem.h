@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -31,23 +31,32 @@ struct ffa_mem_relinquish_descriptor {
 CASSERT(sizeof(struct ffa_mem_relinquish_descriptor) == 16,
 	assert_ffa_mem_relinquish_descriptor_size_mismatch);
 
+/* Number of block sizes of the datastore, from 128 bytes to 64MB */
+#define SPMC_SHMEM_BLOCK_ORDERS		U(20)
+
+struct spmc_shmem_obj;
+
 /**
  * struct spmc_shmem_obj_state - Global state.
  * @data:           Backing store for spmc_shmem_obj objects.
  * @data_size:      The size allocated for the backing store.
  * @allocated:      Number of bytes allocated in @data.
+ * @free_list:      Free blocks of @data, by order.
  * @next_handle:    Handle used for next allocated object.
- * @lock:           Lock protecting all state in this file.
+ * @lock:           Lock protecting the allocator, the handles and the lookup of
+ *                  objects. Each object has its own lock for the rest.
  */
 struct spmc_shmem_obj_state {
 	uint8_t *data;
 	size_t data_size;
 	size_t allocated;
+	struct spmc_shmem_obj *free_list[SPMC_SHMEM_BLOCK_ORDERS];
 	uint64_t next_handle;
 	spinlock_t lock;
 };
 
 extern struct spmc_shmem_obj_state spmc_shmem_obj_state;
+void spmc_shmem_obj_state_init(struct spmc_shmem_obj_state *state);
 extern int plat_spmc_shmem_begin(struct ffa_mtd *desc);
 extern int plat_spmc_shmem_reclaim(struct ffa_mtd *desc);
 
@@ -17,6 +17,8 @@
 #include <common/debug.h>
 #include <common/runtime_svc.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/el3_runtime/pubsub_events.h>
+#include <lib/el3_trace/el3_trace.h>
 #include <lib/smccc.h>
 #include <lib/spinlock.h>
 #include <lib/utils.h>
@@ -94,6 +96,88 @@ static uint64_t spmd_smc_forward(uint32_t smc_fid,
 				 void *handle,
 				 uint64_t flags);
 
+#if SPMD_SKIP_NS_EL1_CTX && ENABLE_ASSERTIONS
+/*
+ * Debug builds sample a few normal world EL1 registers when leaving the normal
+ * world, and check them when returning to it, to catch an SPMC that does not
+ * preserve the normal world EL1 context.
+ */
+static void spmd_ns_el1_sample(u_register_t regs[3])
+{
+	regs[0] = read_sctlr_el1();
+	regs[1] = read_vbar_el1();
+	regs[2] = read_ttbr1_el1();
+}
+
+static void spmd_ns_el1_check(void)
+{
+	spmd_spm_core_context_t *ctx = spmd_get_context();
+	u_register_t regs[3];
+
+	/* Nothing to check if the normal world was not left through the SPMD */
+	if (ctx->ns_el1_sample[0] == 0U) {
+		return;
+	}
+
+	spmd_ns_el1_sample(regs);
+	assert(memcmp(regs, ctx->ns_el1_sample, sizeof(regs)) == 0);
+	ctx->ns_el1_sample[0] = 0U;
+}
+#endif
+
+/*******************************************************************************
+ * Save the lower EL system register context of the given security state on
+ * exit from that world.
+ *
+ * When the SPMC runs at S-EL2 only the EL2 context is switched for the secure
+ * world, and the normal world EL1 context is additionally saved because S-EL1
+ * partitions scheduled by the SPMC share the same EL1 registers. If the SPMC
+ * is known to preserve the normal world EL1 context itself
+ * (SPMD_SKIP_NS_EL1_CTX), that save is elided and only the world exit event is
+ * published, which removes the EL1 MRS sequence from every forwarded call.
+ ******************************************************************************/
+static void spmd_sysregs_context_save(unsigned int security_state)
+{
+#if SPMD_SPM_AT_SEL2
+	if (security_state == NON_SECURE) {
+#if SPMD_SKIP_NS_EL1_CTX
+#if ENABLE_ASSERTIONS
+		spmd_ns_el1_sample(spmd_get_context()->ns_el1_sample);
+#endif
+		PUBLISH_EVENT(cm_exited_normal_world);
+#else
+		cm_el1_sysregs_context_save(security_state);
+#endif
+	}
+	cm_el2_sysregs_context_save(security_state);
+#else
+	cm_el1_sysregs_context_save(security_state);
+#endif
+}
+
+/*******************************************************************************
+ * Restore the lower EL system register context of the given security state
+ * before entering that world. Counterpart of spmd_sysregs_context_save().
+ ******************************************************************************/
+static void spmd_sysregs_context_restore(unsigned int security_state)
+{
+#if SPMD_SPM_AT_SEL2
+	if (security_state == NON_SECURE) {
+#if SPMD_SKIP_NS_EL1_CTX
+#if ENABLE_ASSERTIONS
+		spmd_ns_el1_check();
+#endif
+		PUBLISH_EVENT(cm_entering_normal_world);
+#else
+		cm_el1_sysregs_context_restore(security_state);
+#endif
+	}
+	cm_el2_sysregs_context_restore(security_state);
+#else
+	cm_el1_sysregs_context_restore(security_state);
+#endif
+}
+
 /******************************************************************************
  * Builds an SPMD to SPMC direct message request.
  *****************************************************************************/
@@ -211,10 +295,7 @@ static uint64_t spmd_secure_interrupt_handler(uint32_t id,
 	assert(handle == cm_get_context(NON_SECURE));
 
 	/* Save the non-secure context before entering SPMC */
-	cm_el1_sysregs_context_save(NON_SECURE);
-#if SPMD_SPM_AT_SEL2
-	cm_el2_sysregs_context_save(NON_SECURE);
-#endif
+	spmd_sysregs_context_save(NON_SECURE);
 
 	/* Convey the event to the SPMC through the FFA_INTERRUPT interface. */
 	write_ctx_reg(gpregs, CTX_GPREG_X0, FFA_INTERRUPT);
@@ -236,10 +317,7 @@ static uint64_t spmd_secure_interrupt_handler(uint32_t id,
 
 	ctx->secure_interrupt_ongoing = false;
 
-	cm_el1_sysregs_context_restore(NON_SECURE);
-#if SPMD_SPM_AT_SEL2
-	cm_el2_sysregs_context_restore(NON_SECURE);
-#endif
+	spmd_sysregs_context_restore(NON_SECURE);
 	cm_set_next_eret_context(NON_SECURE);
 
 	SMC_RET0(&ctx->cpu_ctx);
@@ -449,25 +527,13 @@ uint64_t spmd_smc_switch_state(uint32_t smc_fid,
 	unsigned int secure_state_in = (secure_origin) ? SECURE : NON_SECURE;
 	unsigned int secure_state_out = (!secure_origin) ? SECURE : NON_SECURE;
 
+	EL3_TRACE_EVENT(EL3_TRACE_EV_SPMD_SWITCH, secure_state_out, smc_fid, x1);
+
 	/* Save incoming security state */
-#if SPMD_SPM_AT_SEL2
-	if (secure_state_in == NON_SECURE) {
-		cm_el1_sysregs_context_save(secure_state_in);
-	}
-	cm_el2_sysregs_context_save(secure_state_in);
-#else
-	cm_el1_sysregs_context_save(secure_state_in);
-#endif
+	spmd_sysregs_context_save(secure_state_in);
 
 	/* Restore outgoing security state */
-#if SPMD_SPM_AT_SEL2
-	if (secure_state_out == NON_SECURE) {
-		cm_el1_sysregs_context_restore(secure_state_out);
-	}
-	cm_el2_sysregs_context_restore(secure_state_out);
-#else
-	cm_el1_sysregs_context_restore(secure_state_out);
-#endif
+	spmd_sysregs_context_restore(secure_state_out);
 	cm_set_next_eret_context(secure_state_out);
 
 	SMC_RET8(cm_get_context(secure_state_out), smc_fid, x1, x2, x3, x4,
@@ -663,10 +729,7 @@ uint64_t spmd_smc_handler(uint32_t smc_fid,
 				break;
 			}
 			/* Save non-secure system registers context */
-			cm_el1_sysregs_context_save(NON_SECURE);
-#if SPMD_SPM_AT_SEL2
-			cm_el2_sysregs_context_save(NON_SECURE);
-#endif
+			spmd_sysregs_context_save(NON_SECURE);
 
 			/*
 			 * The incoming request has FFA_VERSION as X0 smc_fid
@@ -52,6 +52,10 @@ typedef struct spmd_spm_core_context {
 	cpu_context_t cpu_ctx;
 	spmc_state_t state;
 	bool secure_interrupt_ongoing;
+#if SPMD_SKIP_NS_EL1_CTX && ENABLE_ASSERTIONS
+	/* Normal world EL1 registers sampled when leaving the Normal world */
+	u_register_t ns_el1_sample[3];
+#endif
 } spmd_spm_core_context_t;
 
 /*
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2023, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <openssl/sha.h>
+#include <openssl/x509.h>
+
+#include "cert.h"
+
+#define CACHE_KEY_SIZE		SHA256_DIGEST_LENGTH
+
+/* Exported API */
+int cache_key(int md_alg, const cert_t *cert, STACK_OF(X509_EXTENSION) * sk,
+	      unsigned char key[CACHE_KEY_SIZE]);
+X509 *cache_load(const char *dir, const unsigned char key[CACHE_KEY_SIZE],
+		 const cert_t *cert);
+int cache_store(const char *dir, const unsigned char key[CACHE_KEY_SIZE],
+		X509 *x);
+
+#endif /* CACHE_H */
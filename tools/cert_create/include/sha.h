@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,9 @@
 #ifndef SHA_H
 #define SHA_H
 
-int sha_file(int md_alg, const char *filename, unsigned char *md);
+#include "file_stream.h"
+
+int sha_file(int md_alg, const char *filename, unsigned char *md,
+	     file_stream_stats_t *stats);
 
 #endif /* SHA_H */
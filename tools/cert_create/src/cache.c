@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2023, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Content-addressed cache of certificates. A certificate is looked up by a
+ * digest of everything that goes into it apart from the serial number and the
+ * validity period: its name and the name of its issuer, the hash algorithm,
+ * its public key and the one of its issuer, and its extensions, which hold
+ * the image digests, NV counters and public keys of the chain of trust.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+#include "cache.h"
+#include "cert.h"
+#include "debug.h"
+#include "key.h"
+
+#define CACHE_PATH_MAX_LEN	1024
+
+/* Add a DER encoding, prefixed by its length, to the digest and free it */
+static int cache_digest_der(EVP_MD_CTX *mdctx, unsigned char *der, int len)
+{
+	int rc;
+
+	if (len < 0) {
+		return 0;
+	}
+
+	rc = EVP_DigestUpdate(mdctx, &len, sizeof(len)) &&
+	     EVP_DigestUpdate(mdctx, der, len);
+	OPENSSL_free(der);
+
+	return rc;
+}
+
+static int cache_digest_key(EVP_MD_CTX *mdctx, EVP_PKEY *pkey)
+{
+	unsigned char *der = NULL;
+	int len;
+
+	len = i2d_PUBKEY(pkey, &der);
+	return cache_digest_der(mdctx, der, len);
+}
+
+/*
+ * Calculate the cache key of a certificate about to be created by cert_new()
+ * with the extensions in 'sk'.
+ */
+int cache_key(int md_alg, const cert_t *cert, STACK_OF(X509_EXTENSION) * sk,
+	      unsigned char key[CACHE_KEY_SIZE])
+{
+	const cert_t *issuer_cert = &certs[cert->issuer];
+	EVP_PKEY *pkey = keys[cert->key].key;
+	EVP_PKEY *ikey = keys[issuer_cert->key].key;
+	EVP_MD_CTX *mdctx;
+	unsigned int len;
+	int i, rc = 0;
+
+	mdctx = EVP_MD_CTX_new();
+	if (mdctx == NULL) {
+		return 0;
+	}
+
+	if (!EVP_DigestInit_ex(mdctx, EVP_sha256(), NULL) ||
+	    !EVP_DigestUpdate(mdctx, &md_alg, sizeof(md_alg)) ||
+	    !EVP_DigestUpdate(mdctx, cert->cn, strlen(cert->cn) + 1) ||
+	    !EVP_DigestUpdate(mdctx, issuer_cert->cn,
+			      strlen(issuer_cert->cn) + 1) ||
+	    !cache_digest_key(mdctx, (pkey != NULL) ? pkey : ikey) ||
+	    !cache_digest_key(mdctx, ikey)) {
+		goto END;
+	}
+
+	for (i = 0; i < sk_X509_EXTENSION_num(sk); i++) {
+		unsigned char *der = NULL;
+		int der_len;
+
+		der_len = i2d_X509_EXTENSION(sk_X509_EXTENSION_value(sk, i),
+					     &der);
+		if (!cache_digest_der(mdctx, der, der_len)) {
+			goto END;
+		}
+	}
+
+	rc = EVP_DigestFinal_ex(mdctx, key, &len);
+
+END:
+	EVP_MD_CTX_free(mdctx);
+	return rc;
+}
+
+static void cache_path(char *path, const char *dir,
+		       const unsigned char key[CACHE_KEY_SIZE])
+{
+	int i, n;
+
+	n = snprintf(path, CACHE_PATH_MAX_LEN, "%s/", dir);
+	for (i = 0; i < CACHE_KEY_SIZE; i++) {
+		n += snprintf(&path[n], CACHE_PATH_MAX_LEN - n, "%02x", key[i]);
+	}
+	snprintf(&path[n], CACHE_PATH_MAX_LEN - n, ".crt");
+}
+
+/*
+ * Look up a certificate in the cache. Return NULL if it is not there, or if
+ * the cached certificate is not signed by the issuer key of 'cert' or does not
+ * hold its public key, for instance if the file was swapped.
+ */
+X509 *cache_load(const char *dir, const unsigned char key[CACHE_KEY_SIZE],
+		 const cert_t *cert)
+{
+	EVP_PKEY *pkey = keys[cert->key].key;
+	EVP_PKEY *ikey = keys[certs[cert->issuer].key].key;
+	char path[CACHE_PATH_MAX_LEN];
+	FILE *file;
+	X509 *x;
+
+	cache_path(path, dir, key);
+	file = fopen(path, "rb");
+	if (file == NULL) {
+		return NULL;
+	}
+
+	x = d2i_X509_fp(file, NULL);
+	fclose(file);
+	if (x == NULL) {
+		return NULL;
+	}
+
+	/* Self-signed certificates hold the key of their issuer */
+	if (pkey == NULL) {
+		pkey = ikey;
+	}
+
+	if ((X509_verify(x, ikey) != 1) ||
+	    (EVP_PKEY_eq(X509_get0_pubkey(x), pkey) != 1)) {
+		WARN("Ignoring cached %s, it does not match its keys\n",
+		     cert->cn);
+		X509_free(x);
+		return NULL;
+	}
+
+	return x;
+}
+
+/*
+ * Add a certificate to the cache. The certificate is written to a temporary
+ * file first, so that concurrent builds sharing the cache never see a
+ * partial one.
+ */
+int cache_store(const char *dir, const unsigned char key[CACHE_KEY_SIZE],
+		X509 *x)
+{
+	char path[CACHE_PATH_MAX_LEN], tmp[CACHE_PATH_MAX_LEN + 8];
+	FILE *file;
+	int fd, rc;
+
+	cache_path(path, dir, key);
+	snprintf(tmp, sizeof(tmp), "%s.XXXXXX", path);
+
+	fd = mkstemp(tmp);
+	if (fd == -1) {
+		return 0;
+	}
+
+	file = fdopen(fd, "wb");
+	if (file == NULL) {
+		close(fd);
+		unlink(tmp);
+		return 0;
+	}
+
+	rc = i2d_X509_fp(file, x);
+	if ((fclose(file) != 0) || !rc || (rename(tmp, path) != 0)) {
+		unlink(tmp);
+		return 0;
+	}
+
+	return 1;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2021, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -19,11 +19,13 @@
 #include <openssl/sha.h>
 #include <openssl/x509v3.h>
 
+#include "cache.h"
 #include "cert.h"
 #include "cmd_opt.h"
 #include "debug.h"
 #include "ext.h"
 #include "key.h"
+#include "pool.h"
 #include "sha.h"
 
 /*
@@ -58,6 +60,9 @@
 #define NUM_ELEM(x)			((sizeof(x)) / (sizeof(x[0])))
 #define HELP_OPT_MAX_LEN		128
 
+/* Long options without a short form, out of the range of the CMD_OPT_* */
+#define OPT_STATS			0x100
+
 /* Global options */
 static int key_alg;
 static int hash_alg;
@@ -65,6 +70,13 @@ static int key_size;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static unsigned int jobs;
+static const char *cache_dir;
+static int print_stats;
+
+/* Image hash algorithm */
+static const EVP_MD *md_info;
+static unsigned int md_len;
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -288,25 +300,195 @@ static const cmd_opt_t common_cmd_opt[] = {
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of keys and certificates created in parallel (default: number of CPUs)"
+	},
+	{
+		{ "cache-dir", required_argument, NULL, 'c' },
+		"Reuse the certificates of previous runs found in this directory, and add the new ones to it"
+	},
+	{
+		{ "stats", no_argument, NULL, OPT_STATS },
+		"Print the time taken to read and hash each image"
 	}
 };
 
-int main(int argc, char *argv[])
+/*
+ * Load a private key from its file, or generate a new one. Keys are
+ * independent of each other, so this runs in parallel for all keys.
+ */
+static void load_key(unsigned int i, void *arg)
+{
+	unsigned int err_code;
+
+	if (!key_new(&keys[i])) {
+		ERROR("Failed to allocate key container\n");
+		exit(1);
+	}
+
+	/* First try to load the key from disk */
+	if (key_load(&keys[i], &err_code)) {
+		/* Key loaded successfully */
+		return;
+	}
+
+	/* Key not loaded. Check the error code */
+	if (err_code == KEY_ERR_LOAD) {
+		/* File exists, but it does not contain a valid private
+		 * key. Abort. */
+		ERROR("Error loading '%s'\n", keys[i].fn);
+		exit(1);
+	}
+
+	/* File does not exist, could not be opened or no filename was
+	 * given */
+	if (new_keys) {
+		/* Try to create a new key */
+		NOTICE("Creating new key for '%s'\n", keys[i].desc);
+		if (!key_create(&keys[i], key_alg, key_size)) {
+			ERROR("Error creating key '%s'\n", keys[i].desc);
+			exit(1);
+		}
+	} else {
+		if (err_code == KEY_ERR_OPEN) {
+			ERROR("Error opening '%s'\n", keys[i].fn);
+		} else {
+			ERROR("Key '%s' not specified\n", keys[i].desc);
+		}
+		exit(1);
+	}
+}
+
+/*
+ * Create a certificate, hashing the images it refers to. This runs in
+ * parallel for the certificates whose issuer certificate has been created.
+ */
+static void create_cert(unsigned int i, void *arg)
 {
 	STACK_OF(X509_EXTENSION) * sk;
 	X509_EXTENSION *cert_ext = NULL;
+	ext_t *ext;
+	cert_t *cert = &certs[i];
+	int j, ext_nid, nvctr;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+	unsigned char key[CACHE_KEY_SIZE];
+	file_stream_stats_t stats;
+	int cached = 0;
+
+	if (cert->fn == NULL) {
+		/* Certificate not requested. Skip to the next one */
+		return;
+	}
+
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+
+		ext = &extensions[cert->ext[j]];
+
+		/* Get OpenSSL internal ID for this extension */
+		CHECK_OID(ext_nid, ext->oid);
+
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->optional && ext->arg == NULL) {
+				/* Skip this NVCounter */
+				continue;
+			} else {
+				/* Checked by `check_cmd_params` */
+				assert(ext->arg != NULL);
+				nvctr = atoi(ext->arg);
+				CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, nvctr));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			if (ext->arg == NULL) {
+				if (ext->optional) {
+					/* Include a hash filled with zeros */
+					memset(md, 0x0, SHA512_DIGEST_LENGTH);
+				} else {
+					/* Do not include this hash in the certificate */
+					continue;
+				}
+			} else {
+				/* Calculate the hash of the file */
+				if (!sha_file(hash_alg, ext->arg, md, &stats)) {
+					ERROR("Cannot calculate hash of %s\n",
+						ext->arg);
+					exit(1);
+				}
+				if (print_stats) {
+					file_stream_print_stats(ext->arg,
+								&stats);
+				}
+			}
+			CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+					EXT_CRIT, md_info, md,
+					md_len));
+			break;
+		case EXT_TYPE_PKEY:
+			CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->attr.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type '%d' in %s\n",
+					ext->type, cert->cn);
+			exit(1);
+		}
+
+		/* Push the extension into the stack */
+		sk_X509_EXTENSION_push(sk, cert_ext);
+	}
+
+	/* Reuse the certificate if it has not changed since it was cached */
+	if (cache_dir != NULL && cache_key(hash_alg, cert, sk, key)) {
+		cached = 1;
+		cert->x = cache_load(cache_dir, key, cert);
+	}
+
+	if (cert->x != NULL) {
+		NOTICE("Reusing cached %s\n", cert->cn);
+	} else {
+		/* Create certificate. Signed with corresponding key */
+		if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
+			ERROR("Cannot create %s\n", cert->cn);
+			exit(1);
+		}
+
+		if (cached && !cache_store(cache_dir, key, cert->x)) {
+			WARN("Cannot add %s to the cache\n", cert->cn);
+		}
+	}
+
+	for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
+			cert_ext = sk_X509_EXTENSION_pop(sk)) {
+		X509_EXTENSION_free(cert_ext);
+	}
+
+	sk_X509_EXTENSION_free(sk);
+}
+
+int main(int argc, char *argv[])
+{
 	ext_t *ext;
 	key_t *key;
 	cert_t *cert;
 	FILE *file;
-	int i, j, ext_nid, nvctr;
+	int i, *deps;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
 	const char *cur_opt;
-	unsigned int err_code;
-	unsigned char md[SHA512_DIGEST_LENGTH];
-	unsigned int  md_len;
-	const EVP_MD *md_info;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -315,6 +497,7 @@ int main(int argc, char *argv[])
 	key_alg = KEY_ALG_RSA;
 	hash_alg = HASH_ALG_SHA256;
 	key_size = -1;
+	jobs = pool_default_jobs();
 
 	/* Add common command line options */
 	for (i = 0; i < NUM_ELEM(common_cmd_opt); i++) {
@@ -344,7 +527,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:b:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:b:c:hj:knps:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -366,9 +549,19 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'c':
+			cache_dir = optarg;
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			exit(0);
+		case 'j':
+			if (atoi(optarg) <= 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			jobs = atoi(optarg);
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -378,6 +571,9 @@ int main(int argc, char *argv[])
 		case 'p':
 			print_cert = 1;
 			break;
+		case OPT_STATS:
+			print_stats = 1;
+			break;
 		case 's':
 			hash_alg = get_hash_alg(optarg);
 			if (hash_alg < 0) {
@@ -429,134 +625,27 @@ int main(int argc, char *argv[])
 	}
 
 	/* Load private keys from files (or generate new ones) */
-	for (i = 0 ; i < num_keys ; i++) {
-		if (!key_new(&keys[i])) {
-			ERROR("Failed to allocate key container\n");
-			exit(1);
-		}
+	pool_run(jobs, num_keys, NULL, load_key, NULL);
 
-		/* First try to load the key from disk */
-		if (key_load(&keys[i], &err_code)) {
-			/* Key loaded successfully */
-			continue;
-		}
-
-		/* Key not loaded. Check the error code */
-		if (err_code == KEY_ERR_LOAD) {
-			/* File exists, but it does not contain a valid private
-			 * key. Abort. */
-			ERROR("Error loading '%s'\n", keys[i].fn);
-			exit(1);
-		}
-
-		/* File does not exist, could not be opened or no filename was
-		 * given */
-		if (new_keys) {
-			/* Try to create a new key */
-			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg, key_size)) {
-				ERROR("Error creating key '%s'\n", keys[i].desc);
-				exit(1);
-			}
-		} else {
-			if (err_code == KEY_ERR_OPEN) {
-				ERROR("Error opening '%s'\n", keys[i].fn);
-			} else {
-				ERROR("Key '%s' not specified\n", keys[i].desc);
-			}
-			exit(1);
-		}
+	/*
+	 * Create the certificates. A certificate needs the one of its issuer,
+	 * if requested, to be created first.
+	 */
+	deps = malloc(num_certs * sizeof(*deps));
+	if (deps == NULL) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		exit(1);
 	}
-
-	/* Create the certificates */
 	for (i = 0 ; i < num_certs ; i++) {
-
 		cert = &certs[i];
-
-		if (cert->fn == NULL) {
-			/* Certificate not requested. Skip to the next one */
-			continue;
+		deps[i] = -1;
+		if ((cert->issuer != i) && (certs[cert->issuer].fn != NULL)) {
+			deps[i] = cert->issuer;
 		}
-
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
-
-		for (j = 0 ; j < cert->num_ext ; j++) {
-
-			ext = &extensions[cert->ext[j]];
-
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
-
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->optional && ext->arg == NULL) {
-					/* Skip this NVCounter */
-					continue;
-				} else {
-					/* Checked by `check_cmd_params` */
-					assert(ext->arg != NULL);
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
-				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA512_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						continue;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
-				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						md_len));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
-			}
-
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
-		}
-
-		/* Create certificate. Signed with corresponding key */
-		if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
-			exit(1);
-		}
-
-		for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
-				cert_ext = sk_X509_EXTENSION_pop(sk)) {
-			X509_EXTENSION_free(cert_ext);
-		}
-
-		sk_X509_EXTENSION_free(sk);
 	}
 
+	pool_run(jobs, num_certs, deps, create_cert, NULL);
+	free(deps);
 
 	/* Print the certificates */
 	if (print_cert) {
@@ -1,17 +1,17 @@
 /*
- * Copyright (c) 2015-2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <stdio.h>
 #include "debug.h"
+#include "file_stream.h"
 #include "key.h"
+#include "sha.h"
 #include <openssl/evp.h>
 #include <openssl/obj_mac.h>
 
-#define BUFFER_SIZE	256
-
 static int get_algorithm_nid(int hash_alg)
 {
 	int nids[] = {NID_sha256, NID_sha384, NID_sha512};
@@ -21,30 +21,32 @@ static int get_algorithm_nid(int hash_alg)
 	return nids[hash_alg];
 }
 
-int sha_file(int md_alg, const char *filename, unsigned char *md)
+static int sha_update(void *ctx, const unsigned char *data, size_t len)
+{
+	return (EVP_DigestUpdate(ctx, data, len) == 1) ? 0 : -1;
+}
+
+/*
+ * Calculate the hash of a file, read through the shared file stream. 'stats'
+ * may be NULL.
+ */
+int sha_file(int md_alg, const char *filename, unsigned char *md,
+	     file_stream_stats_t *stats)
 {
-	FILE *inFile;
 	EVP_MD_CTX *mdctx;
 	const EVP_MD *md_type;
-	int bytes;
+	file_stream_consumer_t consumer;
 	int alg_nid;
+	int rc = 0;
 	unsigned int total_bytes;
-	unsigned char data[BUFFER_SIZE];
 
 	if ((filename == NULL) || (md == NULL)) {
 		ERROR("%s(): NULL argument\n", __func__);
 		return 0;
 	}
 
-	inFile = fopen(filename, "rb");
-	if (inFile == NULL) {
-		ERROR("Cannot read %s\n", filename);
-		return 0;
-	}
-
 	mdctx = EVP_MD_CTX_new();
 	if (mdctx == NULL) {
-		fclose(inFile);
 		ERROR("%s(): Could not create EVP MD context\n", __func__);
 		return 0;
 	}
@@ -61,18 +63,16 @@ int sha_file(int md_alg, const char *filename, unsigned char *md)
 		goto err;
 	}
 
-	while ((bytes = fread(data, 1, BUFFER_SIZE, inFile)) != 0) {
-		EVP_DigestUpdate(mdctx, data, bytes);
+	consumer.fn = sha_update;
+	consumer.ctx = mdctx;
+	if ((file_stream_read(filename, &consumer, 1, stats) != 0) ||
+	    (EVP_DigestFinal_ex(mdctx, md, &total_bytes) == 0)) {
+		goto err;
 	}
-	EVP_DigestFinal_ex(mdctx, md, &total_bytes);
 
-	fclose(inFile);
-	EVP_MD_CTX_free(mdctx);
-	return 1;
+	rc = 1;
 
 err:
-	fclose(inFile);
 	EVP_MD_CTX_free(mdctx);
-	return 0;
+	return rc;
 }
-
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2023, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Streaming input shared by the host tools. A file is read once, by mapping
+ * it or, when it cannot be mapped, through large reads, and each chunk is
+ * handed to all the consumers of the file in turn while it is still in the
+ * cache.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "debug.h"
+#include "file_stream.h"
+
+static uint64_t file_stream_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+static int file_stream_feed(const file_stream_consumer_t *consumers,
+			    unsigned int num_consumers,
+			    const unsigned char *data, size_t len)
+{
+	unsigned int i;
+
+	for (i = 0; i < num_consumers; i++) {
+		if (consumers[i].fn(consumers[i].ctx, data, len) != 0) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int file_stream_mapped(int fd, size_t size,
+			      const file_stream_consumer_t *consumers,
+			      unsigned int num_consumers)
+{
+	const unsigned char *data;
+	size_t off, len;
+	int rc = 0;
+
+	data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (data == MAP_FAILED) {
+		return 1;
+	}
+
+	for (off = 0; (rc == 0) && (off < size); off += len) {
+		len = size - off;
+		if (len > FILE_STREAM_CHUNK_SIZE) {
+			len = FILE_STREAM_CHUNK_SIZE;
+		}
+		rc = file_stream_feed(consumers, num_consumers, &data[off],
+				      len);
+	}
+
+	munmap((void *)data, size);
+	return rc;
+}
+
+static int file_stream_buffered(int fd, const file_stream_consumer_t *consumers,
+				unsigned int num_consumers, uint64_t *bytes)
+{
+	unsigned char *buf;
+	ssize_t len;
+	int rc = 0;
+
+	buf = malloc(FILE_STREAM_CHUNK_SIZE);
+	if (buf == NULL) {
+		return -1;
+	}
+
+	*bytes = 0;
+	while (rc == 0) {
+		len = read(fd, buf, FILE_STREAM_CHUNK_SIZE);
+		if (len <= 0) {
+			rc = (len < 0) ? -1 : 0;
+			break;
+		}
+		*bytes += len;
+		rc = file_stream_feed(consumers, num_consumers, buf, len);
+	}
+
+	free(buf);
+	return rc;
+}
+
+/*
+ * Read a file once and pass its content to all the consumers. Return 0 on
+ * success, -1 if the file cannot be read or a consumer fails. 'stats' may be
+ * NULL.
+ */
+int file_stream_read(const char *filename,
+		     const file_stream_consumer_t *consumers,
+		     unsigned int num_consumers, file_stream_stats_t *stats)
+{
+	struct stat st;
+	uint64_t start, bytes = 0;
+	int fd, rc = -1;
+
+	start = file_stream_now();
+
+	fd = open(filename, O_RDONLY);
+	if (fd == -1) {
+		ERROR("Cannot read %s\n", filename);
+		return -1;
+	}
+
+	if (fstat(fd, &st) == -1) {
+		ERROR("Cannot read %s\n", filename);
+		goto out;
+	}
+
+	/* Map regular files. Anything else, or an empty file, is read. */
+	rc = 1;
+	if (S_ISREG(st.st_mode) && (st.st_size != 0)) {
+		bytes = st.st_size;
+		rc = file_stream_mapped(fd, st.st_size, consumers,
+					num_consumers);
+	}
+	if (rc == 1) {
+		rc = file_stream_buffered(fd, consumers, num_consumers,
+					  &bytes);
+	}
+	if (rc != 0) {
+		ERROR("Cannot process %s\n", filename);
+	}
+
+out:
+	close(fd);
+
+	if (stats != NULL) {
+		stats->bytes = bytes;
+		stats->nsecs = file_stream_now() - start;
+	}
+
+	return rc;
+}
+
+void file_stream_print_stats(const char *name,
+			     const file_stream_stats_t *stats)
+{
+	double secs = (double)stats->nsecs / 1e9;
+
+	printf("%-48s %12llu bytes %10.3f ms %10.1f MiB/s\n", name,
+	       (unsigned long long)stats->bytes, secs * 1e3,
+	       (secs > 0.0) ? (double)stats->bytes / secs / (1024 * 1024) :
+			      0.0);
+}
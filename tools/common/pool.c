@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2023, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "debug.h"
+#include "pool.h"
+
+/* Task states */
+enum {
+	TASK_PENDING,
+	TASK_RUNNING,
+	TASK_DONE
+};
+
+typedef struct pool_s {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;	/* Signalled when a task completes */
+	unsigned int num;
+	unsigned int num_pending;
+	const int *deps;
+	unsigned char *state;
+	pool_task_fn_t task;
+	void *arg;
+} pool_t;
+
+/*
+ * Number of workers used by default: one per online CPU.
+ */
+unsigned int pool_default_jobs(void)
+{
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (n > 0) ? (unsigned int)n : 1U;
+}
+
+/*
+ * Return the index of a pending task whose dependency has completed, or -1 if
+ * there is none. Called with the pool lock held.
+ */
+static int pool_next_task(pool_t *pool)
+{
+	unsigned int i;
+	int dep;
+
+	for (i = 0; i < pool->num; i++) {
+		if (pool->state[i] != TASK_PENDING) {
+			continue;
+		}
+		dep = (pool->deps != NULL) ? pool->deps[i] : -1;
+		if ((dep < 0) || (pool->state[dep] == TASK_DONE)) {
+			return (int)i;
+		}
+	}
+
+	return -1;
+}
+
+static void *pool_worker(void *p)
+{
+	pool_t *pool = p;
+	int idx;
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->num_pending != 0) {
+		idx = pool_next_task(pool);
+		if (idx < 0) {
+			/* Wait for a running task to unblock a pending one */
+			pthread_cond_wait(&pool->cond, &pool->lock);
+			continue;
+		}
+
+		pool->state[idx] = TASK_RUNNING;
+		pool->num_pending--;
+		pthread_mutex_unlock(&pool->lock);
+
+		pool->task(idx, pool->arg);
+
+		pthread_mutex_lock(&pool->lock);
+		pool->state[idx] = TASK_DONE;
+		pthread_cond_broadcast(&pool->cond);
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	return NULL;
+}
+
+/*
+ * Run the 'num' tasks on up to 'jobs' threads, including the calling one, and
+ * return once all of them have completed. Task 'i' is only started once task
+ * 'deps[i]' has completed, unless 'deps' is NULL or 'deps[i]' is negative.
+ * The dependencies must not form a cycle.
+ */
+void pool_run(unsigned int jobs, unsigned int num, const int *deps,
+	      pool_task_fn_t task, void *arg)
+{
+	pool_t pool;
+	pthread_t *threads;
+	unsigned int i, nr_threads = 0;
+
+	assert(task != NULL);
+
+	if (num == 0) {
+		return;
+	}
+
+	pool.num = num;
+	pool.num_pending = num;
+	pool.deps = deps;
+	pool.task = task;
+	pool.arg = arg;
+	pool.state = calloc(num, sizeof(*pool.state));
+	threads = calloc(num, sizeof(*threads));
+	if ((pool.state == NULL) || (threads == NULL)) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		exit(1);
+	}
+	pthread_mutex_init(&pool.lock, NULL);
+	pthread_cond_init(&pool.cond, NULL);
+
+	/* The calling thread is one of the workers */
+	if (jobs > num) {
+		jobs = num;
+	}
+	for (i = 1; i < jobs; i++) {
+		if (pthread_create(&threads[nr_threads], NULL, pool_worker,
+				   &pool) != 0) {
+			/* Carry on with the threads created so far */
+			break;
+		}
+		nr_threads++;
+	}
+
+	pool_worker(&pool);
+
+	for (i = 0; i < nr_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	pthread_cond_destroy(&pool.cond);
+	pthread_mutex_destroy(&pool.lock);
+	free(threads);
+	free(pool.state);
+}
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+"""Decode a dump of the BL31 EL3 trace buffer.
+
+The buffer layout is described in include/lib/el3_trace/el3_trace.h. The dump
+is a raw copy of the buffer handed to BL31 with EL3_TRACE_CMD_INIT, e.g. taken
+from the Normal world or from a debugger.
+"""
+
+import argparse
+import struct
+import sys
+
+EL3_TRACE_MAGIC = 0x45335452
+EL3_TRACE_VERSION = 1
+
+HDR_FMT = '<IIIIQ40x'
+CPU_FMT = '<Q56x'
+ENTRY_FMT = '<QIIQQ'
+
+EVENTS = {
+    0x01: ('SMC', 'flags=0x{arg0:x} fid=0x{arg1:x} x1=0x{arg2:x}'),
+    0x10: ('EHF_ACTIVATE', 'pri=0x{arg0:x}'),
+    0x11: ('EHF_DEACTIVATE', 'pri=0x{arg0:x}'),
+    0x20: ('SPMD_SWITCH', 'to={arg0} fid=0x{arg1:x} x1=0x{arg2:x}'),
+    0x30: ('PSCI_CPU_ON', 'mpidr=0x{arg1:x} ep=0x{arg2:x}'),
+    0x31: ('PSCI_CPU_OFF', ''),
+    0x32: ('PSCI_CPU_SUSPEND', 'power_state=0x{arg0:x} ep=0x{arg1:x}'),
+    0x33: ('PSCI_WAKEUP', 'end_pwrlvl={arg0}'),
+}
+
+
+def read_cpu_events(data, cpu, head, entries, ring_base):
+    """Return the valid entries of one CPU ring, oldest first."""
+    entry_size = struct.calcsize(ENTRY_FMT)
+    first = max(0, head - entries)
+    events = []
+
+    for seq in range(first, head):
+        off = ring_base + ((cpu * entries) + (seq % entries)) * entry_size
+        ts, ev_id, arg0, arg1, arg2 = struct.unpack_from(ENTRY_FMT, data, off)
+        events.append((ts, cpu, seq, ev_id, arg0, arg1, arg2))
+
+    return events
+
+
+def decode(data, merge):
+    magic, version, num_cpus, entries, freq = struct.unpack_from(HDR_FMT, data)
+    if magic != EL3_TRACE_MAGIC:
+        sys.exit('error: bad magic 0x{:x}'.format(magic))
+    if version != EL3_TRACE_VERSION:
+        sys.exit('error: unsupported version {}'.format(version))
+
+    cpu_base = struct.calcsize(HDR_FMT)
+    ring_base = cpu_base + num_cpus * struct.calcsize(CPU_FMT)
+
+    events = []
+    for cpu in range(num_cpus):
+        (head,) = struct.unpack_from(CPU_FMT, data,
+                                     cpu_base + cpu * struct.calcsize(CPU_FMT))
+        events.extend(read_cpu_events(data, cpu, head, entries, ring_base))
+
+    if merge:
+        events.sort(key=lambda e: e[0])
+
+    for ts, cpu, seq, ev_id, arg0, arg1, arg2 in events:
+        name, fmt = EVENTS.get(ev_id, ('0x{:x}'.format(ev_id),
+                                       '0x{arg0:x} 0x{arg1:x} 0x{arg2:x}'))
+        usecs = (ts * 1000000) // freq if freq else ts
+        print('{:>16} cpu{:<3} #{:<8} {:<18} {}'.format(
+            usecs, cpu, seq, name,
+            fmt.format(arg0=arg0, arg1=arg1, arg2=arg2)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('dump', help='raw dump of the trace buffer')
+    parser.add_argument('--per-cpu', action='store_true',
+                        help='print each CPU ring in turn instead of merging '
+                             'all CPUs by timestamp')
+    args = parser.parse_args()
+
+    with open(args.dump, 'rb') as f:
+        data = f.read()
+
+    decode(data, not args.per_cpu)
+
+
+if __name__ == '__main__':
+    main()
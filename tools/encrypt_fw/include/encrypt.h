@@ -1,5 +1,6 @@
 /*
  * Copyright (c) 2019, Linaro Limited. All rights reserved.
+ * Copyright (c) 2023, ARM Limited and Contributors. All rights reserved.
  * Author: Sumit Garg <sumit.garg@linaro.org>
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -8,12 +9,15 @@
 #ifndef ENCRYPT_H
 #define ENCRYPT_H
 
+#include <file_stream.h>
+
 /* Supported key algorithms */
 enum {
 	KEY_ALG_GCM		/* AES-GCM (default) */
 };
 
 int encrypt_file(unsigned short fw_enc_status, int enc_alg, char *key_string,
-		 char *nonce_string, const char *ip_name, const char *op_name);
+		 char *nonce_string, const char *ip_name, const char *op_name,
+		 file_stream_stats_t *stats);
 
 #endif /* ENCRYPT_H */
@@ -1,35 +1,65 @@
 /*
  * Copyright (c) 2019, Linaro Limited. All rights reserved.
+ * Copyright (c) 2023, ARM Limited and Contributors. All rights reserved.
  * Author: Sumit Garg <sumit.garg@linaro.org>
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <file_stream.h>
 #include <firmware_encrypted.h>
 #include <openssl/evp.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "debug.h"
 #include "encrypt.h"
 
-#define BUFFER_SIZE		256
 #define IV_SIZE			12
 #define IV_STRING_SIZE		24
 #define TAG_SIZE		16
 #define KEY_SIZE		32
 #define KEY_STRING_SIZE		64
 
+/* State of the encryption of a file, fed by the file stream */
+struct gcm_stream {
+	EVP_CIPHER_CTX *ctx;
+	FILE *op_file;
+	const char *op_name;
+	unsigned char *enc_data;	/* FILE_STREAM_CHUNK_SIZE bytes */
+};
+
+static int gcm_update(void *arg, const unsigned char *data, size_t len)
+{
+	struct gcm_stream *stream = arg;
+	int enc_len = 0;
+
+	if (EVP_EncryptUpdate(stream->ctx, stream->enc_data, &enc_len, data,
+			      len) != 1) {
+		ERROR("EVP_EncryptUpdate failed\n");
+		return -1;
+	}
+
+	if (fwrite(stream->enc_data, 1, enc_len, stream->op_file) != enc_len) {
+		ERROR("Cannot write %s\n", stream->op_name);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 		       char *nonce_string, const char *ip_name,
-		       const char *op_name)
+		       const char *op_name, file_stream_stats_t *stats)
 {
-	FILE *ip_file;
 	FILE *op_file;
 	EVP_CIPHER_CTX *ctx;
-	unsigned char data[BUFFER_SIZE], enc_data[BUFFER_SIZE];
+	unsigned char enc_data[TAG_SIZE];
 	unsigned char key[KEY_SIZE], iv[IV_SIZE], tag[TAG_SIZE];
-	int bytes, enc_len = 0, i, j, ret = 0;
+	int enc_len = 0, i, j, ret = 0;
 	struct fw_enc_hdr header;
+	struct gcm_stream stream;
+	file_stream_consumer_t consumer;
 
 	memset(&header, 0, sizeof(struct fw_enc_hdr));
 
@@ -57,16 +87,9 @@ static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 		}
 	}
 
-	ip_file = fopen(ip_name, "rb");
-	if (ip_file == NULL) {
-		ERROR("Cannot read %s\n", ip_name);
-		return -1;
-	}
-
 	op_file = fopen(op_name, "wb");
 	if (op_file == NULL) {
 		ERROR("Cannot write %s\n", op_name);
-		fclose(ip_file);
 		return -1;
 	}
 
@@ -96,15 +119,23 @@ static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 		goto out;
 	}
 
-	while ((bytes = fread(data, 1, BUFFER_SIZE, ip_file)) != 0) {
-		ret = EVP_EncryptUpdate(ctx, enc_data, &enc_len, data, bytes);
-		if (ret != 1) {
-			ERROR("EVP_EncryptUpdate failed\n");
-			ret = -1;
-			goto out;
-		}
+	stream.ctx = ctx;
+	stream.op_file = op_file;
+	stream.op_name = op_name;
+	stream.enc_data = malloc(FILE_STREAM_CHUNK_SIZE);
+	if (stream.enc_data == NULL) {
+		ERROR("Cannot allocate encryption buffer\n");
+		ret = -1;
+		goto out;
+	}
 
-		fwrite(enc_data, 1, enc_len, op_file);
+	consumer.fn = gcm_update;
+	consumer.ctx = &stream;
+	ret = file_stream_read(ip_name, &consumer, 1, stats);
+	free(stream.enc_data);
+	if (ret != 0) {
+		ret = -1;
+		goto out;
 	}
 
 	ret = EVP_EncryptFinal_ex(ctx, enc_data, &enc_len);
@@ -141,7 +172,6 @@ out:
 	EVP_CIPHER_CTX_free(ctx);
 
 out_file:
-	fclose(ip_file);
 	fclose(op_file);
 
 	/*
@@ -155,12 +185,13 @@ out_file:
 }
 
 int encrypt_file(unsigned short fw_enc_status, int enc_alg, char *key_string,
-		 char *nonce_string, const char *ip_name, const char *op_name)
+		 char *nonce_string, const char *ip_name, const char *op_name,
+		 file_stream_stats_t *stats)
 {
 	switch (enc_alg) {
 	case KEY_ALG_GCM:
 		return gcm_encrypt(fw_enc_status, key_string, nonce_string,
-				   ip_name, op_name);
+				   ip_name, op_name, stats);
 	default:
 		return -1;
 	}
@@ -1,16 +1,20 @@
 /*
  * Copyright (c) 2019, Linaro Limited. All rights reserved.
+ * Copyright (c) 2023, ARM Limited and Contributors. All rights reserved.
  * Author: Sumit Garg <sumit.garg@linaro.org>
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <stdbool.h>
 
 #include <openssl/conf.h>
@@ -18,12 +22,35 @@
 #include "cmd_opt.h"
 #include "debug.h"
 #include "encrypt.h"
+#include "file_stream.h"
 #include "firmware_encrypted.h"
+#include "pool.h"
 
 #define NUM_ELEM(x)			((sizeof(x)) / (sizeof(x[0])))
 #define HELP_OPT_MAX_LEN		128
 
+/* Options without a short format */
+#define OPT_STATS			0x100
+
+/*
+ * Image to encrypt. The n-th '--in' is paired with the n-th '--out' and, when
+ * several nonces are given, with the n-th '--nonce'.
+ */
+typedef struct image_s {
+	const char *in_fn;
+	const char *out_fn;
+	char *nonce;
+	file_stream_stats_t stats;
+	int ret;
+} image_t;
+
 /* Global options */
+static int key_alg;
+static char *key;
+static unsigned short fw_enc_status;
+static int print_stats;
+
+static image_t *images;
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -128,23 +155,44 @@ static const cmd_opt_t common_cmd_opt[] = {
 		{ "out", required_argument, NULL, 'o' },
 		"Encrypted output filename."
 	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of images encrypted in parallel (default: number of CPUs)"
+	},
+	{
+		{ "stats", no_argument, NULL, OPT_STATS },
+		"Print the size of each image and the time taken to read it"
+	},
 };
 
+static void encrypt_image(unsigned int idx, void *arg)
+{
+	image_t *img = &images[idx];
+
+	img->ret = encrypt_file(fw_enc_status, key_alg, key, img->nonce,
+				img->in_fn, img->out_fn, &img->stats);
+}
+
 int main(int argc, char *argv[])
 {
-	int i, key_alg, ret;
+	int i, j, ret;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
-	char *key = NULL;
-	char *nonce = NULL;
-	char *in_fn = NULL;
-	char *out_fn = NULL;
-	unsigned short fw_enc_status = 0;
+	unsigned int num_in = 0, num_out = 0, num_nonces = 0;
+	unsigned int jobs;
 
 	NOTICE("Firmware Encryption Tool: %s\n", build_msg);
 
 	/* Set default options */
 	key_alg = KEY_ALG_GCM;
+	jobs = pool_default_jobs();
+
+	/* There cannot be more images than arguments */
+	images = calloc(argc, sizeof(image_t));
+	if (images == NULL) {
+		ERROR("Cannot allocate memory\n");
+		exit(1);
+	}
 
 	/* Add common command line options */
 	for (i = 0; i < NUM_ELEM(common_cmd_opt); i++) {
@@ -156,7 +204,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:f:hi:k:n:o:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:f:hi:j:k:n:o:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -178,13 +226,23 @@ int main(int argc, char *argv[])
 			key = optarg;
 			break;
 		case 'i':
-			in_fn = optarg;
+			images[num_in++].in_fn = optarg;
+			break;
+		case 'j':
+			if (atoi(optarg) <= 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			jobs = atoi(optarg);
 			break;
 		case 'o':
-			out_fn = optarg;
+			images[num_out++].out_fn = optarg;
 			break;
 		case 'n':
-			nonce = optarg;
+			images[num_nonces++].nonce = optarg;
+			break;
+		case OPT_STATS:
+			print_stats = 1;
 			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
@@ -201,22 +259,59 @@ int main(int argc, char *argv[])
 		exit(1);
 	}
 
-	if (!nonce) {
+	if (num_nonces == 0) {
 		ERROR("Nonce must not be NULL\n");
 		exit(1);
 	}
 
-	if (!in_fn) {
+	if (num_in == 0) {
 		ERROR("Input filename must not be NULL\n");
 		exit(1);
 	}
 
-	if (!out_fn) {
-		ERROR("Output filename must not be NULL\n");
+	if (num_out != num_in) {
+		ERROR("One output filename is needed for each input file\n");
 		exit(1);
 	}
 
-	ret = encrypt_file(fw_enc_status, key_alg, key, nonce, in_fn, out_fn);
+	/*
+	 * All the images are encrypted with the same key, so each one needs its
+	 * own nonce: reusing a nonce with GCM reveals the key stream.
+	 */
+	if (num_in > 1) {
+		if (num_nonces != num_in) {
+			ERROR("One nonce is needed for each image\n");
+			exit(1);
+		}
+		for (i = 0; i < num_in; i++) {
+			for (j = i + 1; j < num_in; j++) {
+				if (strcasecmp(images[i].nonce,
+					       images[j].nonce) == 0) {
+					ERROR("Nonce '%s' used for two images\n",
+					      images[i].nonce);
+					exit(1);
+				}
+			}
+		}
+	} else {
+		/* As before, the last nonce given is used */
+		images[0].nonce = images[num_nonces - 1].nonce;
+	}
+
+	pool_run(jobs, num_in, NULL, encrypt_image, NULL);
+
+	ret = 0;
+	for (i = 0; i < num_in; i++) {
+		if (images[i].ret != 0) {
+			ERROR("Cannot encrypt %s\n", images[i].in_fn);
+			ret = images[i].ret;
+		} else if (print_stats) {
+			file_stream_print_stats(images[i].in_fn,
+						&images[i].stats);
+		}
+	}
+
+	free(images);
 
 	CRYPTO_cleanup_all_ex_data();
 
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test of the format of the Event Log written by
+ * drivers/measured_boot/event_log/event_log.c.
+ *
+ * event_log.c is included so that its offset macros and log pointer can be
+ * checked. The log is parsed again by the test, with the offsets of the TCG PC
+ * Client Platform Firmware Profile rather than the structures of tcg.h:
+ *
+ * - the Specification ID and Startup Locality events of the header;
+ * - for each image, the record of event_log_measure_and_record(), whose
+ *   digest must be at EVENT2_DIGEST_OFFSET and equal to the digest calculated
+ *   by OpenSSL, and which must match the record of event_log_record() for the
+ *   same digest byte for byte;
+ * - a measurement that fails must leave the log unchanged.
+ *
+ * The test is built once for each algorithm of MBOOT_EL_HASH_ALG.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <openssl/evp.h>
+
+#include <event_log.c>
+
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			fprintf(stderr, "%s:%d: check failed: %s\n",	\
+				__FILE__, __LINE__, #cond);		\
+			exit(1);					\
+		}							\
+	} while (0)
+
+#define LOG_SIZE	4096U
+#define IMAGE_SIZE	8192U
+
+/* Offsets of a TCG_PCR_EVENT2 with a single digest */
+#define REC_PCR_INDEX		0U
+#define REC_EVENT_TYPE		4U
+#define REC_DIGEST_COUNT	8U
+#define REC_ALG_ID		12U
+#define REC_DIGEST		14U
+#define REC_EVENT_SIZE		(REC_DIGEST + TCG_DIGEST_SIZE)
+#define REC_EVENT		(REC_EVENT_SIZE + 4U)
+
+/* Linker symbols of the memory layout of BL2, unused */
+char __RO_START__[1], __RO_END__[1], __RW_END__[1], __BL2_END__[1];
+
+static const event_log_metadata_t metadata[] = {
+	{ BL31_IMAGE_ID, EVLOG_BL31_STRING, PCR_0 },
+	{ BL32_IMAGE_ID, EVLOG_BL32_STRING, PCR_0 },
+	{ BL33_IMAGE_ID, EVLOG_BL33_STRING, PCR_0 },
+	{ HW_CONFIG_ID, EVLOG_HW_CONFIG_STRING, PCR_0 },
+	{ NT_FW_CONFIG_ID, EVLOG_NT_FW_CONFIG_STRING, PCR_1 },
+	{ SOC_FW_CONFIG_ID, NULL, PCR_1 },
+	{ EVLOG_INVALID_ID, NULL, (unsigned int)(-1) }
+};
+
+static const char *alg_name;
+static bool hash_fail;
+
+const event_log_metadata_t *plat_event_log_get_metadata(void)
+{
+	return metadata;
+}
+
+static const EVP_MD *evp_md(void)
+{
+	switch (TPM_ALG_ID) {
+	case TPM_ALG_SHA512:
+		alg_name = "SHA-512";
+		return EVP_sha512();
+	case TPM_ALG_SHA384:
+		alg_name = "SHA-384";
+		return EVP_sha384();
+	default:
+		alg_name = "SHA-256";
+		return EVP_sha256();
+	}
+}
+
+int crypto_mod_calc_hash(enum crypto_md_algo alg, void *data_ptr,
+			 unsigned int data_len,
+			 unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	unsigned int len;
+
+	CHECK(alg == CRYPTO_MD_ID);
+	if (hash_fail) {
+		/* A failing library may have written part of the digest */
+		memset(output, 0x5a, TCG_DIGEST_SIZE / 2U);
+		return -1;
+	}
+
+	CHECK(EVP_Digest(data_ptr, data_len, output, &len, evp_md(),
+			 NULL) == 1);
+	CHECK(len == TCG_DIGEST_SIZE);
+
+	return 0;
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+	       ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static bool all_zero(const uint8_t *p, size_t len)
+{
+	while (len-- != 0U) {
+		if (*p++ != 0U) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Check the Specification ID event, return its size */
+static size_t check_specid_event(const uint8_t *p)
+{
+	const uint8_t *ev = p + 32U;
+	uint32_t event_size = get_u32(p + 28U);
+
+	/* TCG_PCClientPCREvent */
+	CHECK(get_u32(p) == 0U);
+	CHECK(get_u32(p + 4U) == EV_NO_ACTION);
+	CHECK(all_zero(p + 8U, 20U));
+	CHECK(event_size == 33U);
+
+	/* TCG_EfiSpecIdEvent */
+	CHECK(memcmp(ev, "Spec ID Event03", 16U) == 0);
+	CHECK(get_u32(ev + 16U) == PLATFORM_CLASS_CLIENT);
+	CHECK(ev[20] == 0U);		/* specVersionMinor */
+	CHECK(ev[21] == 2U);		/* specVersionMajor */
+	CHECK(ev[22] == 2U);		/* specErrata */
+	CHECK(ev[23] == 1U);		/* uintnSize: UINT32 */
+	CHECK(get_u32(ev + 24U) == 1U);
+	CHECK(get_u16(ev + 28U) == TPM_ALG_ID);
+	CHECK(get_u16(ev + 30U) == TCG_DIGEST_SIZE);
+	CHECK(ev[32] == 0U);		/* vendorInfoSize */
+
+	return 32U + event_size;
+}
+
+/* Check the Startup Locality event, return its size */
+static size_t check_locality_event(const uint8_t *p)
+{
+	CHECK(get_u32(p + REC_PCR_INDEX) == 0U);
+	CHECK(get_u32(p + REC_EVENT_TYPE) == EV_NO_ACTION);
+	CHECK(get_u32(p + REC_DIGEST_COUNT) == 1U);
+	CHECK(get_u16(p + REC_ALG_ID) == TPM_ALG_ID);
+	CHECK(all_zero(p + REC_DIGEST, TCG_DIGEST_SIZE));
+	CHECK(get_u32(p + REC_EVENT_SIZE) == 17U);
+	CHECK(memcmp(p + REC_EVENT, "StartupLocality", 16U) == 0);
+	CHECK(p[REC_EVENT + 16U] == 0U);
+
+	return REC_EVENT + 17U;
+}
+
+/* Check a measurement record, return its size */
+static size_t check_record(const uint8_t *p, const event_log_metadata_t *md,
+			   const uint8_t *digest)
+{
+	uint32_t name_len = (md->name != NULL) ?
+			    ((uint32_t)strlen(md->name) + 1U) : 0U;
+
+	CHECK(get_u32(p + REC_PCR_INDEX) == md->pcr);
+	CHECK(get_u32(p + REC_EVENT_TYPE) == EV_POST_CODE);
+	CHECK(get_u32(p + REC_DIGEST_COUNT) == 1U);
+	CHECK(get_u16(p + REC_ALG_ID) == TPM_ALG_ID);
+	CHECK(memcmp(p + REC_DIGEST, digest, TCG_DIGEST_SIZE) == 0);
+	CHECK(get_u32(p + REC_EVENT_SIZE) == name_len);
+	if (name_len != 0U) {
+		CHECK(memcmp(p + REC_EVENT, md->name, name_len) == 0);
+	}
+
+	return REC_EVENT + name_len;
+}
+
+int main(void)
+{
+	static uint8_t log[LOG_SIZE], ref[LOG_SIZE];
+	static uint8_t image[IMAGE_SIZE];
+	uint8_t md[EVP_MAX_MD_SIZE];
+	const event_log_metadata_t *m;
+	size_t off, hdr_size, ref_size, size;
+	unsigned int i, len, n = 0U;
+	uint8_t *digest;
+
+	/* The record layout of the driver is the one of the specification */
+	CHECK(EVENT2_DIGEST_OFFSET == REC_DIGEST);
+	CHECK(EVENT2_DATA_OFFSET == REC_EVENT_SIZE);
+	CHECK(EVENT2_HDR_SIZE >= REC_EVENT);
+
+	for (i = 0U; i < IMAGE_SIZE; i++) {
+		image[i] = (uint8_t)rand();
+	}
+
+	/* Garbage in the buffers, to catch fields that are not written */
+	memset(log, 0xa5, sizeof(log));
+	memset(ref, 0x3c, sizeof(ref));
+
+	event_log_init(log, log + LOG_SIZE);
+	event_log_write_header();
+	hdr_size = event_log_get_cur_size(log);
+	off = check_specid_event(log);
+	off += check_locality_event(log + off);
+	CHECK(off == hdr_size);
+	CHECK(hdr_size == LOG_MIN_SIZE);
+
+	/* The same header, for the records of event_log_record() */
+	event_log_buf_init(ref, ref + LOG_SIZE);
+	event_log_write_header();
+	CHECK(event_log_get_cur_size(ref) == hdr_size);
+	CHECK(memcmp(log, ref, hdr_size) == 0);
+
+	for (m = metadata; m->id != EVLOG_INVALID_ID; m++, n++) {
+		size = IMAGE_SIZE - (n * 777U);
+		CHECK(EVP_Digest(image, size, md, &len, evp_md(), NULL) == 1);
+
+		/* event_log_record() with the digest calculated beforehand */
+		event_log_buf_init(ref + off, ref + LOG_SIZE);
+		event_log_record(md, EV_POST_CODE, m);
+		ref_size = event_log_get_cur_size(ref + off);
+
+		/* A failed measurement is not appended */
+		event_log_buf_init(log + off, log + LOG_SIZE);
+		hash_fail = true;
+		CHECK(event_log_measure_and_record((uintptr_t)image, size,
+						   m->id) != 0);
+		hash_fail = false;
+		CHECK(event_log_get_cur_size(log + off) == 0U);
+
+		/* The digest is calculated straight into the record */
+		CHECK(event_log_measure_and_record((uintptr_t)image, size,
+						   m->id) == 0);
+		CHECK(event_log_get_cur_size(log + off) == ref_size);
+		CHECK(memcmp(log + off + EVENT2_DIGEST_OFFSET, md,
+			     TCG_DIGEST_SIZE) == 0);
+		CHECK(memcmp(log + off, ref + off, ref_size) == 0);
+		CHECK(check_record(log + off, m, md) == ref_size);
+
+		off += ref_size;
+	}
+
+	/* A record reserved and ended by the caller, as DRTM does */
+	event_log_buf_init(log + off, log + LOG_SIZE);
+	digest = event_log_record_begin(EV_POST_CODE, &metadata[0]);
+	CHECK(digest == log + off + REC_DIGEST);
+	CHECK(EVP_Digest(image, 1U, digest, &len, evp_md(), NULL) == 1);
+	event_log_record_end(&metadata[0]);
+	CHECK(EVP_Digest(image, 1U, md, &len, evp_md(), NULL) == 1);
+	CHECK(check_record(log + off, &metadata[0], md) ==
+	      event_log_get_cur_size(log + off));
+
+	printf("%s: header and %u records match the TCG layout and event_log_record()\n",
+	       alg_name, n + 1U);
+
+	return 0;
+}
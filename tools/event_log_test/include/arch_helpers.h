@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host replacement of include/arch/aarch64/arch_helpers.h. The Event Log
+ * driver only needs the types.
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+#include <stdint.h>
+
+typedef uint64_t u_register_t;
+
+#endif /* ARCH_HELPERS_H */
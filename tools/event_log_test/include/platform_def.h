@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Platform definitions needed by the headers of the Event Log driver */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+#define NR_OF_FW_BANKS			2
+#define NR_OF_IMAGES_IN_FW_BANK		1
+
+#define PLAT_MAX_PWR_LVL		2
+#define PLAT_MAX_RET_STATE		1
+#define PLAT_MAX_OFF_STATE		2
+
+#endif /* PLATFORM_DEF_H */
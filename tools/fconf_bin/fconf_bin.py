@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+"""Convert a FW_CONFIG DTB into the pre-parsed FCONF binary format.
+
+The format is described in include/lib/fconf/fconf_bin.h. The DTB is embedded
+in the output, unless --no-dtb is given, so that the populators which only
+understand DTBs still work.
+"""
+
+import argparse
+import struct
+import sys
+
+FCONF_BIN_MAGIC = 0x4E424346
+FCONF_BIN_VERSION = 1
+FCONF_BIN_ALIGN = 8
+
+FCONF_BIN_SEC_DTB = 0
+FCONF_BIN_SEC_DTB_REGISTRY = 1
+
+HDR_FMT = '<IIII'
+SECTION_FMT = '<IIII'
+DTB_ENTRY_FMT = '<QQII'
+
+FDT_MAGIC = 0xd00dfeed
+FDT_BEGIN_NODE = 1
+FDT_END_NODE = 2
+FDT_PROP = 3
+FDT_NOP = 4
+FDT_END = 9
+
+NO_ADDR = 0xffffffffffffffff
+
+
+class Node:
+    def __init__(self, name):
+        self.name = name
+        self.props = {}
+        self.children = []
+
+
+def align(value, alignment):
+    return (value + alignment - 1) & ~(alignment - 1)
+
+
+def parse_dtb(data):
+    """Return the root Node of a flattened device tree."""
+    (magic, totalsize, off_struct, off_strings, _, version) = \
+        struct.unpack_from('>IIIIII', data)
+    if magic != FDT_MAGIC:
+        sys.exit('error: not a DTB')
+    if version < 16 or totalsize > len(data):
+        sys.exit('error: unsupported or truncated DTB')
+
+    def string_at(off):
+        end = data.index(b'\0', off_strings + off)
+        return data[off_strings + off:end].decode()
+
+    stack = []
+    root = None
+    off = off_struct
+    while True:
+        (token,) = struct.unpack_from('>I', data, off)
+        off += 4
+        if token == FDT_BEGIN_NODE:
+            end = data.index(b'\0', off)
+            node = Node(data[off:end].decode())
+            off = align(end + 1, 4)
+            if stack:
+                stack[-1].children.append(node)
+            else:
+                root = node
+            stack.append(node)
+        elif token == FDT_END_NODE:
+            stack.pop()
+        elif token == FDT_PROP:
+            (length, nameoff) = struct.unpack_from('>II', data, off)
+            off += 8
+            stack[-1].props[string_at(nameoff)] = data[off:off + length]
+            off = align(off + length, 4)
+        elif token == FDT_NOP:
+            continue
+        elif token == FDT_END:
+            return root
+        else:
+            sys.exit('error: bad DTB token 0x{:x}'.format(token))
+
+
+def find_compatible(node, compatible):
+    """Return the first node, in depth-first order, with this compatible."""
+    values = node.props.get('compatible', b'').split(b'\0')
+    if compatible.encode() in values:
+        return node
+    for child in node.children:
+        found = find_compatible(child, compatible)
+        if found is not None:
+            return found
+    return None
+
+
+def read_cells(node, prop, cells, optional=False):
+    """Read a big-endian value of 'cells' cells, like fdt_read_uint32_array."""
+    value = node.props.get(prop)
+    if value is None:
+        if optional:
+            return None
+        sys.exit('error: {}: missing "{}"'.format(node.name, prop))
+    if len(value) < cells * 4:
+        sys.exit('error: {}: "{}" too short'.format(node.name, prop))
+    result = 0
+    for (cell,) in struct.iter_unpack('>I', value[:cells * 4]):
+        result = (result << 32) | cell
+    return result
+
+
+def dtb_registry_section(root):
+    node = find_compatible(root, 'fconf,dyn_cfg-dtb_registry')
+    if node is None:
+        sys.exit('error: no fconf,dyn_cfg-dtb_registry node')
+
+    entries = b''
+    for child in node.children:
+        ns_addr = read_cells(child, 'ns-load-address', 2, optional=True)
+        entries += struct.pack(DTB_ENTRY_FMT,
+                               read_cells(child, 'load-address', 2),
+                               NO_ADDR if ns_addr is None else ns_addr,
+                               read_cells(child, 'max-size', 1),
+                               read_cells(child, 'id', 1))
+
+    return (FCONF_BIN_SEC_DTB_REGISTRY, entries, len(node.children))
+
+
+def build(dtb, embed_dtb):
+    root = parse_dtb(dtb)
+    sections = [dtb_registry_section(root)]
+    if embed_dtb:
+        sections.append((FCONF_BIN_SEC_DTB, dtb, len(dtb)))
+
+    offset = align(struct.calcsize(HDR_FMT) +
+                   len(sections) * struct.calcsize(SECTION_FMT),
+                   FCONF_BIN_ALIGN)
+    table = b''
+    payload = b''
+    for (sec_type, data, count) in sections:
+        size = align(len(data), FCONF_BIN_ALIGN)
+        table += struct.pack(SECTION_FMT, sec_type, offset + len(payload),
+                             size, count)
+        payload += data.ljust(size, b'\0')
+
+    hdr = struct.pack(HDR_FMT, FCONF_BIN_MAGIC, FCONF_BIN_VERSION,
+                      offset + len(payload), len(sections))
+    return (hdr + table).ljust(offset, b'\0') + payload
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('dtb', help='input FW_CONFIG DTB')
+    parser.add_argument('-o', '--output', required=True,
+                        help='output binary config')
+    parser.add_argument('--no-dtb', action='store_true',
+                        help='do not embed the DTB in the output')
+    args = parser.parse_args()
+
+    with open(args.dtb, 'rb') as f:
+        dtb = f.read()
+
+    with open(args.output, 'wb') as f:
+        f.write(build(dtb, not args.no_dtb))
+
+
+if __name__ == '__main__':
+    main()
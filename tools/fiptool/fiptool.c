@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -22,6 +22,7 @@
 #define OPT_TOC_ENTRY 0
 #define OPT_PLAT_TOC_FLAGS 1
 #define OPT_ALIGN 2
+#define OPT_IN_PLACE 3
 
 static int info_cmd(int argc, char *argv[]);
 static void info_usage(int);
@@ -134,6 +135,200 @@ static void xfwrite(void *buf, size_t size, FILE *fp, const char *filename)
 		log_errx("Failed to write %s", filename);
 }
 
+/*
+ * Map a whole file in memory, read-only unless 'writable' is set, in which
+ * case stores go to the file. An empty file is not mapped and NULL is
+ * returned. Visual Studio builds read the file into memory instead, and do
+ * not support writable mappings.
+ */
+static void *map_file(const char *filename, size_t *size, int writable)
+{
+	struct BLD_PLAT_STAT st;
+	void *buf;
+#ifndef _MSC_VER
+	int fd;
+
+	fd = open(filename, writable ? O_RDWR : O_RDONLY);
+	if (fd == -1)
+		log_err("open %s", filename);
+
+	if (fstat(fd, &st) == -1)
+		log_err("fstat %s", filename);
+
+	*size = st.st_size;
+	buf = NULL;
+	if (*size != 0) {
+		buf = mmap(NULL, *size,
+		    writable ? PROT_READ | PROT_WRITE : PROT_READ,
+		    writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+		if (buf == MAP_FAILED)
+			log_err("mmap %s", filename);
+	}
+	close(fd);
+#else
+	FILE *fp;
+
+	assert(writable == 0);
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	if (fstat(fileno(fp), &st) == -1)
+		log_err("fstat %s", filename);
+
+	*size = st.st_size;
+	buf = xmalloc(*size, "failed to load file into memory");
+	if (fread(buf, 1, *size, fp) != *size)
+		log_errx("Failed to read %s", filename);
+	fclose(fp);
+#endif
+	return buf;
+}
+
+static void unmap_file(void *buf, size_t size)
+{
+#ifndef _MSC_VER
+	if (buf != NULL && munmap(buf, size) == -1)
+		log_err("munmap");
+#else
+	free(buf);
+#endif
+}
+
+/*
+ * A FIP being written. It is built in a temporary file next to the
+ * destination, which is mapped so that the payloads are copied to it
+ * directly, and which replaces the destination once complete. This also
+ * keeps the input FIP, whose images may still be mapped, intact until then.
+ * Symbolic links are followed. A destination with other hard links, or
+ * owned by another user or group, is overwritten with the content of the
+ * temporary file instead, to keep its links and owner.
+ * Visual Studio builds use a buffer in memory instead.
+ */
+typedef struct output {
+	char       *filename;
+	char       *tmpname;
+	char       *buf;
+	size_t      size;
+	int         fd;
+	int         copy;
+} output_t;
+
+#ifndef _MSC_VER
+/* Temporary file of the FIP being written, removed if fiptool fails. */
+static char *tmp_output;
+
+static void remove_tmp_output(void)
+{
+	if (tmp_output != NULL)
+		unlink(tmp_output);
+}
+#endif
+
+static char *open_output(output_t *out, const char *filename, size_t size)
+{
+#ifndef _MSC_VER
+	static int registered;
+	struct BLD_PLAT_STAT st;
+	mode_t mode;
+#endif
+
+	out->size = size;
+	out->copy = 0;
+#ifndef _MSC_VER
+	out->filename = realpath(filename, NULL);
+	if (out->filename != NULL) {
+		if (stat(out->filename, &st) == -1)
+			log_err("stat %s", out->filename);
+		mode = st.st_mode & 07777;
+		out->copy = st.st_nlink > 1 || st.st_uid != geteuid() ||
+		    st.st_gid != getegid();
+	} else {
+		if (errno != ENOENT)
+			log_err("realpath %s", filename);
+		out->filename = xstrdup(filename,
+		    "failed to allocate memory for file name");
+		mode = umask(0);
+		umask(mode);
+		mode = 0666 & ~mode;
+		/* A dangling symbolic link: create its target. */
+		out->copy = lstat(filename, &st) == 0;
+	}
+
+	if (!registered) {
+		if (atexit(remove_tmp_output) != 0)
+			log_errx("atexit failed");
+		registered = 1;
+	}
+
+	out->tmpname = xmalloc(strlen(out->filename) + sizeof(".XXXXXX"),
+	    "failed to allocate memory for file name");
+	sprintf(out->tmpname, "%s.XXXXXX", out->filename);
+	out->fd = mkstemp(out->tmpname);
+	if (out->fd == -1)
+		log_err("mkstemp %s", out->tmpname);
+	tmp_output = out->tmpname;
+
+	if (fchmod(out->fd, mode) == -1 || ftruncate(out->fd, size) == -1)
+		log_err("Failed to create %s", out->tmpname);
+
+	out->buf = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+	    out->fd, 0);
+	if (out->buf == MAP_FAILED)
+		log_err("mmap %s", out->tmpname);
+#else
+	out->filename = xstrdup(filename,
+	    "failed to allocate memory for file name");
+	out->buf = xzalloc(size, "failed to allocate FIP buffer");
+#endif
+	return out->buf;
+}
+
+/* Write the whole output to its destination, truncating it. */
+static void copy_output(output_t *out)
+{
+	FILE *fp;
+
+	fp = fopen(out->filename, "wb");
+	if (fp == NULL)
+		log_err("fopen %s", out->filename);
+	xfwrite(out->buf, out->size, fp, out->filename);
+	if (fclose(fp) == EOF)
+		log_err("fclose %s", out->filename);
+}
+
+static void close_output(output_t *out)
+{
+#ifndef _MSC_VER
+	if (out->copy)
+		copy_output(out);
+	if (munmap(out->buf, out->size) == -1)
+		log_err("munmap %s", out->tmpname);
+	if (close(out->fd) == -1)
+		log_err("close %s", out->tmpname);
+	if (out->copy) {
+		if (unlink(out->tmpname) == -1)
+			log_err("unlink %s", out->tmpname);
+	} else if (rename(out->tmpname, out->filename) == -1) {
+		log_err("rename %s", out->tmpname);
+	}
+	tmp_output = NULL;
+	free(out->tmpname);
+#else
+	copy_output(out);
+	free(out->buf);
+#endif
+	free(out->filename);
+}
+
+static void free_image(image_t *image)
+{
+	if (image->mapped)
+		unmap_file(image->buffer, image->toc_e.size);
+	free(image);
+}
+
 static image_desc_t *new_image_desc(const uuid_t *uuid,
     const char *name, const char *cmdline_name)
 {
@@ -169,10 +364,8 @@ static void free_image_desc(image_desc_t *desc)
 	free(desc->name);
 	free(desc->cmdline_name);
 	free(desc->action_arg);
-	if (desc->image) {
-		free(desc->image->buffer);
-		free(desc->image);
-	}
+	if (desc->image)
+		free_image(desc->image);
 	free(desc);
 }
 
@@ -290,29 +483,26 @@ static void uuid_from_str(uuid_t *u, const char *s)
 		log_errx("Invalid UUID: %s", s);
 }
 
+/*
+ * The FIP parsed by parse_fip(). Its images point into it rather than holding
+ * a copy of their payload, so it stays mapped until the end of the command.
+ */
+static void *fip_buf;
+static size_t fip_size;
+
 static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 {
-	struct BLD_PLAT_STAT st;
-	FILE *fp;
 	char *buf, *bufend;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	int terminated = 0;
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
+	assert(fip_buf == NULL);
 
-	if (fstat(fileno(fp), &st) == -1)
-		log_err("fstat %s", filename);
+	buf = fip_buf = map_file(filename, &fip_size, 0);
+	bufend = buf + fip_size;
 
-	buf = xmalloc(st.st_size, "failed to load file into memory");
-	if (fread(buf, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	bufend = buf + st.st_size;
-	fclose(fp);
-
-	if (st.st_size < sizeof(fip_toc_header_t))
+	if (fip_size < sizeof(fip_toc_header_t))
 		log_errx("FIP %s is truncated", filename);
 
 	toc_header = (fip_toc_header_t *)buf;
@@ -336,6 +526,12 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 			break;
 		}
 
+		/* Overflow checks before referencing the payload. */
+		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
+			log_errx("FIP %s is corrupted", filename);
+		if (toc_entry->size + toc_entry->offset_address > fip_size)
+			log_errx("FIP %s is corrupted", filename);
+
 		/*
 		 * Build a new image out of the ToC entry and add it to the
 		 * table of images.
@@ -343,16 +539,7 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 		image = xzalloc(sizeof(*image),
 		    "failed to allocate memory for image");
 		image->toc_e = *toc_entry;
-		image->buffer = xmalloc(toc_entry->size,
-		    "failed to allocate image buffer, is FIP file corrupted?");
-		/* Overflow checks before memory copy. */
-		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
-			log_errx("FIP %s is corrupted", filename);
-		if (toc_entry->size + toc_entry->offset_address > st.st_size)
-			log_errx("FIP %s is corrupted", filename);
-
-		memcpy(image->buffer, buf + toc_entry->offset_address,
-		    toc_entry->size);
+		image->buffer = buf + toc_entry->offset_address;
 
 		/* If this is an unknown image, create a descriptor for it. */
 		desc = lookup_image_desc_from_uuid(&toc_entry->uuid);
@@ -378,34 +565,23 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
 	return 0;
 }
 
 static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
 {
-	struct BLD_PLAT_STAT st;
 	image_t *image;
-	FILE *fp;
+	size_t size;
 
 	assert(uuid != NULL);
 	assert(filename != NULL);
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_errx("fstat %s", filename);
-
 	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
 	image->toc_e.uuid = *uuid;
-	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	image->toc_e.size = st.st_size;
+	image->buffer = map_file(filename, &size, 0);
+	image->toc_e.size = size;
+	image->mapped = 1;
 
-	fclose(fp);
 	return image;
 }
 
@@ -507,12 +683,12 @@ static void info_usage(int exit_status)
 
 static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
 {
-	FILE *fp;
+	output_t out;
 	image_desc_t *desc;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	char *buf;
-	uint64_t entry_offset, buf_size, payload_size = 0, pad_size;
+	uint64_t entry_offset, buf_size, payload_size = 0, fip_end;
 	size_t nr_images = 0;
 
 	for (desc = image_desc_head; desc != NULL; desc = desc->next)
@@ -521,9 +697,26 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 
 	buf_size = sizeof(fip_toc_header_t) +
 	    sizeof(fip_toc_entry_t) * (nr_images + 1);
-	buf = calloc(1, buf_size);
-	if (buf == NULL)
-		log_err("calloc");
+
+	/* Lay out the images to find out the size of the FIP. */
+	entry_offset = buf_size;
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL || (image->toc_e.size == 0ULL))
+			continue;
+		payload_size += image->toc_e.size;
+		entry_offset = (entry_offset + align - 1) & ~(align - 1);
+		image->toc_e.offset_address = entry_offset;
+		entry_offset += image->toc_e.size;
+	}
+	fip_end = (entry_offset + align - 1) & ~(align - 1);
+
+	/*
+	 * Generate the FIP file. The output starts zeroed, which provides the
+	 * padding between the images.
+	 */
+	buf = open_output(&out, filename, fip_end);
 
 	/* Build up header and ToC entries from the image table. */
 	toc_header = (fip_toc_header_t *)buf;
@@ -533,17 +726,17 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 
 	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
 
-	entry_offset = buf_size;
+	if (verbose)
+		log_dbgx("Metadata size: %zu bytes", buf_size);
+
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
 
 		if (image == NULL || (image->toc_e.size == 0ULL))
 			continue;
-		payload_size += image->toc_e.size;
-		entry_offset = (entry_offset + align - 1) & ~(align - 1);
-		image->toc_e.offset_address = entry_offset;
 		*toc_entry++ = image->toc_e;
-		entry_offset += image->toc_e.size;
+		memcpy(buf + image->toc_e.offset_address, image->buffer,
+		    image->toc_e.size);
 	}
 
 	/*
@@ -552,43 +745,117 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	 * size.
 	 */
 	memset(toc_entry, 0, sizeof(*toc_entry));
-	toc_entry->offset_address = (entry_offset + align - 1) & ~(align - 1);
-
-	/* Generate the FIP file. */
-	fp = fopen(filename, "wb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
+	toc_entry->offset_address = fip_end;
 
 	if (verbose)
-		log_dbgx("Metadata size: %zu bytes", buf_size);
+		log_dbgx("Payload size: %zu bytes", payload_size);
 
-	xfwrite(buf, buf_size, fp, filename);
+	close_output(&out);
+	return 0;
+}
 
-	if (verbose)
-		log_dbgx("Payload size: %zu bytes", payload_size);
+/*
+ * Return the space available to the payload of ToC entry 'e', which ends
+ * where the next image in the FIP starts.
+ */
+static uint64_t toc_entry_space(const fip_toc_entry_t *toc_entry,
+    const fip_toc_entry_t *e)
+{
+	uint64_t end = fip_size;
 
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		image_t *image = desc->image;
+	for (; memcmp(&toc_entry->uuid, &uuid_null, sizeof(uuid_t)) != 0;
+	     toc_entry++)
+		if (toc_entry->offset_address > e->offset_address &&
+		    toc_entry->offset_address < end)
+			end = toc_entry->offset_address;
 
-		if (image == NULL)
-			continue;
-		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
-			log_errx("Failed to set file position");
+	return end - e->offset_address;
+}
+
+/*
+ * Update the FIP in place: each replaced image is written over the payload of
+ * the image it replaces, and the rest of the file is left untouched except
+ * for the ToC. This is only possible when no image is added, when each new
+ * image fits in the space of the old one, up to the next image, and when all
+ * the images are already aligned to 'align'. Return 0 if the FIP has been
+ * updated, -1 if it needs to be packed again.
+ */
+#ifndef _MSC_VER
+static int update_fip_in_place(const char *filename, uint64_t toc_flags,
+    unsigned long align)
+{
+	image_desc_t *desc;
+	fip_toc_header_t *toc_header;
+	fip_toc_entry_t *toc_entry, *e;
+	char *buf;
+	size_t size, nr_images = 0, nr_entries = 0;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (desc->image != NULL)
+			nr_images++;
+
+	/* parse_fip() has already checked the ToC of the FIP. */
+	toc_header = fip_buf;
+	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
+	for (e = toc_entry; memcmp(&e->uuid, &uuid_null, sizeof(uuid_t)) != 0;
+	     e++) {
+		desc = lookup_image_desc_from_uuid(&e->uuid);
+		assert(desc != NULL && desc->image != NULL);
 
-		xfwrite(image->buffer, image->toc_e.size, fp, filename);
+		if ((e->offset_address & (align - 1)) != 0)
+			return -1;
+
+		if (desc->action == DO_PACK &&
+		    (desc->image->toc_e.size == 0ULL ||
+		     desc->image->toc_e.size > toc_entry_space(toc_entry, e)))
+			return -1;
+
+		nr_entries++;
 	}
 
-	if (fseek(fp, entry_offset, SEEK_SET))
-		log_errx("Failed to set file position");
+	if (nr_entries != nr_images)
+		return -1;
 
-	pad_size = toc_entry->offset_address - entry_offset;
-	while (pad_size--)
-		fputc(0x0, fp);
+	buf = map_file(filename, &size, 1);
+	if (size != fip_size)
+		log_errx("%s changed while being updated", filename);
 
-	free(buf);
-	fclose(fp);
+	toc_header = (fip_toc_header_t *)buf;
+	toc_header->flags = toc_flags;
+
+	for (e = (fip_toc_entry_t *)(toc_header + 1);
+	     memcmp(&e->uuid, &uuid_null, sizeof(uuid_t)) != 0; e++) {
+		image_t *image;
+
+		desc = lookup_image_desc_from_uuid(&e->uuid);
+		if (desc->action != DO_PACK)
+			continue;
+
+		image = desc->image;
+		image->toc_e.offset_address = e->offset_address;
+		memcpy(buf + e->offset_address, image->buffer,
+		    image->toc_e.size);
+		/* Clear what is left of the old payload. */
+		if (e->size > image->toc_e.size)
+			memset(buf + e->offset_address + image->toc_e.size, 0,
+			    e->size - image->toc_e.size);
+		*e = image->toc_e;
+
+		if (verbose)
+			log_dbgx("Updated %s in place", desc->cmdline_name);
+	}
+
+	unmap_file(buf, size);
 	return 0;
 }
+#else
+/* Files cannot be mapped for writing. */
+static int update_fip_in_place(const char *filename, uint64_t toc_flags,
+    unsigned long align)
+{
+	return -1;
+}
+#endif
 
 /*
  * This function is shared between the create and update subcommands.
@@ -616,7 +883,7 @@ static void update_fip(void)
 				    desc->cmdline_name,
 				    desc->action_arg);
 			}
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = image;
 		} else {
 			if (verbose)
@@ -783,6 +1050,7 @@ static int update_cmd(int argc, char *argv[])
 	unsigned long long toc_flags = 0;
 	unsigned long align = 1;
 	int pflag = 0;
+	int in_place = 0;
 
 	if (argc < 2)
 		update_usage(EXIT_FAILURE);
@@ -790,6 +1058,7 @@ static int update_cmd(int argc, char *argv[])
 	opts = fill_common_opts(opts, &nr_opts, required_argument);
 	opts = add_opt(opts, &nr_opts, "align", required_argument, OPT_ALIGN);
 	opts = add_opt(opts, &nr_opts, "blob", required_argument, 'b');
+	opts = add_opt(opts, &nr_opts, "in-place", no_argument, OPT_IN_PLACE);
 	opts = add_opt(opts, &nr_opts, "out", required_argument, 'o');
 	opts = add_opt(opts, &nr_opts, "plat-toc-flags", required_argument,
 	    OPT_PLAT_TOC_FLAGS);
@@ -839,6 +1108,9 @@ static int update_cmd(int argc, char *argv[])
 		case OPT_ALIGN:
 			align = get_image_align(optarg);
 			break;
+		case OPT_IN_PLACE:
+			in_place = 1;
+			break;
 		case 'o':
 			snprintf(outfile, sizeof(outfile), "%s", optarg);
 			break;
@@ -865,6 +1137,14 @@ static int update_cmd(int argc, char *argv[])
 
 	update_fip();
 
+	if (in_place && fip_buf != NULL && strcmp(outfile, argv[0]) == 0) {
+		if (update_fip_in_place(outfile, toc_flags, align) == 0)
+			return 0;
+		if (verbose)
+			log_dbgx("Cannot update %s in place, packing it again",
+			    outfile);
+	}
+
 	pack_images(outfile, toc_flags, align);
 	return 0;
 }
@@ -878,6 +1158,7 @@ static void update_usage(int exit_status)
 	printf("Options:\n");
 	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
 	printf("  --blob uuid=...,file=...\tAdd or update an image with the given UUID pointed to by file.\n");
+	printf("  --in-place\t\t\tOnly rewrite the ToC and the updated images when they fit in the FIP.\n");
 	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
 	printf("\n");
@@ -1128,7 +1409,7 @@ static int remove_cmd(int argc, char *argv[])
 			if (verbose)
 				log_dbgx("Removing %s",
 				    desc->cmdline_name);
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = NULL;
 		} else {
 			log_warnx("%s does not exist in %s",
@@ -1262,5 +1543,6 @@ int main(int argc, char *argv[])
 	if (i == NELEM(cmds))
 		usage();
 	free_image_descs();
+	unmap_file(fip_buf, fip_size);
 	return ret;
 }
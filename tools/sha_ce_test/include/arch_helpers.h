@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host replacement of include/arch/aarch64/arch_helpers.h. On an AArch64
+ * host, Linux emulates the read of ID_AA64ISAR0_EL1. Elsewhere, the value is
+ * set by the test.
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+#include <stdint.h>
+
+typedef uint64_t u_register_t;
+
+#ifdef __aarch64__
+static inline u_register_t read_id_aa64isar0_el1(void)
+{
+	u_register_t val;
+
+	__asm__ volatile ("mrs %0, id_aa64isar0_el1" : "=r" (val));
+	return val;
+}
+#else
+extern u_register_t model_id_aa64isar0_el1;
+
+static inline u_register_t read_id_aa64isar0_el1(void)
+{
+	return model_id_aa64isar0_el1;
+}
+#endif
+
+#endif /* ARCH_HELPERS_H */
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * C model of drivers/auth/sha_ce/aarch64/sha256_ce.S and sha512_ce.S for
+ * hosts without the Armv8 SHA instructions.
+ *
+ * The instructions are modelled after their pseudocode in the Arm ARM, on a
+ * file of 32 vector registers. The round macros of the assembly files are
+ * written again below with the same register operands, and are invoked with
+ * the arguments and round constants taken from the assembly files by the
+ * Makefile, so that a wrong register in the sequence of the assembly is
+ * caught by the test.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <drivers/auth/sha_ce.h>
+
+typedef union {
+	uint32_t s[4];
+	uint64_t d[2];
+} vreg_t;
+
+static vreg_t v[32];
+
+static const uint32_t sha256_ce_k[64] = {
+#include "sha256_ce_k.inc"
+};
+
+static const uint64_t sha512_ce_k[80] = {
+#include "sha512_ce_k.inc"
+};
+
+static uint32_t ror32(uint32_t x, unsigned int n)
+{
+	return (x >> n) | (x << (32U - n));
+}
+
+static uint64_t ror64(uint64_t x, unsigned int n)
+{
+	return (x >> n) | (x << (64U - n));
+}
+
+static uint32_t load_be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+	       ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint64_t load_be64(const uint8_t *p)
+{
+	return ((uint64_t)load_be32(p) << 32) | load_be32(p + 4);
+}
+
+/* SHA256hash() of the Arm ARM: SHA256H when part1, SHA256H2 otherwise */
+static vreg_t sha256hash(vreg_t x, vreg_t y, vreg_t w, int part1)
+{
+	uint32_t chs, maj, t;
+	vreg_t nx, ny;
+	unsigned int e;
+
+	for (e = 0U; e < 4U; e++) {
+		chs = (y.s[0] & y.s[1]) ^ (~y.s[0] & y.s[2]);
+		maj = (x.s[0] & x.s[1]) | ((x.s[0] | x.s[1]) & x.s[2]);
+		t = y.s[3] + (ror32(y.s[0], 6) ^ ror32(y.s[0], 11) ^
+			      ror32(y.s[0], 25)) + chs + w.s[e];
+		x.s[3] = t + x.s[3];
+		y.s[3] = t + (ror32(x.s[0], 2) ^ ror32(x.s[0], 13) ^
+			      ror32(x.s[0], 22)) + maj;
+		/* Y:X = ROL(Y:X, 32) */
+		nx.s[0] = y.s[3];
+		nx.s[1] = x.s[0];
+		nx.s[2] = x.s[1];
+		nx.s[3] = x.s[2];
+		ny.s[0] = x.s[3];
+		ny.s[1] = y.s[0];
+		ny.s[2] = y.s[1];
+		ny.s[3] = y.s[2];
+		x = nx;
+		y = ny;
+	}
+
+	return part1 ? x : y;
+}
+
+static void sha256h(unsigned int d, unsigned int n, unsigned int m)
+{
+	v[d] = sha256hash(v[d], v[n], v[m], 1);
+}
+
+static void sha256h2(unsigned int d, unsigned int n, unsigned int m)
+{
+	v[d] = sha256hash(v[n], v[d], v[m], 0);
+}
+
+static uint32_t sigma0_256(uint32_t x)
+{
+	return ror32(x, 7) ^ ror32(x, 18) ^ (x >> 3);
+}
+
+static uint32_t sigma1_256(uint32_t x)
+{
+	return ror32(x, 17) ^ ror32(x, 19) ^ (x >> 10);
+}
+
+static void sha256su0(unsigned int d, unsigned int n)
+{
+	uint32_t t[4] = { v[d].s[1], v[d].s[2], v[d].s[3], v[n].s[0] };
+	unsigned int e;
+
+	for (e = 0U; e < 4U; e++) {
+		v[d].s[e] += sigma0_256(t[e]);
+	}
+}
+
+static void sha256su1(unsigned int d, unsigned int n, unsigned int m)
+{
+	uint32_t t[4] = { v[n].s[1], v[n].s[2], v[n].s[3], v[m].s[0] };
+	vreg_t r;
+	unsigned int e;
+
+	for (e = 0U; e < 2U; e++) {
+		r.s[e] = sigma1_256(v[m].s[e + 2U]) + v[d].s[e] + t[e];
+	}
+	for (e = 2U; e < 4U; e++) {
+		r.s[e] = sigma1_256(r.s[e - 2U]) + v[d].s[e] + t[e];
+	}
+	v[d] = r;
+}
+
+static uint64_t sum1_512(uint64_t x)
+{
+	return ror64(x, 14) ^ ror64(x, 18) ^ ror64(x, 41);
+}
+
+static uint64_t sum0_512(uint64_t x)
+{
+	return ror64(x, 28) ^ ror64(x, 34) ^ ror64(x, 39);
+}
+
+static void sha512h(unsigned int d, unsigned int n, unsigned int m)
+{
+	vreg_t w = v[d], x = v[n], y = v[m];
+	uint64_t hi, lo, t;
+
+	hi = (y.d[1] & x.d[0]) ^ (~y.d[1] & x.d[1]);
+	hi += sum1_512(y.d[1]) + w.d[1];
+	t = hi + y.d[0];
+	lo = (t & y.d[1]) ^ (~t & x.d[0]);
+	lo += sum1_512(t) + w.d[0];
+	v[d].d[0] = lo;
+	v[d].d[1] = hi;
+}
+
+static void sha512h2(unsigned int d, unsigned int n, unsigned int m)
+{
+	vreg_t w = v[d], x = v[n], y = v[m];
+	uint64_t hi, lo;
+
+	hi = (x.d[0] & y.d[1]) ^ (x.d[0] & y.d[0]) ^ (y.d[1] & y.d[0]);
+	hi += sum0_512(y.d[0]) + w.d[1];
+	lo = (hi & y.d[0]) ^ (hi & y.d[1]) ^ (y.d[1] & y.d[0]);
+	lo += sum0_512(hi) + w.d[0];
+	v[d].d[0] = lo;
+	v[d].d[1] = hi;
+}
+
+static uint64_t sigma0_512(uint64_t x)
+{
+	return ror64(x, 1) ^ ror64(x, 8) ^ (x >> 7);
+}
+
+static uint64_t sigma1_512(uint64_t x)
+{
+	return ror64(x, 19) ^ ror64(x, 61) ^ (x >> 6);
+}
+
+static void sha512su0(unsigned int d, unsigned int n)
+{
+	uint64_t w1 = v[d].d[1];
+
+	v[d].d[0] += sigma0_512(w1);
+	v[d].d[1] += sigma0_512(v[n].d[0]);
+}
+
+static void sha512su1(unsigned int d, unsigned int n, unsigned int m)
+{
+	v[d].d[0] += sigma1_512(v[n].d[0]) + v[m].d[0];
+	v[d].d[1] += sigma1_512(v[n].d[1]) + v[m].d[1];
+}
+
+/* EXT Vd.16B, Vn.16B, Vm.16B, #8 */
+static void ext8(unsigned int d, unsigned int n, unsigned int m)
+{
+	vreg_t r = { .d = { v[n].d[1], v[m].d[0] } };
+
+	v[d] = r;
+}
+
+static void add_4s(unsigned int d, unsigned int n, unsigned int m)
+{
+	unsigned int e;
+
+	for (e = 0U; e < 4U; e++) {
+		v[d].s[e] = v[n].s[e] + v[m].s[e];
+	}
+}
+
+static void add_2d(unsigned int d, unsigned int n, unsigned int m)
+{
+	v[d].d[0] = v[n].d[0] + v[m].d[0];
+	v[d].d[1] = v[n].d[1] + v[m].d[1];
+}
+
+/* Macros of sha256_ce.S and sha512_ce.S, x8 is the round constant pointer */
+static const uint32_t *x8_256;
+static const uint64_t *x8_512;
+
+static void sha256_ce_4rounds(unsigned int w0, unsigned int w1,
+			      unsigned int w2, unsigned int w3, int sched)
+{
+	unsigned int e;
+
+	for (e = 0U; e < 4U; e++) {
+		v[18].s[e] = *x8_256++;
+	}
+	add_4s(16, w0, 18);
+	v[17] = v[0];
+	sha256h(0, 1, 16);
+	sha256h2(1, 17, 16);
+	if (sched != 0) {
+		sha256su0(w0, w1);
+		sha256su1(w0, w2, w3);
+	}
+}
+
+static void sha512_ce_2rounds(unsigned int ab, unsigned int cd,
+			      unsigned int ef, unsigned int gh,
+			      unsigned int nx, unsigned int w0,
+			      unsigned int w1, unsigned int w4,
+			      unsigned int w5, unsigned int w7, int sched)
+{
+	v[5].d[0] = *x8_512++;
+	v[5].d[1] = *x8_512++;
+	add_2d(5, 5, w0);
+	ext8(6, ef, gh);
+	ext8(5, 5, 5);
+	ext8(7, cd, ef);
+	add_2d(gh, gh, 5);
+	if (sched != 0) {
+		ext8(5, w4, w5);
+		sha512su0(w0, w1);
+		sha512su1(w0, w7, 5);
+	}
+	sha512h(gh, 6, 7);
+	add_2d(nx, cd, gh);
+	sha512h2(gh, cd, ab);
+}
+
+void sha256_ce_blocks(uint32_t state[8], const uint8_t *data, size_t nblocks)
+{
+	unsigned int i;
+
+	for (i = 0U; i < 4U; i++) {
+		v[0].s[i] = state[i];
+		v[1].s[i] = state[4U + i];
+	}
+
+	for (; nblocks != 0U; nblocks--, data += 64) {
+		for (i = 0U; i < 16U; i++) {
+			v[4U + (i / 4U)].s[i % 4U] = load_be32(&data[4U * i]);
+		}
+		v[2] = v[0];
+		v[3] = v[1];
+		x8_256 = sha256_ce_k;
+
+#include "sha256_ce_seq.inc"
+
+		add_4s(0, 0, 2);
+		add_4s(1, 1, 3);
+	}
+
+	for (i = 0U; i < 4U; i++) {
+		state[i] = v[0].s[i];
+		state[4U + i] = v[1].s[i];
+	}
+}
+
+void sha512_ce_blocks(uint64_t state[8], const uint8_t *data, size_t nblocks)
+{
+	unsigned int i;
+
+	for (i = 0U; i < 4U; i++) {
+		v[i].d[0] = state[2U * i];
+		v[i].d[1] = state[(2U * i) + 1U];
+	}
+
+	for (; nblocks != 0U; nblocks--, data += 128) {
+		for (i = 0U; i < 16U; i++) {
+			v[16U + (i / 2U)].d[i % 2U] = load_be64(&data[8U * i]);
+		}
+		x8_512 = sha512_ce_k;
+
+#include "sha512_ce_seq.inc"
+
+		for (i = 0U; i < 4U; i++) {
+			v[i].d[0] += state[2U * i];
+			v[i].d[1] += state[(2U * i) + 1U];
+			state[2U * i] = v[i].d[0];
+			state[(2U * i) + 1U] = v[i].d[1];
+		}
+	}
+}
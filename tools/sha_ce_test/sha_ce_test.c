@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test of drivers/auth/sha_ce/sha_ce.c.
+ *
+ * The digests of sha_ce_calc_hash() are checked against the examples of FIPS
+ * 180-2 (SHA-256, SHA-384 and SHA-512 of "abc" and of the two-block messages,
+ * SHA-256 of the empty message and of one million "a"), then against the
+ * generic implementation of OpenSSL for all the message lengths up to 1100
+ * bytes, at every alignment of the buffer up to 16 bytes.
+ *
+ * On an AArch64 host, the assembly of the driver is run. Elsewhere, it is the
+ * C model of sha_ce_model.c, and the fallback to the software implementation
+ * is checked for CPUs without the SHA-256 or SHA-512 instructions.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <openssl/evp.h>
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <drivers/auth/sha_ce.h>
+
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			fprintf(stderr, "%s:%d: check failed: %s\n",	\
+				__FILE__, __LINE__, #cond);		\
+			exit(1);					\
+		}							\
+	} while (0)
+
+#define MAX_LEN		1100
+#define MAX_ALIGN	16
+
+#ifndef __aarch64__
+u_register_t model_id_aa64isar0_el1 =
+	(u_register_t)ID_AA64ISAR0_SHA2_SHA512 << ID_AA64ISAR0_SHA2_SHIFT;
+#endif
+
+static const char msg_2blk_256[] =
+	"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+static const char msg_2blk_512[] =
+	"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+	"hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+
+static const struct {
+	enum crypto_md_algo algo;
+	const char *msg;	/* NULL for one million "a" */
+	const char *digest;
+} kat[] = {
+	{ CRYPTO_MD_SHA256, "abc",
+	  "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+	{ CRYPTO_MD_SHA256, "",
+	  "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+	{ CRYPTO_MD_SHA256, msg_2blk_256,
+	  "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+	{ CRYPTO_MD_SHA256, msg_2blk_512,
+	  "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1" },
+	{ CRYPTO_MD_SHA256, NULL,
+	  "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+	{ CRYPTO_MD_SHA384, "abc",
+	  "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded163"
+	  "1a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7" },
+	{ CRYPTO_MD_SHA384, msg_2blk_512,
+	  "09330c33f71147e83d192fc782cd1b4753111b173b3b05d2"
+	  "2fa08086e3b0f712fcc7c71a557e2db966c3e9fa91746039" },
+	{ CRYPTO_MD_SHA512, "abc",
+	  "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+	  "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f" },
+	{ CRYPTO_MD_SHA512, msg_2blk_512,
+	  "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+	  "501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909" },
+};
+
+static const struct {
+	enum crypto_md_algo algo;
+	const char *name;
+} algos[] = {
+	{ CRYPTO_MD_SHA256, "SHA-256" },
+	{ CRYPTO_MD_SHA384, "SHA-384" },
+	{ CRYPTO_MD_SHA512, "SHA-512" },
+};
+
+static const EVP_MD *evp_md(enum crypto_md_algo algo)
+{
+	switch (algo) {
+	case CRYPTO_MD_SHA256:
+		return EVP_sha256();
+	case CRYPTO_MD_SHA384:
+		return EVP_sha384();
+	default:
+		return EVP_sha512();
+	}
+}
+
+static void to_hex(const unsigned char *md, unsigned int len, char *hex)
+{
+	unsigned int i;
+
+	for (i = 0U; i < len; i++) {
+		sprintf(&hex[2U * i], "%02x", md[i]);
+	}
+}
+
+static void test_kat(void)
+{
+	unsigned char md[CRYPTO_MD_MAX_SIZE];
+	char hex[(2 * CRYPTO_MD_MAX_SIZE) + 1];
+	unsigned int i, len;
+	char *msg;
+	size_t msg_len;
+
+	for (i = 0U; i < (sizeof(kat) / sizeof(kat[0])); i++) {
+		if (kat[i].msg != NULL) {
+			msg = strdup(kat[i].msg);
+			msg_len = strlen(msg);
+		} else {
+			msg_len = 1000000U;
+			msg = malloc(msg_len);
+			CHECK(msg != NULL);
+			memset(msg, 'a', msg_len);
+		}
+
+		CHECK(sha_ce_calc_hash(kat[i].algo, msg, msg_len, md) ==
+		      CRYPTO_SUCCESS);
+		len = (unsigned int)strlen(kat[i].digest) / 2U;
+		to_hex(md, len, hex);
+		if (strcmp(hex, kat[i].digest) != 0) {
+			fprintf(stderr, "KAT %u: %s\n", i, hex);
+			exit(1);
+		}
+		free(msg);
+	}
+
+	printf("%u FIPS 180-2 known answers OK\n", i);
+}
+
+/* Compare with OpenSSL for all the lengths and alignments */
+static void test_generic(void)
+{
+	unsigned char md[CRYPTO_MD_MAX_SIZE], ref[EVP_MAX_MD_SIZE];
+	unsigned char buf[MAX_LEN + MAX_ALIGN];
+	unsigned int a, ref_len;
+	size_t len, off;
+
+	for (off = 0U; off < sizeof(buf); off++) {
+		buf[off] = (unsigned char)rand();
+	}
+
+	for (a = 0U; a < (sizeof(algos) / sizeof(algos[0])); a++) {
+		for (off = 0U; off < MAX_ALIGN; off++) {
+			for (len = 0U; len <= MAX_LEN; len++) {
+				CHECK(sha_ce_calc_hash(algos[a].algo,
+						       &buf[off], len, md) ==
+				      CRYPTO_SUCCESS);
+				CHECK(EVP_Digest(&buf[off], len, ref, &ref_len,
+						 evp_md(algos[a].algo),
+						 NULL) == 1);
+				if (memcmp(md, ref, ref_len) != 0) {
+					fprintf(stderr,
+						"%s: length %zu offset %zu\n",
+						algos[a].name, len, off);
+					exit(1);
+				}
+			}
+		}
+		printf("%s: lengths 0 to %u at offsets 0 to %u match OpenSSL\n",
+		       algos[a].name, MAX_LEN, MAX_ALIGN - 1);
+	}
+}
+
+#ifndef __aarch64__
+/* CPUs without the instructions must fall back to mbed TLS */
+static void test_fallback(void)
+{
+	unsigned char md[CRYPTO_MD_MAX_SIZE];
+
+	model_id_aa64isar0_el1 = 0U;
+	CHECK(sha_ce_calc_hash(CRYPTO_MD_SHA256, "abc", 3U, md) ==
+	      CRYPTO_ERR_HASH);
+	CHECK(sha_ce_calc_hash(CRYPTO_MD_SHA512, "abc", 3U, md) ==
+	      CRYPTO_ERR_HASH);
+
+	model_id_aa64isar0_el1 = (u_register_t)ID_AA64ISAR0_SHA2_SHA256 <<
+				 ID_AA64ISAR0_SHA2_SHIFT;
+	CHECK(sha_ce_calc_hash(CRYPTO_MD_SHA256, "abc", 3U, md) ==
+	      CRYPTO_SUCCESS);
+	CHECK(sha_ce_calc_hash(CRYPTO_MD_SHA384, "abc", 3U, md) ==
+	      CRYPTO_ERR_HASH);
+	CHECK(sha_ce_calc_hash(CRYPTO_MD_SHA512, "abc", 3U, md) ==
+	      CRYPTO_ERR_HASH);
+
+	printf("Fallback without the SHA instructions OK\n");
+}
+#endif
+
+int main(void)
+{
+#ifdef __aarch64__
+	unsigned int sha2 = (unsigned int)((read_id_aa64isar0_el1() >>
+					    ID_AA64ISAR0_SHA2_SHIFT) &
+					   ID_AA64ISAR0_SHA2_MASK);
+
+	if (sha2 < ID_AA64ISAR0_SHA2_SHA512) {
+		printf("The CPU does not implement FEAT_SHA512, skipped\n");
+		return 0;
+	}
+	printf("Running the SHA instructions\n");
+#else
+	printf("Running the C model of the SHA instructions\n");
+#endif
+
+	srand(1);
+	test_kat();
+	test_generic();
+#ifndef __aarch64__
+	test_fallback();
+#endif
+
+	return 0;
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host stdint.h with the types added by include/lib/libc/stdint.h */
+
+#ifndef HOST_STDINT_H
+#define HOST_STDINT_H
+
+#include_next <stdint.h>
+
+typedef unsigned long u_register_t;
+
+#endif /* HOST_STDINT_H */
@@ -0,0 +1,686 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Multi-CPU stress test of the FF-A memory management calls of the EL3 SPMC,
+ * run on the host.
+ *
+ * services/std_svc/spm/el3_spmc/spmc_shared_mem.c is included, with the rest
+ * of the SPMC replaced by a Normal world with a single RX/TX buffer pair, as
+ * seen through a hypervisor, and two S-EL1 partitions like the TSP, each with
+ * its own buffer pair. Each thread is a CPU. It shares memory from the Normal
+ * world with one or both partitions, retrieves and relinquishes it from the
+ * partition it runs, and reclaims it, on its own transactions and on those of
+ * the other CPUs. Descriptors longer than a page go through FFA_MEM_FRAG_TX
+ * and FFA_MEM_FRAG_RX. The spinlocks of the SPMC are real ones.
+ *
+ * The tag of each transaction encodes its address ranges and receivers, so
+ * that any retrieved descriptor can be checked. Besides, a CPU must always be
+ * able to retrieve its own transactions, a transaction can only be reclaimed
+ * once all its retrievals have been relinquished, and a transaction that
+ * overlaps a live one must be rejected. Once everything is relinquished and
+ * reclaimed, the datastore must be back to its initial blocks.
+ *
+ * Built with ThreadSanitizer, the test also reports the accesses of the SPMC
+ * that are not ordered by its locks.
+ *
+ * Usage: spmc_shmem_stress [iterations [threads [seed]]]
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <spmc_shared_mem.c>
+
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			fprintf(stderr, "%s:%d: check failed: %s\n",	\
+				__FILE__, __LINE__, #cond);		\
+			exit(1);					\
+		}							\
+	} while (0)
+
+#define NUM_SPS			2U
+#define NWD_ID			0x0001U
+#define SP_ID(i)		(0x8001U + (i))
+
+#define DATASTORE_SIZE		0x100000U
+#define SHARES_PER_CPU		8U
+#define MAX_HELD		16U
+#define MAX_CONSTITUENTS	400U
+#define MAX_DESC_SIZE		(sizeof(struct ffa_mtd) +			\
+				 (NUM_SPS * sizeof(struct ffa_emad_v1_0)) +	\
+				 sizeof(struct ffa_comp_mrd) +			\
+				 (MAX_CONSTITUENTS * sizeof(struct ffa_cons_mrd)))
+
+/*
+ * Tag of a transaction: generation, number of constituents and mask of the
+ * receivers. Each generation has its own 16MB of address space.
+ */
+#define TAG(gen, count, mask)	(((uint64_t)(gen) << 16) | ((count) << 2) | \
+				 (mask))
+#define TAG_COUNT(tag)		((unsigned int)((tag) >> 2) & 0x3fffU)
+#define TAG_MASK(tag)		((unsigned int)(tag) & 0x3U)
+#define TAG_BASE(tag)		(((tag) >> 16) << 24)
+
+struct share {
+	atomic_uint_least64_t handle;	/* 0 if the slot is free */
+	atomic_uint_least64_t tag;
+	atomic_int retrieved;		/* Retrievals not yet relinquished */
+};
+
+struct held {
+	uint64_t handle;
+	struct share *share;
+};
+
+struct cpu {
+	pthread_t thread;
+	unsigned int id;
+	unsigned int seed;
+	struct secure_partition_desc *sp;
+	struct held held[MAX_HELD];
+	unsigned int num_held;
+	uint8_t desc[MAX_DESC_SIZE];
+
+	/* Statistics */
+	unsigned long shared, no_memory, retrieved, retrieve_failed;
+	unsigned long relinquished, reclaimed, reclaim_denied, overlaps;
+};
+
+static unsigned long iterations = 20000U;
+static unsigned int num_cpus = 4U;
+
+static struct cpu cpus[PLATFORM_CORE_COUNT];
+static struct share shares[PLATFORM_CORE_COUNT][SHARES_PER_CPU];
+static atomic_uint_least64_t next_gen = 1U;
+
+/*
+ * Buffers of the Normal world, used by one CPU at a time as the hypervisor
+ * would, and buffers of each partition, used by one of its CPUs at a time.
+ */
+static struct mailbox nwd_mbox;
+static pthread_mutex_t nwd_buf_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct secure_partition_desc sps[NUM_SPS];
+static pthread_mutex_t sp_buf_lock[NUM_SPS] = {
+	PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER
+};
+
+static __thread struct secure_partition_desc *current_sp;
+
+static atomic_ulong num_log;
+
+/* Functions of the rest of the SPMC */
+void spin_lock(spinlock_t *lock)
+{
+	while (__atomic_exchange_n(&lock->lock, 1U, __ATOMIC_ACQUIRE) != 0U) {
+		sched_yield();
+	}
+}
+
+/*
+ * Let the other CPUs run between the critical sections, where the accesses
+ * that are not ordered by the locks are, even on a host with a single CPU.
+ */
+void spin_unlock(spinlock_t *lock)
+{
+	__atomic_store_n(&lock->lock, 0U, __ATOMIC_RELEASE);
+	sched_yield();
+}
+
+/* The warnings of the calls that are expected to fail are counted */
+void tf_log(const char *fmt, ...)
+{
+	atomic_fetch_add_explicit(&num_log, 1U, memory_order_relaxed);
+}
+
+uint64_t spmc_ffa_error_return(void *handle, int error_code)
+{
+	SMC_RET8(handle, FFA_ERROR, FFA_TARGET_INFO_MBZ, error_code,
+		 FFA_PARAM_MBZ, FFA_PARAM_MBZ, FFA_PARAM_MBZ, FFA_PARAM_MBZ,
+		 FFA_PARAM_MBZ);
+}
+
+struct secure_partition_desc *spmc_get_current_sp_ctx(void)
+{
+	return current_sp;
+}
+
+struct secure_partition_desc *spmc_get_sp_ctx(uint16_t id)
+{
+	unsigned int i;
+
+	for (i = 0U; i < NUM_SPS; i++) {
+		if (sps[i].sp_id == id) {
+			return &sps[i];
+		}
+	}
+
+	return NULL;
+}
+
+struct mailbox *spmc_get_mbox_desc(bool secure_origin)
+{
+	return secure_origin ? &current_sp->mailbox : &nwd_mbox;
+}
+
+uint32_t get_partition_ffa_version(bool secure_origin)
+{
+	return MAKE_FFA_VERSION(1, 1);
+}
+
+int plat_spmc_shmem_begin(struct ffa_mtd *desc)
+{
+	return 0;
+}
+
+int plat_spmc_shmem_reclaim(struct ffa_mtd *desc)
+{
+	return 0;
+}
+
+static uint64_t reg(cpu_context_t *ctx, unsigned int n)
+{
+	return read_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X0 + (n * 8U));
+}
+
+static unsigned int num_receivers(unsigned int mask)
+{
+	return (unsigned int)__builtin_popcount(mask);
+}
+
+static void *alloc_page(void)
+{
+	void *page = aligned_alloc(FFA_PAGE_SIZE, FFA_PAGE_SIZE);
+
+	CHECK(page != NULL);
+	return page;
+}
+
+/* Write the descriptor of the transaction of @tag, return its size */
+static size_t build_desc(uint8_t *buf, uint64_t tag)
+{
+	struct ffa_mtd *mtd = (struct ffa_mtd *)buf;
+	unsigned int count = TAG_COUNT(tag), mask = TAG_MASK(tag);
+	struct ffa_emad_v1_0 *emad;
+	struct ffa_comp_mrd *comp;
+	uint32_t comp_offset;
+	unsigned int i, n = 0U;
+
+	comp_offset = sizeof(*mtd) + (num_receivers(mask) * sizeof(*emad));
+	memset(buf, 0, comp_offset + sizeof(*comp));
+
+	mtd->sender_id = NWD_ID;
+	mtd->memory_region_attributes = FFA_MEM_ATTR_NORMAL_MEMORY_CACHED_WB |
+					FFA_MEM_ATTR_INNER_SHAREABLE;
+	mtd->tag = tag;
+	mtd->emad_size = sizeof(*emad);
+	mtd->emad_count = num_receivers(mask);
+	mtd->emad_offset = sizeof(*mtd);
+
+	emad = (struct ffa_emad_v1_0 *)(buf + mtd->emad_offset);
+	for (i = 0U; i < NUM_SPS; i++) {
+		if ((mask & (1U << i)) != 0U) {
+			emad[n].mapd.endpoint_id = SP_ID(i);
+			emad[n].mapd.memory_access_permissions =
+				FFA_MEM_PERM_RW;
+			emad[n].comp_mrd_offset = comp_offset;
+			n++;
+		}
+	}
+
+	comp = (struct ffa_comp_mrd *)(buf + comp_offset);
+	comp->total_page_count = count;
+	comp->address_range_count = count;
+	for (i = 0U; i < count; i++) {
+		comp->address_range_array[i].address = TAG_BASE(tag) +
+						       (i * 0x2000U);
+		comp->address_range_array[i].page_count = 1U;
+		comp->address_range_array[i].reserved_12_15 = 0U;
+	}
+
+	return comp_offset + sizeof(*comp) +
+	       (count * sizeof(struct ffa_cons_mrd));
+}
+
+/* Check a retrieved descriptor against its handle and tag */
+static void check_desc(const uint8_t *buf, size_t size, uint64_t handle,
+		       uint64_t tag)
+{
+	const struct ffa_mtd *mtd = (const struct ffa_mtd *)buf;
+	unsigned int count = TAG_COUNT(tag), mask = TAG_MASK(tag);
+	const struct ffa_emad_v1_0 *emad;
+	const struct ffa_comp_mrd *comp;
+	unsigned int i;
+
+	CHECK(mtd->handle == handle);
+	CHECK(mtd->tag == tag);
+	CHECK(mtd->sender_id == NWD_ID);
+	CHECK((mtd->flags & FFA_MTD_FLAG_TYPE_MASK) ==
+	      FFA_MTD_FLAG_TYPE_SHARE_MEMORY);
+	CHECK((mtd->memory_region_attributes & FFA_MEM_ATTR_NS_BIT) != 0U);
+	CHECK(mtd->emad_count == num_receivers(mask));
+
+	emad = (const struct ffa_emad_v1_0 *)(buf + mtd->emad_offset);
+	comp = (const struct ffa_comp_mrd *)(buf + emad->comp_mrd_offset);
+	CHECK(size == (emad->comp_mrd_offset + sizeof(*comp) +
+		       (count * sizeof(struct ffa_cons_mrd))));
+	CHECK(comp->address_range_count == count);
+	for (i = 0U; i < count; i++) {
+		CHECK(comp->address_range_array[i].address ==
+		      (TAG_BASE(tag) + (i * 0x2000U)));
+		CHECK(comp->address_range_array[i].page_count == 1U);
+	}
+}
+
+/*
+ * Share the descriptor in @buf from the Normal world, a page at a time.
+ * Return 0 and the handle, or the FF-A error.
+ */
+static int nwd_share(const uint8_t *buf, size_t size, uint64_t *handle)
+{
+	cpu_context_t ctx;
+	size_t offset, frag;
+
+	frag = MIN(size, (size_t)FFA_PAGE_SIZE);
+	pthread_mutex_lock(&nwd_buf_lock);
+	memcpy((void *)nwd_mbox.tx_buffer, buf, frag);
+	spmc_ffa_mem_send(FFA_MEM_SHARE_SMC64, false, size, frag, 0U, 0U,
+			  NULL, &ctx, 0U);
+	pthread_mutex_unlock(&nwd_buf_lock);
+	offset = frag;
+
+	while (reg(&ctx, 0U) == FFA_MEM_FRAG_RX) {
+		CHECK(reg(&ctx, 3U) == offset);
+		CHECK(offset < size);
+		frag = MIN(size - offset, (size_t)FFA_PAGE_SIZE);
+		pthread_mutex_lock(&nwd_buf_lock);
+		memcpy((void *)nwd_mbox.tx_buffer, buf + offset, frag);
+		spmc_ffa_mem_frag_tx(FFA_MEM_FRAG_TX, false, reg(&ctx, 1U),
+				     reg(&ctx, 2U), frag, NWD_ID << 16, NULL,
+				     &ctx, 0U);
+		pthread_mutex_unlock(&nwd_buf_lock);
+		offset += frag;
+	}
+
+	if (reg(&ctx, 0U) == FFA_ERROR) {
+		return (int)reg(&ctx, 2U);
+	}
+
+	CHECK(reg(&ctx, 0U) == FFA_SUCCESS_SMC32);
+	CHECK(offset == size);
+	*handle = reg(&ctx, 2U) | (reg(&ctx, 3U) << 32);
+
+	return 0;
+}
+
+static int nwd_reclaim(uint64_t handle)
+{
+	cpu_context_t ctx;
+
+	spmc_ffa_mem_reclaim(FFA_MEM_RECLAIM, false, (uint32_t)handle,
+			     (uint32_t)(handle >> 32), 0U, 0U, NULL, &ctx, 0U);
+	if (reg(&ctx, 0U) == FFA_ERROR) {
+		return (int)reg(&ctx, 2U);
+	}
+	CHECK(reg(&ctx, 0U) == FFA_SUCCESS_SMC32);
+
+	return 0;
+}
+
+/* FFA_RX_RELEASE */
+static void sp_rx_release(struct secure_partition_desc *sp)
+{
+	spin_lock(&sp->mailbox.lock);
+	sp->mailbox.state = MAILBOX_STATE_EMPTY;
+	spin_unlock(&sp->mailbox.lock);
+}
+
+/*
+ * Retrieve the transaction of @handle and @tag into @buf from the partition
+ * of the current CPU. Return 0 and the size of the descriptor, or the FF-A
+ * error.
+ */
+static int sp_retrieve(struct cpu *cpu, uint64_t handle, uint64_t tag,
+		       uint8_t *buf, size_t *size)
+{
+	struct secure_partition_desc *sp = cpu->sp;
+	struct mailbox *mbox = &sp->mailbox;
+	struct ffa_mtd *req = (struct ffa_mtd *)mbox->tx_buffer;
+	struct ffa_emad_v1_0 *emad;
+	unsigned int i, n = 0U, mask = TAG_MASK(tag);
+	size_t req_size, total, offset;
+	pthread_mutex_t *buf_lock = &sp_buf_lock[sp - sps];
+	cpu_context_t ctx;
+
+	pthread_mutex_lock(buf_lock);
+
+	req_size = sizeof(*req) + (num_receivers(mask) * sizeof(*emad));
+	memset(req, 0, req_size);
+	req->sender_id = NWD_ID;
+	req->handle = handle;
+	req->tag = tag;
+	req->emad_size = sizeof(*emad);
+	req->emad_count = num_receivers(mask);
+	req->emad_offset = sizeof(*req);
+	emad = (struct ffa_emad_v1_0 *)(req + 1);
+	for (i = 0U; i < NUM_SPS; i++) {
+		if ((mask & (1U << i)) != 0U) {
+			emad[n++].mapd.endpoint_id = SP_ID(i);
+		}
+	}
+
+	spmc_ffa_mem_retrieve_req(FFA_MEM_RETRIEVE_REQ_SMC64, true,
+				  req_size, req_size, 0U, 0U, NULL, &ctx, 0U);
+	if (reg(&ctx, 0U) == FFA_ERROR) {
+		pthread_mutex_unlock(buf_lock);
+		return (int)reg(&ctx, 2U);
+	}
+
+	CHECK(reg(&ctx, 0U) == FFA_MEM_RETRIEVE_RESP);
+	total = reg(&ctx, 1U);
+	offset = reg(&ctx, 2U);
+	CHECK((total <= MAX_DESC_SIZE) && (offset <= total));
+	memcpy(buf, mbox->rx_buffer, offset);
+	sp_rx_release(sp);
+
+	/* The transaction cannot be reclaimed until it is relinquished */
+	while (offset < total) {
+		spmc_ffa_mem_frag_rx(FFA_MEM_FRAG_RX, true, (uint32_t)handle,
+				     (uint32_t)(handle >> 32), offset, 0U,
+				     NULL, &ctx, 0U);
+		CHECK(reg(&ctx, 0U) == FFA_MEM_FRAG_TX);
+		CHECK((reg(&ctx, 3U) != 0U) &&
+		      (reg(&ctx, 3U) <= (total - offset)));
+		memcpy(buf + offset, mbox->rx_buffer, reg(&ctx, 3U));
+		offset += reg(&ctx, 3U);
+		sp_rx_release(sp);
+	}
+
+	pthread_mutex_unlock(buf_lock);
+	*size = total;
+
+	return 0;
+}
+
+static void sp_relinquish(struct secure_partition_desc *sp, uint64_t handle)
+{
+	struct ffa_mem_relinquish_descriptor *req =
+		(struct ffa_mem_relinquish_descriptor *)sp->mailbox.tx_buffer;
+	pthread_mutex_t *buf_lock = &sp_buf_lock[sp - sps];
+	cpu_context_t ctx;
+
+	pthread_mutex_lock(buf_lock);
+	req->handle = handle;
+	req->flags = 0U;
+	req->endpoint_count = 1U;
+	req->endpoint_array[0] = sp->sp_id;
+	spmc_ffa_mem_relinquish(FFA_MEM_RELINQUISH, true, 0U, 0U, 0U, 0U,
+				NULL, &ctx, 0U);
+	pthread_mutex_unlock(buf_lock);
+
+	CHECK(reg(&ctx, 0U) == FFA_SUCCESS_SMC32);
+}
+
+static unsigned int rand_cpu(struct cpu *cpu, unsigned int n)
+{
+	return (unsigned int)rand_r(&cpu->seed) % n;
+}
+
+static void op_share(struct cpu *cpu, struct share *share)
+{
+	unsigned int count = 1U + rand_cpu(cpu, MAX_CONSTITUENTS);
+	unsigned int mask = 1U + rand_cpu(cpu, (1U << NUM_SPS) - 1U);
+	uint64_t gen = atomic_fetch_add(&next_gen, 1U);
+	uint64_t tag = TAG(gen, count, mask);
+	uint64_t handle;
+	int ret;
+
+	ret = nwd_share(cpu->desc, build_desc(cpu->desc, tag), &handle);
+	if (ret == FFA_ERROR_NO_MEMORY) {
+		cpu->no_memory++;
+		return;
+	}
+	CHECK(ret == 0);
+	CHECK(handle != 0U);
+
+	atomic_store_explicit(&share->tag, tag, memory_order_relaxed);
+	atomic_store_explicit(&share->handle, handle, memory_order_relaxed);
+	cpu->shared++;
+}
+
+/* A transaction overlapping a live one must be rejected */
+static void op_overlap(struct cpu *cpu, struct share *share)
+{
+	uint64_t tag = atomic_load_explicit(&share->tag, memory_order_relaxed);
+	uint64_t handle;
+	int ret;
+
+	ret = nwd_share(cpu->desc, build_desc(cpu->desc, tag), &handle);
+	CHECK((ret == FFA_ERROR_INVALID_PARAMETER) ||
+	      (ret == FFA_ERROR_NO_MEMORY));
+	cpu->overlaps++;
+}
+
+static void op_retrieve(struct cpu *cpu, struct share *share, bool own)
+{
+	uint64_t handle, tag;
+	size_t size;
+	int ret;
+
+	if (cpu->num_held == MAX_HELD) {
+		return;
+	}
+
+	handle = atomic_load_explicit(&share->handle, memory_order_relaxed);
+	tag = atomic_load_explicit(&share->tag, memory_order_relaxed);
+	if (handle == 0U) {
+		return;
+	}
+
+	ret = sp_retrieve(cpu, handle, tag, cpu->desc, &size);
+	if (ret != 0) {
+		/*
+		 * Another CPU may have reclaimed the transaction or reused the
+		 * slot, or this partition is not a receiver.
+		 */
+		CHECK(ret == FFA_ERROR_INVALID_PARAMETER);
+		CHECK(!own || ((TAG_MASK(tag) &
+				(1U << (cpu->sp - sps))) == 0U));
+		cpu->retrieve_failed++;
+		return;
+	}
+
+	check_desc(cpu->desc, size, handle, tag);
+	atomic_fetch_add_explicit(&share->retrieved, 1, memory_order_relaxed);
+	cpu->held[cpu->num_held].handle = handle;
+	cpu->held[cpu->num_held].share = share;
+	cpu->num_held++;
+	cpu->retrieved++;
+}
+
+static void op_relinquish(struct cpu *cpu, unsigned int i)
+{
+	struct held *held = &cpu->held[i];
+
+	atomic_fetch_sub_explicit(&held->share->retrieved, 1,
+				  memory_order_relaxed);
+	sp_relinquish(cpu->sp, held->handle);
+	*held = cpu->held[--cpu->num_held];
+	cpu->relinquished++;
+}
+
+static void op_reclaim(struct cpu *cpu, struct share *share)
+{
+	uint64_t handle = atomic_load_explicit(&share->handle,
+					       memory_order_relaxed);
+	int ret = nwd_reclaim(handle);
+
+	if (ret == FFA_ERROR_DENIED) {
+		cpu->reclaim_denied++;
+		return;
+	}
+
+	/* Only the owner reclaims, and all retrievals were relinquished */
+	CHECK(ret == 0);
+	CHECK(atomic_load_explicit(&share->retrieved,
+				   memory_order_relaxed) == 0);
+	atomic_store_explicit(&share->handle, 0U, memory_order_relaxed);
+	cpu->reclaimed++;
+}
+
+static void *cpu_main(void *arg)
+{
+	struct cpu *cpu = arg;
+	struct share *own = shares[cpu->id];
+	struct share *share;
+	unsigned long n;
+	unsigned int op;
+	bool live;
+
+	current_sp = cpu->sp;
+
+	for (n = 0U; n < iterations; n++) {
+		op = rand_cpu(cpu, 16U);
+		share = &own[rand_cpu(cpu, SHARES_PER_CPU)];
+		live = atomic_load_explicit(&share->handle,
+					    memory_order_relaxed) != 0U;
+
+		if (op < 4U) {
+			if (!live) {
+				op_share(cpu, share);
+			}
+		} else if (op < 7U) {
+			op_retrieve(cpu, share, true);
+		} else if (op < 10U) {
+			share = &shares[rand_cpu(cpu, num_cpus)]
+				       [rand_cpu(cpu, SHARES_PER_CPU)];
+			op_retrieve(cpu, share, false);
+		} else if (op < 13U) {
+			if (cpu->num_held != 0U) {
+				op_relinquish(cpu,
+					      rand_cpu(cpu, cpu->num_held));
+			}
+		} else if (op < 15U) {
+			if (live) {
+				op_reclaim(cpu, share);
+			}
+		} else if (live) {
+			op_overlap(cpu, share);
+		}
+	}
+
+	return NULL;
+}
+
+static void init_mailbox(struct mailbox *mbox)
+{
+	mbox->state = MAILBOX_STATE_EMPTY;
+	mbox->rx_buffer = alloc_page();
+	mbox->tx_buffer = alloc_page();
+	mbox->rxtx_page_count = 1U;
+}
+
+int main(int argc, char **argv)
+{
+	struct spmc_shmem_obj_state *state = &spmc_shmem_obj_state;
+	struct spmc_shmem_obj *initial[SPMC_SHMEM_BLOCK_ORDERS];
+	struct cpu total = { 0 };
+	unsigned int seed = 1U, i, j;
+	struct timespec t0, t1;
+	struct cpu *cpu;
+	double secs;
+
+	if (argc > 1) {
+		iterations = strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		num_cpus = (unsigned int)strtoul(argv[2], NULL, 0);
+	}
+	if (argc > 3) {
+		seed = (unsigned int)strtoul(argv[3], NULL, 0);
+	}
+	CHECK((num_cpus != 0U) && (num_cpus <= PLATFORM_CORE_COUNT));
+
+	state->data = malloc(DATASTORE_SIZE);
+	CHECK(state->data != NULL);
+	state->data_size = DATASTORE_SIZE;
+	spmc_shmem_obj_state_init(state);
+	memcpy(initial, state->free_list, sizeof(initial));
+
+	init_mailbox(&nwd_mbox);
+	for (i = 0U; i < NUM_SPS; i++) {
+		sps[i].sp_id = SP_ID(i);
+		sps[i].runtime_el = S_EL1;
+		sps[i].ffa_version = MAKE_FFA_VERSION(1, 1);
+		init_mailbox(&sps[i].mailbox);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0U; i < num_cpus; i++) {
+		cpu = &cpus[i];
+		cpu->id = i;
+		cpu->seed = seed + i;
+		cpu->sp = &sps[i % NUM_SPS];
+		CHECK(pthread_create(&cpu->thread, NULL, cpu_main, cpu) == 0);
+	}
+	for (i = 0U; i < num_cpus; i++) {
+		CHECK(pthread_join(cpus[i].thread, NULL) == 0);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	secs = (double)(t1.tv_sec - t0.tv_sec) +
+	       ((double)(t1.tv_nsec - t0.tv_nsec) / 1e9);
+
+	/* Relinquish and reclaim what is left, everything must be freed */
+	for (i = 0U; i < num_cpus; i++) {
+		cpu = &cpus[i];
+		current_sp = cpu->sp;
+		while (cpu->num_held != 0U) {
+			op_relinquish(cpu, 0U);
+		}
+	}
+	for (i = 0U; i < num_cpus; i++) {
+		for (j = 0U; j < SHARES_PER_CPU; j++) {
+			if (atomic_load(&shares[i][j].handle) != 0U) {
+				op_reclaim(&cpus[i], &shares[i][j]);
+			}
+			CHECK(atomic_load(&shares[i][j].handle) == 0U);
+		}
+	}
+	CHECK(state->allocated == 0U);
+	CHECK(memcmp(initial, state->free_list, sizeof(initial)) == 0);
+
+	for (i = 0U; i < num_cpus; i++) {
+		cpu = &cpus[i];
+		total.shared += cpu->shared;
+		total.no_memory += cpu->no_memory;
+		total.retrieved += cpu->retrieved;
+		total.retrieve_failed += cpu->retrieve_failed;
+		total.relinquished += cpu->relinquished;
+		total.reclaimed += cpu->reclaimed;
+		total.reclaim_denied += cpu->reclaim_denied;
+		total.overlaps += cpu->overlaps;
+	}
+	CHECK(total.relinquished == total.retrieved);
+	CHECK(total.reclaimed == total.shared);
+
+	printf("%u CPUs, %lu operations each in %.3f s\n", num_cpus,
+	       iterations, secs);
+	printf("%lu shared (%lu out of memory), %lu retrieved (%lu failed), %lu relinquished\n",
+	       total.shared, total.no_memory, total.retrieved,
+	       total.retrieve_failed, total.relinquished);
+	printf("%lu reclaimed (%lu denied), %lu overlapping shares rejected\n",
+	       total.reclaimed, total.reclaim_denied, total.overlaps);
+	printf("Datastore coalesced back to its initial blocks\n");
+
+	return 0;
+}
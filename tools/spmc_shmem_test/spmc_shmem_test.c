@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test of the buddy allocator of the shared memory datastore of the EL3
+ * SPMC.
+ *
+ * services/std_svc/spm/el3_spmc/spmc_shared_mem.c is included so that its
+ * static functions can be called. Objects are allocated with random FF-A
+ * descriptor sizes and freed at random around a live set of one object per
+ * 1KB of datastore, and a random live handle is looked up after each
+ * operation, as the FF-A memory sharing calls do. The descriptor of each
+ * object is filled with a pattern of its handle, which is checked on lookup
+ * and before the object is freed. After each operation, the blocks must tile
+ * the datastore, be on a free list if and only if they are free, and not have
+ * a free buddy of the same order. Once all the objects are freed, the
+ * datastore must be back to the blocks it was carved into at init.
+ *
+ * The same operations are then timed without the checks, and the number of
+ * failed allocations and the fragmentation of the datastore are reported.
+ *
+ * Usage: spmc_shmem_test [iterations [datastore_size [seed]]]
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <spmc_shared_mem.c>
+
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			fprintf(stderr, "%s:%d: check failed: %s\n",	\
+				__FILE__, __LINE__, #cond);		\
+			exit(1);					\
+		}							\
+	} while (0)
+
+/* Functions of the rest of the SPMC, not reached by the test */
+#define NOT_REACHED()	CHECK(false)
+
+struct secure_partition_desc *spmc_get_current_sp_ctx(void)
+{
+	NOT_REACHED();
+	return NULL;
+}
+
+struct secure_partition_desc *spmc_get_sp_ctx(uint16_t id)
+{
+	NOT_REACHED();
+	return NULL;
+}
+
+struct mailbox *spmc_get_mbox_desc(bool secure_origin)
+{
+	NOT_REACHED();
+	return NULL;
+}
+
+uint64_t spmc_ffa_error_return(void *handle, int error_code)
+{
+	NOT_REACHED();
+	return 0U;
+}
+
+uint32_t get_partition_ffa_version(bool secure_origin)
+{
+	NOT_REACHED();
+	return 0U;
+}
+
+int plat_spmc_shmem_begin(struct ffa_mtd *desc)
+{
+	return 0;
+}
+
+int plat_spmc_shmem_reclaim(struct ffa_mtd *desc)
+{
+	return 0;
+}
+
+void spin_lock(spinlock_t *lock)
+{
+}
+
+void spin_unlock(spinlock_t *lock)
+{
+}
+
+/* The report of the failed allocations is counted, not printed */
+static unsigned long num_log;
+
+void tf_log(const char *fmt, ...)
+{
+	num_log++;
+}
+
+struct live_obj {
+	struct spmc_shmem_obj *obj;
+	uint64_t handle;
+};
+
+static struct live_obj *live;
+static unsigned int num_live, max_live;
+static uint64_t next_handle = 1U;
+
+/* Statistics of the allocations */
+static unsigned long num_alloc, num_failed;
+static double free_at_failure, used_ratio;
+static unsigned long num_samples;
+
+static uint8_t pattern(uint64_t handle, size_t i)
+{
+	return (uint8_t)((handle * 31U) + i);
+}
+
+static void fill(struct spmc_shmem_obj *obj)
+{
+	uint8_t *desc = (uint8_t *)&obj->desc;
+	size_t i;
+
+	for (i = 0U; i < obj->desc_size; i++) {
+		desc[i] = pattern(obj->handle, i);
+	}
+}
+
+static bool intact(struct spmc_shmem_obj *obj)
+{
+	uint8_t *desc = (uint8_t *)&obj->desc;
+	size_t i;
+
+	for (i = 0U; i < obj->desc_size; i++) {
+		if (desc[i] != pattern(obj->handle, i)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Size of a descriptor with 1 to 4 endpoints and up to 256 constituents,
+ * small descriptors being the most common.
+ */
+static size_t random_desc_size(void)
+{
+	unsigned int endpoints = 1U + (rand() % 4U);
+	unsigned int constituents = 1U + (rand() % (1U << (rand() % 9U)));
+
+	return sizeof(struct ffa_mtd) +
+	       (endpoints * sizeof(struct ffa_emad_v1_0)) +
+	       sizeof(struct ffa_comp_mrd) +
+	       (constituents * sizeof(struct ffa_cons_mrd));
+}
+
+/* Check the blocks of the datastore and the free lists */
+static void check_blocks(struct spmc_shmem_obj_state *state)
+{
+	struct spmc_shmem_obj *blk, *buddy;
+	size_t offset = 0U, allocated = 0U, size, boff;
+	unsigned int num_free = 0U, listed = 0U;
+	uint32_t order;
+
+	while (offset < state->data_size) {
+		blk = (struct spmc_shmem_obj *)(state->data + offset);
+		CHECK(blk->order < SPMC_SHMEM_BLOCK_ORDERS);
+		size = spmc_shmem_block_size(blk->order);
+		CHECK((offset & (size - 1U)) == 0U);
+		CHECK((offset + size) <= state->data_size);
+
+		if (blk->is_free) {
+			num_free++;
+			boff = offset ^ size;
+			buddy = (struct spmc_shmem_obj *)(state->data + boff);
+			if (((offset & ~((2U * size) - 1U)) + (2U * size) <=
+			     state->data_size) &&
+			    ((blk->order + 1U) < SPMC_SHMEM_BLOCK_ORDERS)) {
+				CHECK(!buddy->is_free ||
+				      (buddy->order != blk->order));
+			}
+		} else {
+			CHECK(spmc_shmem_obj_size(blk->desc_size) <= size);
+			allocated += size;
+		}
+		offset += size;
+	}
+	CHECK(offset == state->data_size);
+	CHECK(allocated == state->allocated);
+
+	for (order = 0U; order < SPMC_SHMEM_BLOCK_ORDERS; order++) {
+		for (blk = state->free_list[order]; blk != NULL;
+		     blk = blk->next_free) {
+			CHECK(blk->is_free && (blk->order == order));
+			CHECK((blk->next_free == NULL) ||
+			      (blk->next_free->prev_free == blk));
+			listed++;
+		}
+	}
+	CHECK(listed == num_free);
+}
+
+static void op_alloc(struct spmc_shmem_obj_state *state)
+{
+	struct spmc_shmem_obj *obj;
+	size_t desc_size = random_desc_size();
+
+	num_alloc++;
+	obj = spmc_shmem_obj_alloc(state, desc_size);
+	if (obj == NULL) {
+		num_failed++;
+		free_at_failure += (double)(state->data_size -
+					    state->allocated) /
+				   state->data_size;
+		return;
+	}
+
+	CHECK(num_live < max_live);
+	obj->handle = next_handle++;
+	fill(obj);
+	live[num_live].obj = obj;
+	live[num_live].handle = obj->handle;
+	num_live++;
+}
+
+static void op_free(struct spmc_shmem_obj_state *state, bool checks)
+{
+	unsigned int i = rand() % num_live;
+
+	if (checks) {
+		CHECK(intact(live[i].obj));
+	}
+	spmc_shmem_obj_free(state, live[i].obj);
+	live[i] = live[--num_live];
+}
+
+static void op_lookup(struct spmc_shmem_obj_state *state, bool checks)
+{
+	struct spmc_shmem_obj *obj;
+	unsigned int i;
+
+	if (num_live == 0U) {
+		return;
+	}
+
+	i = rand() % num_live;
+	obj = spmc_shmem_obj_lookup(state, live[i].handle);
+	CHECK(obj == live[i].obj);
+	if (checks) {
+		CHECK(intact(obj));
+	}
+}
+
+static void churn(struct spmc_shmem_obj_state *state, unsigned long iterations,
+		  unsigned int target, bool checks)
+{
+	unsigned long n;
+	size_t used;
+	unsigned int i;
+
+	for (n = 0U; n < iterations; n++) {
+		/* Tend towards the target number of live objects */
+		if ((num_live == 0U) ||
+		    ((num_live < target) ? ((rand() % 10U) < 6U) :
+					   ((rand() % 10U) < 4U))) {
+			op_alloc(state);
+		} else {
+			op_free(state, checks);
+		}
+		op_lookup(state, checks);
+
+		if (!checks) {
+			continue;
+		}
+		check_blocks(state);
+
+		if ((n % 64U) == 0U) {
+			used = 0U;
+			for (i = 0U; i < num_live; i++) {
+				used += spmc_shmem_obj_size(
+						live[i].obj->desc_size);
+			}
+			if (state->allocated != 0U) {
+				used_ratio += (double)used / state->allocated;
+				num_samples++;
+			}
+		}
+	}
+}
+
+static void free_all(struct spmc_shmem_obj_state *state)
+{
+	while (num_live != 0U) {
+		op_free(state, true);
+	}
+	check_blocks(state);
+}
+
+int main(int argc, char **argv)
+{
+	struct spmc_shmem_obj_state *state = &spmc_shmem_obj_state;
+	struct spmc_shmem_obj *initial[SPMC_SHMEM_BLOCK_ORDERS];
+	unsigned long iterations = 200000U;
+	size_t data_size = 0x80000U;
+	unsigned int seed = 1U, target;
+	struct timespec t0, t1;
+	uint8_t *data;
+	double secs;
+
+	if (argc > 1) {
+		iterations = strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		data_size = strtoul(argv[2], NULL, 0);
+	}
+	if (argc > 3) {
+		seed = (unsigned int)strtoul(argv[3], NULL, 0);
+	}
+
+	data = malloc(data_size);
+	CHECK(data != NULL);
+	state->data = data;
+	state->data_size = data_size;
+	spmc_shmem_obj_state_init(state);
+	CHECK(state->data_size == (data_size & ~(SPMC_SHMEM_BLOCK_MIN - 1U)));
+	check_blocks(state);
+	memcpy(initial, state->free_list, sizeof(initial));
+
+	target = data_size / 1024U;
+	max_live = data_size / SPMC_SHMEM_BLOCK_MIN;
+	live = calloc(max_live, sizeof(*live));
+	CHECK(live != NULL);
+
+	srand(seed);
+	churn(state, iterations, target, true);
+	printf("%lu operations, %lu allocations: %lu failed (%.2f%%), %.0f%% of the datastore free on average when failing\n",
+	       iterations, num_alloc, num_failed,
+	       (100.0 * num_failed) / num_alloc,
+	       (num_failed != 0U) ? (100.0 * free_at_failure) / num_failed :
+				    0.0);
+	printf("Objects use %.0f%% of their blocks on average\n",
+	       (num_samples != 0U) ? (100.0 * used_ratio) / num_samples : 0.0);
+	CHECK(num_log >= num_failed);
+
+	free_all(state);
+	CHECK(state->allocated == 0U);
+	CHECK(memcmp(initial, state->free_list, sizeof(initial)) == 0);
+	printf("Datastore coalesced back to its initial blocks\n");
+
+	/* Same operations, timed without the checks */
+	srand(seed);
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	churn(state, iterations, target, false);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	secs = (double)(t1.tv_sec - t0.tv_sec) +
+	       ((double)(t1.tv_nsec - t0.tv_nsec) / 1e9);
+	printf("%lu operations with lookups in %.3f s with a 0x%zx byte datastore\n",
+	       iterations, secs, data_size);
+
+	free_all(state);
+	CHECK(memcmp(initial, state->free_list, sizeof(initial)) == 0);
+
+	free(live);
+	free(data);
+
+	return 0;
+}
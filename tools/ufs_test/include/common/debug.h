@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host replacement of include/common/debug.h */
+
+#ifndef DEBUG_H
+#define DEBUG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ERROR(...)	fprintf(stderr, "ERROR: " __VA_ARGS__)
+#define WARN(...)	fprintf(stderr, "WARNING: " __VA_ARGS__)
+#define NOTICE(...)
+#define INFO(...)
+#define VERBOSE(...)
+
+#define panic()		abort()
+
+#endif /* DEBUG_H */
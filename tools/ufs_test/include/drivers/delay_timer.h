@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host replacement of include/drivers/delay_timer.h. The delays advance the
+ * time of the UFSHCI model.
+ */
+
+#ifndef DELAY_TIMER_H
+#define DELAY_TIMER_H
+
+#include <stdint.h>
+
+void mdelay(uint32_t msec);
+void udelay(uint32_t usec);
+
+#endif /* DELAY_TIMER_H */
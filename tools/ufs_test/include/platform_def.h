@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* The driver only needs the cache line size of the platform */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+#define CACHE_WRITEBACK_GRANULE		64
+
+#endif /* PLATFORM_DEF_H */
@@ -0,0 +1,522 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host model test of the queued reads of the UFS driver.
+ *
+ * drivers/ufs/ufs.c is built for the host with its register accesses going
+ * to a model of the UFSHCI. Ringing the doorbell of a slot starts the command
+ * described by its UTRD on one of MODEL_UNITS units of the device, which each
+ * serve one command at a time with a random latency, so that the commands
+ * complete out of order. The model time advances on each register access and
+ * on each delay of the driver.
+ *
+ * For 1, 8 and 32 slots, ufs_read_blocks_queued() must return the data of the
+ * device and keep all the slots busy, and its model time is compared with the
+ * one of ufs_read_blocks(). A Unit Attention must only re-issue the command
+ * it is reported for. A UTP error must clear the slots in flight with
+ * UTRLCLR, or disable the controller if they are not released, so that no
+ * DMA happens once the read has returned.
+ *
+ * Usage: ufs_test [seed]
+ */
+
+#include <endian.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <drivers/delay_timer.h>
+#include <drivers/ufs.h>
+#include <lib/mmio.h>
+
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			fprintf(stderr, "%s:%d: check failed: %s\n",	\
+				__FILE__, __LINE__, #cond);		\
+			exit(1);					\
+		}							\
+	} while (0)
+
+#define REG_BASE		UL(0x10000000)
+#define REG_SIZE		0x100
+
+/* Transfer request list and one 1KB command descriptor per slot */
+#define MAX_SLOTS		32
+#define DESC_SIZE		(0x400 * (MAX_SLOTS + 1))
+
+#define TEST_LUN		3
+#define TEST_LBA		0x100
+#define TEST_SIZE		(64 << 20)
+
+/* Largest read of ufs_read_blocks() fitting in a command descriptor */
+#define SINGLE_SIZE		(8 << 20)
+
+/* Device model: 4 units of 400MB/s, 100 to 150us of latency per command */
+#define MODEL_UNITS		4
+#define MODEL_LATENCY_NS	100000
+#define MODEL_JITTER_NS		50000
+#define MODEL_NS_PER_KB		2500
+#define MODEL_MMIO_NS		100
+
+static uint32_t regs[REG_SIZE / 4];
+#define REG(off)		regs[(off) / 4]
+
+static struct {
+	uint64_t done;		/* Completion time */
+	bool error;		/* Completes with a UTP error */
+	bool unit_attention;	/* Completes with a Unit Attention */
+} slots[MAX_SLOTS];
+
+static uint64_t now;
+static uint64_t unit_free[MODEL_UNITS];
+
+/* Index of the command to fail, or -1 */
+static int fail_cmd, ua_cmd;
+/* The controller does not release the slots written to UTRLCLR */
+static bool ignore_clear;
+
+/* Statistics of the model */
+static unsigned int num_cmds, max_depth, num_cleared;
+static unsigned long long dma_bytes;
+
+static uint8_t desc_area[DESC_SIZE] __attribute__((aligned(4096)));
+
+static uint8_t disk_byte(unsigned int lun, uint64_t pos)
+{
+	return (uint8_t)(((pos >> UFS_BLOCK_SHIFT) * 131U) + (pos * 7U) + lun);
+}
+
+static utrd_header_t *slot_utrd(unsigned int slot)
+{
+	uintptr_t base = ((uintptr_t)REG(UTRLBAU) << 32) | REG(UTRLBA);
+
+	return (utrd_header_t *)(base + (slot * sizeof(utrd_header_t)));
+}
+
+static uintptr_t slot_ucd(unsigned int slot)
+{
+	utrd_header_t *hd = slot_utrd(slot);
+
+	return ((uintptr_t)hd->ucdbau << 32) | hd->ucdba;
+}
+
+static size_t cmd_length(cmd_upiu_t *upiu)
+{
+	if ((upiu->trans_type != CMD_UPIU) || (upiu->cdb[0] != CDBCMD_READ_10)) {
+		return 0U;
+	}
+
+	return (size_t)((upiu->cdb[7] << 8) | upiu->cdb[8]) << UFS_BLOCK_SHIFT;
+}
+
+/* Copy the data of a READ_10 to the regions of its PRDT */
+static void model_dma(unsigned int slot)
+{
+	utrd_header_t *hd = slot_utrd(slot);
+	cmd_upiu_t *upiu = (cmd_upiu_t *)slot_ucd(slot);
+	prdt_t *prdt;
+	uint64_t pos;
+	size_t len, sz, i;
+	unsigned int n;
+	uint8_t *buf;
+
+	len = cmd_length(upiu);
+	CHECK(be32toh(upiu->exp_data_trans_len) == len);
+
+	pos = (((uint64_t)upiu->cdb[2] << 24) | (upiu->cdb[3] << 16) |
+	       (upiu->cdb[4] << 8) | upiu->cdb[5]) << UFS_BLOCK_SHIFT;
+
+	/* The driver programs PRDTO and PRDTL in double words */
+	prdt = (prdt_t *)(slot_ucd(slot) + (hd->prdto * 4U));
+	for (n = 0U; len != 0U; n++, prdt++) {
+		CHECK(n < ((hd->prdtl * 4U) / sizeof(prdt_t)));
+		buf = (uint8_t *)(((uintptr_t)prdt->dbau << 32) | prdt->dba);
+		sz = prdt->dbc + 1U;
+		CHECK(sz <= len);
+		for (i = 0U; i < sz; i++) {
+			buf[i] = disk_byte(upiu->lun, pos + i);
+		}
+		pos += sz;
+		len -= sz;
+		dma_bytes += sz;
+	}
+}
+
+static void model_complete(unsigned int slot)
+{
+	utrd_header_t *hd = slot_utrd(slot);
+	cmd_upiu_t *upiu = (cmd_upiu_t *)slot_ucd(slot);
+	resp_upiu_t *resp = (resp_upiu_t *)(slot_ucd(slot) + (hd->ruo * 4U));
+
+	REG(UTRLDBR) &= ~(1U << slot);
+
+	if (slots[slot].error) {
+		hd->ocs = OCS_FATAL_ERROR;
+		REG(IS) |= UFS_INT_UTPES;
+		return;
+	}
+
+	CHECK(upiu->trans_type == CMD_UPIU);
+	resp->trans_type = RESPONSE_UPIU;
+	resp->task_tag = upiu->task_tag;
+	resp->lun = upiu->lun;
+	resp->res_trans_cnt = 0U;
+
+	if (slots[slot].unit_attention) {
+		resp->sd.sense.resp_code = SENSE_DATA_VALID;
+		resp->sd.sense.sense_key = SENSE_KEY_UNIT_ATTENTION;
+		resp->sd.sense.asc = 0x29;
+		resp->sd.sense.ascq = 0;
+	} else if (upiu->cdb[0] == CDBCMD_READ_10) {
+		model_dma(slot);
+	}
+
+	hd->ocs = OCS_SUCCESS;
+	REG(IS) |= UFS_INT_UTRCS;
+}
+
+/* Complete the commands whose time has come */
+static void model_update(void)
+{
+	unsigned int slot;
+
+	for (slot = 0U; slot < MAX_SLOTS; slot++) {
+		if (((REG(UTRLDBR) & (1U << slot)) != 0U) &&
+		    (slots[slot].done <= now)) {
+			model_complete(slot);
+		}
+	}
+}
+
+/* Start the commands of the slots whose doorbell is rung */
+static void model_doorbell(uint32_t set)
+{
+	uint32_t start = set & ~REG(UTRLDBR);
+	unsigned int slot, unit, u, depth;
+	cmd_upiu_t *upiu;
+	uint64_t begin;
+
+	CHECK(REG(UTRLRSR) == 1U);
+
+	for (slot = 0U; slot < MAX_SLOTS; slot++) {
+		if ((start & (1U << slot)) == 0U) {
+			continue;
+		}
+		CHECK(slot <= (REG(CAP) & CAP_NUTRS_MASK));
+		CHECK(slot_utrd(slot)->ocs == OCS_MASK);
+		upiu = (cmd_upiu_t *)slot_ucd(slot);
+		CHECK(upiu->task_tag == (slot + 1U));
+
+		unit = 0U;
+		for (u = 1U; u < MODEL_UNITS; u++) {
+			if (unit_free[u] < unit_free[unit]) {
+				unit = u;
+			}
+		}
+		begin = (unit_free[unit] > now) ? unit_free[unit] : now;
+		slots[slot].done = begin + MODEL_LATENCY_NS +
+				   (rand() % MODEL_JITTER_NS) +
+				   ((cmd_length(upiu) >> 10) * MODEL_NS_PER_KB);
+		unit_free[unit] = slots[slot].done;
+
+		slots[slot].error = ((int)num_cmds == fail_cmd);
+		slots[slot].unit_attention = ((int)num_cmds == ua_cmd);
+		num_cmds++;
+	}
+
+	REG(UTRLDBR) |= start;
+	depth = __builtin_popcount(REG(UTRLDBR));
+	if (depth > max_depth) {
+		max_depth = depth;
+	}
+}
+
+/* The slots written as 0 to UTRLCLR are aborted without completing */
+static void model_clear(uint32_t value)
+{
+	uint32_t clear = ~value & REG(UTRLDBR);
+
+	if (ignore_clear) {
+		return;
+	}
+
+	num_cleared += __builtin_popcount(clear);
+	REG(UTRLDBR) &= ~clear;
+}
+
+static void model_uic(uint32_t op)
+{
+	unsigned int attr = REG(UCMDARG1) >> 16;
+
+	CHECK(op == DME_GET);
+
+	/* Link not in hibernate, one lane */
+	REG(UCMDARG2) = 0U;
+	REG(UCMDARG3) = (attr == 0x1568U) ? 1U : 0U;
+	REG(IS) |= UFS_INT_UCCS;
+}
+
+uint32_t mmio_read_32(uintptr_t addr)
+{
+	CHECK((addr >= REG_BASE) && (addr < (REG_BASE + REG_SIZE)));
+
+	now += MODEL_MMIO_NS;
+	model_update();
+
+	return REG(addr - REG_BASE);
+}
+
+void mmio_write_32(uintptr_t addr, uint32_t value)
+{
+	uintptr_t off = addr - REG_BASE;
+
+	CHECK((addr >= REG_BASE) && (addr < (REG_BASE + REG_SIZE)));
+
+	now += MODEL_MMIO_NS;
+
+	switch (off) {
+	case IS:
+		REG(IS) &= ~value;
+		break;
+	case UTRLDBR:
+		model_doorbell(value);
+		break;
+	case UTRLCLR:
+		model_clear(value);
+		break;
+	case HCE:
+		/* Disabling the controller stops all the transfers */
+		REG(HCE) = value & HCE_ENABLE;
+		if (value == HCE_DISABLE) {
+			REG(UTRLDBR) = 0U;
+		}
+		break;
+	case UICCMD:
+		model_uic(value);
+		break;
+	default:
+		REG(off) = value;
+		break;
+	}
+}
+
+void udelay(uint32_t usec)
+{
+	now += (uint64_t)usec * 1000U;
+}
+
+void mdelay(uint32_t msec)
+{
+	now += (uint64_t)msec * 1000000U;
+}
+
+static void model_init(unsigned int nutrs)
+{
+	ufs_params_t params = {
+		.reg_base = REG_BASE,
+		.desc_base = (uintptr_t)desc_area,
+		.desc_size = DESC_SIZE,
+		.flags = UFS_FLAGS_SKIPINIT,
+	};
+	int result;
+
+	memset(regs, 0, sizeof(regs));
+	memset(unit_free, 0, sizeof(unit_free));
+	REG(CAP) = nutrs - 1U;
+	REG(HCS) = HCS_UCRDY | HCS_UTRLRDY;
+	REG(HCE) = HCE_ENABLE;
+	now = 0U;
+	fail_cmd = -1;
+	ua_cmd = -1;
+	ignore_clear = false;
+
+	result = ufs_init(NULL, &params);
+	CHECK(result == 0);
+	CHECK(REG(UTRLBA) == (uint32_t)(uintptr_t)desc_area);
+}
+
+static void stats_reset(void)
+{
+	num_cmds = 0U;
+	max_depth = 0U;
+	num_cleared = 0U;
+}
+
+static bool data_ok(const uint8_t *buf, int lba, size_t size)
+{
+	uint64_t pos = (uint64_t)lba << UFS_BLOCK_SHIFT;
+	size_t i;
+
+	for (i = 0U; i < size; i++) {
+		if (buf[i] != disk_byte(TEST_LUN, pos + i)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static unsigned long long mb_per_s(size_t size, uint64_t ns)
+{
+	return ((unsigned long long)size * 1000U) / ns;
+}
+
+/* Compare the queued read with one command at a time */
+static void test_throughput(uint8_t *buf, unsigned int nutrs)
+{
+	uint64_t t_single, t_queued;
+	size_t n = 0U, off;
+
+	model_init(nutrs);
+
+	memset(buf, 0, TEST_SIZE);
+	stats_reset();
+	t_single = now;
+	for (off = 0U; off < TEST_SIZE; off += SINGLE_SIZE) {
+		n += ufs_read_blocks(TEST_LUN,
+				     TEST_LBA + (int)(off >> UFS_BLOCK_SHIFT),
+				     (uintptr_t)buf + off, SINGLE_SIZE);
+	}
+	t_single = now - t_single;
+	CHECK(n == TEST_SIZE);
+	CHECK(max_depth == 1U);
+	CHECK(data_ok(buf, TEST_LBA, TEST_SIZE));
+
+	memset(buf, 0, TEST_SIZE);
+	stats_reset();
+	t_queued = now;
+	n = ufs_read_blocks_queued(TEST_LUN, TEST_LBA, (uintptr_t)buf,
+				   TEST_SIZE);
+	t_queued = now - t_queued;
+	CHECK(n == TEST_SIZE);
+	CHECK(max_depth == nutrs);
+	CHECK(data_ok(buf, TEST_LBA, TEST_SIZE));
+
+	printf("%2u slots: ufs_read_blocks %llu MB/s, ufs_read_blocks_queued %llu MB/s, %u commands\n",
+	       nutrs, mb_per_s(TEST_SIZE, t_single),
+	       mb_per_s(TEST_SIZE, t_queued), num_cmds);
+
+	if (nutrs >= MODEL_UNITS) {
+		CHECK(t_queued < t_single);
+	}
+}
+
+/* Reads smaller than the number of slots, and not a multiple of it */
+static void test_split(uint8_t *buf)
+{
+	model_init(32U);
+
+	memset(buf, 0, 8U * UFS_BLOCK_SIZE);
+	stats_reset();
+	CHECK(ufs_read_blocks_queued(TEST_LUN, 3, (uintptr_t)buf,
+				     5U * UFS_BLOCK_SIZE) == 5U * UFS_BLOCK_SIZE);
+	CHECK((num_cmds == 5U) && (max_depth == 5U));
+	CHECK(data_ok(buf, 3, 5U * UFS_BLOCK_SIZE));
+	CHECK(buf[5U * UFS_BLOCK_SIZE] == 0U);
+
+	model_init(8U);
+
+	memset(buf, 0, 40U * UFS_BLOCK_SIZE);
+	stats_reset();
+	CHECK(ufs_read_blocks_queued(TEST_LUN, 7, (uintptr_t)buf,
+				     37U * UFS_BLOCK_SIZE) == 37U * UFS_BLOCK_SIZE);
+	CHECK((num_cmds == 8U) && (max_depth == 8U));
+	CHECK(data_ok(buf, 7, 37U * UFS_BLOCK_SIZE));
+	CHECK(buf[37U * UFS_BLOCK_SIZE] == 0U);
+
+	printf("Split of small reads OK\n");
+}
+
+/* A Unit Attention re-issues only the command it is reported for */
+static void test_unit_attention(uint8_t *buf)
+{
+	const size_t size = 16 << 20;
+
+	model_init(8U);
+
+	memset(buf, 0, size);
+	stats_reset();
+	ua_cmd = 3;
+	CHECK(ufs_read_blocks_queued(TEST_LUN, TEST_LBA, (uintptr_t)buf,
+				     size) == size);
+	CHECK(num_cmds == 9U);
+	CHECK(data_ok(buf, TEST_LBA, size));
+
+	printf("Unit Attention retry OK\n");
+}
+
+/*
+ * A UTP error aborts the slots in flight. Once the read has returned, the
+ * model must not write to the buffer anymore, even long after.
+ */
+static void test_abort(uint8_t *buf, bool stuck)
+{
+	const size_t size = TEST_SIZE;
+	unsigned long long dma;
+	uint8_t *copy;
+
+	model_init(8U);
+
+	copy = malloc(size);
+	CHECK(copy != NULL);
+
+	memset(buf, 0, size);
+	stats_reset();
+	fail_cmd = 10;
+	ignore_clear = stuck;
+	CHECK(ufs_read_blocks_queued(TEST_LUN, TEST_LBA, (uintptr_t)buf,
+				     size) == 0U);
+	CHECK(REG(UTRLDBR) == 0U);
+	CHECK(num_cmds < (size / (2 << 20)));
+	if (stuck) {
+		CHECK(REG(HCE) == HCE_DISABLE);
+	} else {
+		CHECK(num_cleared != 0U);
+		CHECK(REG(HCE) == HCE_ENABLE);
+	}
+
+	memcpy(copy, buf, size);
+	dma = dma_bytes;
+	udelay(1000000U);
+	(void)mmio_read_32(REG_BASE + UTRLDBR);
+	CHECK(dma_bytes == dma);
+	CHECK(memcmp(copy, buf, size) == 0);
+
+	free(copy);
+
+	printf("UTP error abort OK (%s)\n",
+	       stuck ? "controller disabled" : "UTRLCLR");
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int seed = 1U;
+	uint8_t *buf;
+
+	if (argc > 1) {
+		seed = (unsigned int)strtoul(argv[1], NULL, 0);
+	}
+	srand(seed);
+
+	buf = malloc(TEST_SIZE + UFS_BLOCK_SIZE);
+	CHECK(buf != NULL);
+
+	test_throughput(buf, 1U);
+	test_throughput(buf, 8U);
+	test_throughput(buf, 32U);
+	test_split(buf);
+	test_unit_attention(buf);
+	test_abort(buf, false);
+	test_abort(buf, true);
+
+	free(buf);
+
+	return 0;
+}
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host replacement of include/arch/aarch64/arch_features.h */
+
+#ifndef ARCH_FEATURES_H
+#define ARCH_FEATURES_H
+
+#include <arch_helpers.h>
+
+#endif /* ARCH_FEATURES_H */
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host replacement of include/arch/aarch64/arch_helpers.h. The translation
+ * tables are only generated in memory, so there is nothing to synchronise.
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <arch.h>
+
+typedef uint64_t u_register_t;
+
+static inline void dsbish(void) {}
+static inline void dsbishst(void) {}
+static inline void isb(void) {}
+
+static inline bool is_dcache_enabled(void)
+{
+	return false;
+}
+
+static inline void clean_dcache_range(uintptr_t addr, size_t size)
+{
+	(void)addr;
+	(void)size;
+}
+
+static inline void dccvac(uintptr_t addr)
+{
+	(void)addr;
+}
+
+#endif /* ARCH_HELPERS_H */
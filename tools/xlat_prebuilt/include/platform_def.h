@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * The platform parameters are read from the input of the tool, the library
+ * only needs the dynamic regions support to count the regions of each table.
+ */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+#define PLAT_XLAT_TABLES_DYNAMIC	1
+
+#endif /* PLATFORM_DEF_H */
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Generate the translation tables of the static regions of an image at build
+ * time, see XLAT_TABLES_PREBUILT. The regions are mapped with the
+ * xlat_tables_v2 library itself, built for the host, so the result is the same
+ * as when the image maps them at run time.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <lib/xlat_tables/xlat_tables_prebuilt.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+
+#include "xlat_tables_private.h"
+
+static bool rme;
+
+/*
+ * Architecture-specific functions of the library, as in
+ * lib/xlat_tables_v2/aarch64/xlat_tables_arch.c for the EL3 regime.
+ */
+uint32_t xlat_arch_get_pas(uint32_t attr)
+{
+	switch (MT_PAS(attr)) {
+	case MT_REALM:
+		return rme ? LOWER_ATTRS(EL3_S1_NSE | NS) : 0U;
+	case MT_ROOT:
+		return rme ? LOWER_ATTRS(EL3_S1_NSE) : 0U;
+	case MT_NS:
+		return LOWER_ATTRS(NS);
+	default: /* MT_SECURE */
+		return 0U;
+	}
+}
+
+uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime)
+{
+	assert(xlat_regime == EL3_REGIME);
+
+	return UPPER_ATTRS(XN);
+}
+
+unsigned int xlat_arch_current_el(void)
+{
+	return 3U;
+}
+
+bool is_mmu_enabled_ctx(const xlat_ctx_t *ctx)
+{
+	(void)ctx;
+
+	return false;
+}
+
+/* The target checks these limits again when it installs the tables. */
+unsigned long long xlat_arch_get_max_supported_pa(void)
+{
+	return ~0ULL;
+}
+
+uintptr_t xlat_get_min_virt_addr_space_size(void)
+{
+	return MIN_VIRT_ADDR_SPACE_SIZE_TTST;
+}
+
+void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
+{
+	(void)va;
+	(void)xlat_regime;
+}
+
+void xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime)
+{
+	(void)va;
+	(void)size;
+	(void)xlat_regime;
+}
+
+void xlat_arch_tlbi_va_sync(void)
+{
+}
+
+void xlat_mmap_print(const mmap_region_t *mmap)
+{
+	(void)mmap;
+}
+
+void xlat_tables_print(xlat_ctx_t *ctx)
+{
+	(void)ctx;
+}
+
+static xlat_ctx_t ctx;
+static uint64_t (*tables)[XLAT_TABLE_ENTRIES];
+static unsigned int num_entries;
+
+/* Emit the non-zero descriptors of a table and of its subtables. */
+static void emit_table(FILE *out, const uint64_t *table, unsigned int entries,
+		       unsigned int table_id, unsigned int level)
+{
+	for (unsigned int i = 0U; i < entries; i++) {
+		uint64_t desc = table[i];
+		unsigned int subtable = 0U;
+
+		if (desc == INVALID_DESC) {
+			continue;
+		}
+
+		if (((desc & DESC_MASK) == TABLE_DESC) &&
+		    (level < XLAT_TABLE_LEVEL_MAX)) {
+			subtable = (unsigned int)(((desc & TABLE_ADDR_MASK) -
+				(uintptr_t)tables) / XLAT_TABLE_SIZE);
+			desc = TABLE_DESC;
+		}
+
+		fprintf(out, "\t{ 0x%x, %u, %u, 0x%016" PRIx64 "ULL },\n",
+			table_id, i, subtable, desc);
+		num_entries++;
+
+		if (desc == TABLE_DESC) {
+			emit_table(out, tables[subtable], XLAT_TABLE_ENTRIES,
+				   subtable, level + 1U);
+		}
+	}
+}
+
+static void *read_file(const char *name, size_t *size)
+{
+	FILE *f = fopen(name, "rb");
+	void *buf = NULL;
+	long len;
+
+	if (f == NULL) {
+		perror(name);
+		exit(EXIT_FAILURE);
+	}
+
+	if ((fseek(f, 0, SEEK_END) != 0) || ((len = ftell(f)) < 0) ||
+	    (fseek(f, 0, SEEK_SET) != 0) ||
+	    ((buf = malloc((size_t)len + 1U)) == NULL) ||
+	    (fread(buf, 1, (size_t)len, f) != (size_t)len)) {
+		fprintf(stderr, "%s: cannot read file\n", name);
+		exit(EXIT_FAILURE);
+	}
+
+	fclose(f);
+	*size = (size_t)len;
+
+	return buf;
+}
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: xlat_prebuilt <params.bin> <mmap.bin> -o <output.c>\n");
+	exit(EXIT_FAILURE);
+}
+
+static bool overlaps_image(const struct xlat_prebuilt_params *params,
+			   const mmap_region_t *mm)
+{
+	return (mm->base_va < params->image_limit) &&
+	       ((mm->base_va + mm->size) > params->image_base);
+}
+
+int main(int argc, char *argv[])
+{
+	const struct xlat_prebuilt_params *in;
+	const mmap_region_t *in_mmap;
+	const char *mmap_name, *out_name;
+	unsigned int num_in = 0U, num_regions = 0U, num_tables = 0U;
+	mmap_region_t *mmap;
+	uint64_t *base_table;
+	int *mapped_regions;
+	size_t size;
+	FILE *out;
+
+	if ((argc != 5) || (strcmp(argv[3], "-o") != 0)) {
+		usage();
+	}
+	mmap_name = argv[2];
+	out_name = argv[4];
+
+	in = read_file(argv[1], &size);
+	if ((size >= sizeof(in->magic)) &&
+	    (in->magic == __builtin_bswap32(XLAT_PREBUILT_MAGIC))) {
+		fprintf(stderr,
+			"%s: byte order of the target differs from the host\n",
+			argv[1]);
+		return EXIT_FAILURE;
+	}
+	if ((size != sizeof(*in)) || (in->magic != XLAT_PREBUILT_MAGIC)) {
+		fprintf(stderr, "%s: not translation context parameters\n",
+			argv[1]);
+		return EXIT_FAILURE;
+	}
+	if (in->mmap_region_size != sizeof(mmap_region_t)) {
+		fprintf(stderr,
+			"%s: mmap_region_t is %u bytes on the target, %zu on the host\n",
+			argv[1], in->mmap_region_size, sizeof(mmap_region_t));
+		return EXIT_FAILURE;
+	}
+
+	in_mmap = read_file(mmap_name, &size);
+	if ((size % sizeof(mmap_region_t)) != 0U) {
+		fprintf(stderr, "%s: not an array of mmap_region_t\n",
+			mmap_name);
+		return EXIT_FAILURE;
+	}
+	while ((((num_in + 1U) * sizeof(mmap_region_t)) <= size) &&
+	       (in_mmap[num_in].size != 0U)) {
+		num_in++;
+	}
+	if (num_in > in->max_regions) {
+		fprintf(stderr, "%s: too many regions\n", mmap_name);
+		return EXIT_FAILURE;
+	}
+
+	rme = (in->flags & XLAT_PREBUILT_FLAG_RME) != 0U;
+
+	mmap = calloc(in->max_regions + 1U, sizeof(*mmap));
+	tables = aligned_alloc(XLAT_TABLE_SIZE,
+			       in->max_tables * XLAT_TABLE_SIZE);
+	base_table = aligned_alloc(XLAT_TABLE_SIZE, XLAT_TABLE_SIZE);
+	mapped_regions = calloc(in->max_tables, sizeof(*mapped_regions));
+	if ((mmap == NULL) || (tables == NULL) || (base_table == NULL) ||
+	    (mapped_regions == NULL)) {
+		fprintf(stderr, "out of memory\n");
+		return EXIT_FAILURE;
+	}
+
+	xlat_setup_dynamic_ctx(&ctx, in->pa_space_size - 1ULL,
+			       in->va_space_size - 1ULL, mmap, in->max_regions,
+			       (uint64_t **)tables, in->max_tables, base_table,
+			       EL3_REGIME, mapped_regions);
+
+	/* Errors in the regions abort the tool, failing the build. */
+	for (unsigned int i = 0U; i < num_in; i++) {
+		if (overlaps_image(in, &in_mmap[i])) {
+			continue;
+		}
+		mmap_add_region_ctx(&ctx, &in_mmap[i]);
+		num_regions++;
+	}
+	init_xlat_tables_ctx(&ctx);
+
+	/* The subtables are allocated in order when mapping static regions. */
+	while ((num_tables < in->max_tables) &&
+	       (mapped_regions[num_tables] != 0)) {
+		num_tables++;
+	}
+
+	out = fopen(out_name, "w");
+	if (out == NULL) {
+		perror(out_name);
+		return EXIT_FAILURE;
+	}
+
+	fprintf(out,
+		"/*\n"
+		" * Generated by tools/xlat_prebuilt from %s, do not edit.\n"
+		" */\n\n"
+		"#include <lib/xlat_tables/xlat_tables_prebuilt.h>\n\n",
+		mmap_name);
+
+	fprintf(out, "static const mmap_region_t prebuilt_mmap[] = {\n");
+	for (unsigned int i = 0U; i < num_regions; i++) {
+		const mmap_region_t *mm = &ctx.mmap[i];
+
+		fprintf(out, "\t{ 0x%llxULL, 0x%" PRIxPTR "UL, 0x%zxUL, "
+			"0x%xU, 0x%zxUL },\n", mm->base_pa, mm->base_va,
+			mm->size, mm->attr, mm->granularity);
+	}
+	fprintf(out, "\t{ 0 }\n};\n\n");
+
+	fprintf(out,
+		"static const struct xlat_prebuilt_entry prebuilt_entries[] = {\n");
+	emit_table(out, base_table, ctx.base_table_entries,
+		   XLAT_PREBUILT_BASE_TABLE, ctx.base_level);
+	fprintf(out, "\t{ 0 }\n};\n\n");
+
+	fprintf(out, "static const int prebuilt_mapped_regions[] = {\n");
+	for (unsigned int i = 0U; i < num_tables; i++) {
+		fprintf(out, "\t%d,\n", mapped_regions[i]);
+	}
+	fprintf(out, "\t0\n};\n\n");
+
+	fprintf(out,
+		"const struct xlat_prebuilt xlat_tables_prebuilt = {\n"
+		"\t.va_space_size = 0x%" PRIx64 "ULL,\n"
+		"\t.pa_space_size = 0x%" PRIx64 "ULL,\n"
+		"\t.flags = 0x%xU,\n"
+		"\t.num_regions = %uU,\n"
+		"\t.mmap = prebuilt_mmap,\n"
+		"\t.num_entries = %uU,\n"
+		"\t.entries = prebuilt_entries,\n"
+		"\t.num_tables = %uU,\n"
+		"\t.mapped_regions = prebuilt_mapped_regions,\n"
+		"};\n",
+		in->va_space_size, in->pa_space_size, in->flags, num_regions,
+		num_entries, num_tables);
+
+	if (fclose(out) != 0) {
+		perror(out_name);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host replacement of include/arch/aarch64/arch_features.h. FEAT_TLBIRANGE is
+ * selected by the test.
+ */
+
+#ifndef ARCH_FEATURES_H
+#define ARCH_FEATURES_H
+
+#include <stdbool.h>
+
+#include <arch_helpers.h>
+
+bool is_feat_tlbirange_present(void);
+
+static inline bool is_armv8_2_ttcnp_present(void)
+{
+	return false;
+}
+
+static inline bool is_armv8_4_ttst_present(void)
+{
+	return false;
+}
+
+#endif /* ARCH_FEATURES_H */
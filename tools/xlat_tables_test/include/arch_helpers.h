@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host replacement of include/arch/aarch64/arch_helpers.h. The system
+ * registers read by the library report an EL3 with the MMU disabled, and the
+ * barriers and TLB invalidations are implemented by the test, which records
+ * them.
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <arch.h>
+
+typedef uint64_t u_register_t;
+
+void dsbish(void);
+void dsbishst(void);
+
+static inline void isb(void) {}
+
+bool is_dcache_enabled(void);
+
+void tlbivaae1is(uint64_t arg);
+void tlbivae2is(uint64_t arg);
+void tlbivae3is(uint64_t arg);
+void tlbirvaae1is(uint64_t arg);
+void tlbirvae2is(uint64_t arg);
+void tlbirvae3is(uint64_t arg);
+void tlbivmalle1is(void);
+void tlbialle2is(void);
+void tlbialle3is(void);
+
+static inline u_register_t read_CurrentEl(void)
+{
+	return (u_register_t)MODE_EL3 << MODE_EL_SHIFT;
+}
+
+/* 48-bit PA, 4KB granule */
+static inline unsigned int get_current_el_maybe_constant(void)
+{
+	return MODE_EL3;
+}
+
+static inline u_register_t read_id_aa64mmfr0_el1(void)
+{
+	return ((u_register_t)5U << ID_AA64MMFR0_EL1_PARANGE_SHIFT) |
+	       ((u_register_t)ID_AA64MMFR0_EL1_TGRAN16_NOT_SUPPORTED <<
+		ID_AA64MMFR0_EL1_TGRAN16_SHIFT);
+}
+
+static inline u_register_t read_sctlr_el1(void)
+{
+	return 0U;
+}
+
+static inline u_register_t read_sctlr_el2(void)
+{
+	return 0U;
+}
+
+static inline u_register_t read_sctlr_el3(void)
+{
+	return 0U;
+}
+
+static inline void clean_dcache_range(uintptr_t addr, size_t size)
+{
+	(void)addr;
+	(void)size;
+}
+
+static inline void dccvac(uintptr_t addr)
+{
+	(void)addr;
+}
+
+#endif /* ARCH_HELPERS_H */
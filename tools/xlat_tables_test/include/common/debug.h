@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host replacement of include/common/debug.h */
+
+#ifndef DEBUG_H
+#define DEBUG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOG_LEVEL_NONE		0
+#define LOG_LEVEL_ERROR		10
+#define LOG_LEVEL_NOTICE	20
+#define LOG_LEVEL_WARNING	30
+#define LOG_LEVEL_INFO		40
+#define LOG_LEVEL_VERBOSE	50
+
+#define ERROR(...)	fprintf(stderr, "ERROR: " __VA_ARGS__)
+#define WARN(...)	fprintf(stderr, "WARNING: " __VA_ARGS__)
+#define NOTICE(...)
+#define INFO(...)
+
+/* Used by xlat_tables_print() */
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+#define VERBOSE(...)	printf(__VA_ARGS__)
+#else
+#define VERBOSE(...)
+#endif
+
+#define panic()		abort()
+
+#endif /* DEBUG_H */
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* The test only needs the dynamic regions support of the library */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+#define PLAT_XLAT_TABLES_DYNAMIC	1
+
+#endif /* PLATFORM_DEF_H */
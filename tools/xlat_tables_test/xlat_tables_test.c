@@ -0,0 +1,625 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host model test of the dynamic region API of the xlat_tables_v2 library.
+ *
+ * Batches of regions are added and removed at random with
+ * mmap_add_dynamic_regions_ctx() and mmap_remove_dynamic_regions_ctx(), and
+ * the translation tables are checked against a reference model after each
+ * batch. The TLB invalidations issued by aarch64/xlat_tables_arch.c are
+ * recorded, every page of a removed region must have been invalidated.
+ * Then, the decomposition of a range into TLBI RVAE3IS operations is checked
+ * to cover exactly the requested pages, for every size up to 5000 pages and
+ * then at intervals.
+ *
+ * Finally, the NS shared and SP regions of BL31 are mapped with and without
+ * MT_CONTIGUOUS, and the TLB entries they need are taken from the report of
+ * xlat_tables_print(). Changing the attributes of one page of a contiguous
+ * group must clear the Contiguous bit of the whole group, and only of it.
+ *
+ * Usage: xlat_tables_test [iterations [feat_tlbirange [seed]]]
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+
+#include <xlat_tables_private.h>
+
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			fprintf(stderr, "%s:%d: check failed: %s\n",	\
+				__FILE__, __LINE__, #cond);		\
+			exit(1);					\
+		}							\
+	} while (0)
+
+#define VA_SPACE_SIZE		(ULL(1) << 32)
+#define PA_SPACE_SIZE		(ULL(1) << 40)
+#define NUM_PAGES		(VA_SPACE_SIZE >> PAGE_SIZE_SHIFT)
+
+#define MAX_REGIONS		128
+#define MAX_TABLES		256
+#define BASE_TABLE_ENTRIES	4
+
+/* Dynamic regions are mapped in [1GB, 4GB), at PA = VA + 16GB */
+#define DYN_VA_BASE		(ULL(1) << 30)
+#define DYN_PA_OFFSET		(ULL(1) << 34)
+
+#define OA_MASK			ULL(0xFFFFFFFFF000)
+
+/* Recorded TLB maintenance */
+static unsigned char inval[NUM_PAGES];
+static bool all_inval;
+static bool feat_tlbirange;
+static unsigned long num_tlbi_va, num_tlbi_range, num_tlbi_all;
+
+static void mark(uint64_t va, uint64_t pages)
+{
+	CHECK((va >> PAGE_SIZE_SHIFT) + pages <= NUM_PAGES);
+	memset(&inval[va >> PAGE_SIZE_SHIFT], 1, pages);
+}
+
+bool is_feat_tlbirange_present(void)
+{
+	return feat_tlbirange;
+}
+
+void dsbish(void)
+{
+}
+
+void dsbishst(void)
+{
+}
+
+/* Only the EL3 translation regime is used */
+void tlbivaae1is(uint64_t arg)
+{
+	(void)arg;
+	CHECK(false);
+}
+
+void tlbivae2is(uint64_t arg)
+{
+	(void)arg;
+	CHECK(false);
+}
+
+void tlbirvaae1is(uint64_t arg)
+{
+	(void)arg;
+	CHECK(false);
+}
+
+void tlbirvae2is(uint64_t arg)
+{
+	(void)arg;
+	CHECK(false);
+}
+
+void tlbivmalle1is(void)
+{
+	CHECK(false);
+}
+
+void tlbialle2is(void)
+{
+	CHECK(false);
+}
+
+void tlbivae3is(uint64_t arg)
+{
+	num_tlbi_va++;
+	mark(arg << PAGE_SIZE_SHIFT, 1U);
+}
+
+void tlbirvae3is(uint64_t arg)
+{
+	uint64_t num = (arg >> TLBIR_NUM_SHIFT) & TLBIR_NUM_MASK;
+	uint64_t scale = (arg >> TLBIR_SCALE_SHIFT) & TLBIR_SCALE_MASK;
+
+	CHECK(feat_tlbirange);
+	CHECK(((arg >> TLBIR_TG_SHIFT) & ULL(3)) == TLBIR_TG_4K);
+
+	num_tlbi_range++;
+	mark((arg & TLBIR_BADDR_MASK) << PAGE_SIZE_SHIFT,
+	     TLBIR_PAGES(num, scale));
+}
+
+void tlbialle3is(void)
+{
+	num_tlbi_all++;
+	all_inval = true;
+}
+
+/*
+ * The output of xlat_mmap_print() and xlat_tables_print() is captured, so that
+ * only their summary is shown.
+ */
+static FILE *saved_stdout;
+static char *captured;
+static size_t captured_size;
+
+static void capture_start(void)
+{
+	fflush(stdout);
+	saved_stdout = stdout;
+	stdout = open_memstream(&captured, &captured_size);
+	CHECK(stdout != NULL);
+}
+
+static void capture_end(void)
+{
+	fclose(stdout);
+	stdout = saved_stdout;
+}
+
+static mmap_region_t ctx_mmap[MAX_REGIONS + 1];
+static uint64_t ctx_tables[MAX_TABLES][XLAT_TABLE_ENTRIES]
+	__aligned(XLAT_TABLE_SIZE);
+static uint64_t ctx_base_table[BASE_TABLE_ENTRIES]
+	__aligned(BASE_TABLE_ENTRIES * sizeof(uint64_t));
+static int ctx_mapped_regions[MAX_TABLES];
+static xlat_ctx_t ctx;
+
+/* Walk the tables, return the PA of va or -1 if it isn't mapped */
+static long long walk(uintptr_t va)
+{
+	const uint64_t *table = ctx_base_table;
+	unsigned int level = ctx.base_level;
+	unsigned int entries = ctx.base_table_entries;
+
+	for (;;) {
+		uint64_t desc = table[(va >> XLAT_ADDR_SHIFT(level)) &
+				      (entries - 1U)];
+
+		if ((desc & DESC_MASK) == INVALID_DESC) {
+			return -1;
+		}
+
+		if (level == XLAT_TABLE_LEVEL_MAX) {
+			CHECK((desc & DESC_MASK) == PAGE_DESC);
+			return (long long)((desc & OA_MASK) |
+					   (va & PAGE_SIZE_MASK));
+		}
+
+		if ((desc & DESC_MASK) == BLOCK_DESC) {
+			return (long long)((desc & OA_MASK &
+					    ~XLAT_BLOCK_MASK(level)) |
+					   (va & XLAT_BLOCK_MASK(level)));
+		}
+
+		table = (const uint64_t *)(uintptr_t)(desc & OA_MASK);
+		entries = XLAT_TABLE_ENTRIES;
+		level++;
+	}
+}
+
+/* Reference model of the dynamic regions */
+struct model_region {
+	uintptr_t va;
+	unsigned long long pa;
+	size_t size;
+};
+
+static struct model_region model[MAX_REGIONS];
+static int model_count;
+
+static unsigned long long rnd(void)
+{
+	return ((unsigned long long)rand() << 31) ^ (unsigned long long)rand();
+}
+
+static bool model_overlaps(uintptr_t va, unsigned long long pa, size_t size)
+{
+	for (int i = 0; i < model_count; i++) {
+		if ((va < (model[i].va + model[i].size)) &&
+		    (model[i].va < (va + size))) {
+			return true;
+		}
+		if ((pa < (model[i].pa + model[i].size)) &&
+		    (model[i].pa < (pa + size))) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int model_find(uintptr_t va, size_t size)
+{
+	for (int i = 0; i < model_count; i++) {
+		if ((model[i].va == va) && (model[i].size == size)) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/*
+ * The mmap array must stay sorted by end address, then by size, hold the
+ * static region and the regions of the model and be terminated by zeroed
+ * entries. The regions of the model must be mapped page by page.
+ */
+static void check_state(void)
+{
+	int n = 0;
+
+	for (const mmap_region_t *mm = ctx.mmap; mm->size != 0U; mm++, n++) {
+		if (mm > ctx.mmap) {
+			const mmap_region_t *prev = mm - 1;
+			uintptr_t prev_end = prev->base_va + prev->size - 1U;
+			uintptr_t end = mm->base_va + mm->size - 1U;
+
+			CHECK((prev_end < end) ||
+			      ((prev_end == end) && (prev->size <= mm->size)));
+		}
+	}
+
+	CHECK(n == (model_count + 1));
+	for (int i = n; i <= MAX_REGIONS; i++) {
+		CHECK(ctx.mmap[i].size == 0U);
+	}
+
+	for (int i = 0; i < model_count; i++) {
+		for (size_t off = 0U; off < model[i].size; off += PAGE_SIZE) {
+			CHECK(walk(model[i].va + off) ==
+			      (long long)(model[i].pa + off));
+		}
+	}
+}
+
+static size_t rand_size(void)
+{
+	switch (rnd() % 4U) {
+	case 0:
+		return PAGE_SIZE;
+	case 1:
+		return (1U + (rnd() % 16U)) * PAGE_SIZE;
+	case 2:
+		return (1U + (rnd() % 300U)) * PAGE_SIZE;
+	default:
+		return (1U + (rnd() % 3U)) * XLAT_BLOCK_SIZE(2U);
+	}
+}
+
+/* Add a batch of 1 to 4 regions, which may overlap the existing ones */
+static void test_add(unsigned long *added, unsigned long *rejected)
+{
+	unsigned int count = 1U + (rnd() % 4U);
+	mmap_region_t mm[4];
+	int saved_count = model_count;
+	bool valid = true;
+	int ret;
+
+	for (unsigned int i = 0U; i < count; i++) {
+		size_t size = rand_size();
+		uintptr_t va = DYN_VA_BASE +
+			((rnd() % ((VA_SPACE_SIZE - DYN_VA_BASE) / PAGE_SIZE)) *
+			 PAGE_SIZE);
+
+		if ((size >= XLAT_BLOCK_SIZE(2U)) && ((rnd() % 2U) != 0U)) {
+			va &= ~XLAT_BLOCK_MASK(2U);
+		}
+		if ((va + size) > VA_SPACE_SIZE) {
+			va = VA_SPACE_SIZE - size;
+		}
+
+		mm[i] = (mmap_region_t)MAP_REGION(va + DYN_PA_OFFSET, va, size,
+						  MT_MEMORY | MT_RW | MT_NS);
+	}
+
+	/* The batch is valid if no region overlaps another one */
+	for (unsigned int i = 0U; i < count; i++) {
+		if (model_overlaps(mm[i].base_va, mm[i].base_pa, mm[i].size)) {
+			valid = false;
+			break;
+		}
+		model[model_count++] = (struct model_region){
+			mm[i].base_va, mm[i].base_pa, mm[i].size };
+	}
+	model_count = saved_count;
+
+	ret = mmap_add_dynamic_regions_ctx(&ctx, mm, count);
+	if (valid && (ret == -ENOMEM)) {
+		/* Out of subtables, nothing must have changed */
+		(*rejected)++;
+		return;
+	}
+
+	CHECK((ret == 0) == valid);
+	if (ret != 0) {
+		(*rejected)++;
+		return;
+	}
+
+	for (unsigned int i = 0U; i < count; i++) {
+		model[model_count++] = (struct model_region){
+			mm[i].base_va, mm[i].base_pa, mm[i].size };
+	}
+	*added += count;
+}
+
+/*
+ * Remove a batch of 1 to 3 regions. Batches that name a region twice or with
+ * the wrong size must be rejected.
+ */
+static void test_remove(unsigned long *removed, unsigned long *rejected)
+{
+	unsigned int count = 1U + (rnd() % ((model_count < 3) ?
+					    (unsigned int)model_count : 3U));
+	mmap_region_t mm[3];
+	int idx[3];
+	bool valid = true;
+	int ret;
+
+	for (unsigned int i = 0U; i < count; i++) {
+		idx[i] = (int)(rnd() % (unsigned int)model_count);
+		mm[i] = (mmap_region_t)MAP_REGION(model[idx[i]].pa,
+						  model[idx[i]].va,
+						  model[idx[i]].size, 0U);
+		for (unsigned int j = 0U; j < i; j++) {
+			if (idx[i] == idx[j]) {
+				valid = false;
+			}
+		}
+	}
+
+	if ((rnd() % 10U) == 0U) {
+		mm[count - 1U].size += PAGE_SIZE;
+		valid = false;
+	}
+
+	memset(inval, 0, sizeof(inval));
+	all_inval = false;
+
+	ret = mmap_remove_dynamic_regions_ctx(&ctx, mm, count);
+	CHECK((ret == 0) == valid);
+	if (ret != 0) {
+		(*rejected)++;
+		return;
+	}
+
+	for (unsigned int i = 0U; i < count; i++) {
+		for (size_t off = 0U; off < mm[i].size; off += PAGE_SIZE) {
+			uintptr_t va = mm[i].base_va + off;
+
+			CHECK(walk(va) == -1);
+			CHECK(all_inval || (inval[va >> PAGE_SIZE_SHIFT] != 0U));
+		}
+	}
+
+	for (unsigned int i = 0U; i < count; i++) {
+		int k = model_find(mm[i].base_va, mm[i].size);
+
+		CHECK(k >= 0);
+		model[k] = model[--model_count];
+	}
+	*removed += count;
+}
+
+/*
+ * The range operations must invalidate exactly the requested pages, without
+ * touching the neighbouring ones.
+ */
+static void test_tlbi_range(void)
+{
+	uintptr_t va = ULL(0x10000000);
+	size_t first = va >> PAGE_SIZE_SHIFT;
+
+	for (size_t pages = 1U; pages < 70000U;
+	     pages += ((pages < 5000U) ? 1U : 997U)) {
+		memset(&inval[first - 1U], 0, pages + 2U);
+		all_inval = false;
+
+		xlat_arch_tlbi_va_range(va, pages * PAGE_SIZE, EL3_REGIME);
+		if (all_inval) {
+			CHECK(!feat_tlbirange);
+			CHECK(pages > XLAT_TLBI_VA_MAX_PAGES);
+			continue;
+		}
+
+		CHECK(inval[first - 1U] == 0U);
+		CHECK(inval[first + pages] == 0U);
+		for (size_t i = 0U; i < pages; i++) {
+			CHECK(inval[first + i] != 0U);
+		}
+	}
+}
+
+/*
+ * NS shared and SP regions of BL31 with the EL3 SPMC and an SPM_MM partition,
+ * mapped page by page: FF-A TX and RX buffers of 16 pages, and the SPM_MM
+ * buffers and stack and heap of the partition. The mappings of the partition
+ * are checked in the EL3 regime. The PSCI stats export page and the EL3 trace
+ * buffer are then mapped at a VA allocated by the library.
+ */
+static const mmap_region_t contig_regions[] = {
+	MAP_REGION2(0x90000000U, 0x90000000U, 0x10000U,
+		    MT_RO_DATA | MT_NS, PAGE_SIZE),	/* SPMC TX */
+	MAP_REGION2(0x90010000U, 0x90010000U, 0x10000U,
+		    MT_RW_DATA | MT_NS, PAGE_SIZE),	/* SPMC RX */
+	MAP_REGION2(0xFF700000U, 0xFF700000U, 0x100000U,
+		    MT_RW_DATA | MT_SECURE, PAGE_SIZE),	/* SPM_MM EL3 buffer */
+	MAP_REGION2(0xFF800000U, 0xFF800000U, 0x10000U,
+		    MT_RW_DATA | MT_NS, PAGE_SIZE),	/* SP NS buffer */
+	MAP_REGION2(0xFF810000U, 0xFF810000U, 0x1F0000U,
+		    MT_RW_DATA | MT_SECURE, PAGE_SIZE),	/* SP stack and heap */
+};
+
+#define CONTIG_MAX_TABLES	16
+#define CONTIG_MAX_REGIONS	(ARRAY_SIZE(contig_regions) + 2U)
+
+static mmap_region_t cctx_mmap[CONTIG_MAX_REGIONS + 1];
+static uint64_t cctx_tables[CONTIG_MAX_TABLES][XLAT_TABLE_ENTRIES]
+	__aligned(XLAT_TABLE_SIZE);
+static uint64_t cctx_base_table[BASE_TABLE_ENTRIES]
+	__aligned(BASE_TABLE_ENTRIES * sizeof(uint64_t));
+static int cctx_mapped_regions[CONTIG_MAX_TABLES];
+
+/* Page descriptor of va in the tables of 'c' */
+static uint64_t *page_desc(const xlat_ctx_t *c, uintptr_t va)
+{
+	uint64_t *table = c->base_table;
+	unsigned int entries = c->base_table_entries;
+
+	for (unsigned int level = c->base_level; ; level++) {
+		uint64_t *desc = &table[(va >> XLAT_ADDR_SHIFT(level)) &
+					(entries - 1U)];
+
+		if (level == XLAT_TABLE_LEVEL_MAX) {
+			CHECK((*desc & DESC_MASK) == PAGE_DESC);
+			return desc;
+		}
+
+		CHECK((*desc & DESC_MASK) == TABLE_DESC);
+		table = (uint64_t *)(uintptr_t)(*desc & OA_MASK);
+		entries = XLAT_TABLE_ENTRIES;
+	}
+}
+
+static void test_contig(uint32_t contig)
+{
+	const size_t group = XLAT_CONTIG_SIZE(XLAT_TABLE_LEVEL_MAX);
+	mmap_region_t stats = MAP_REGION(0x97000000U, 0U, PAGE_SIZE,
+					 MT_RW_DATA | MT_NS);
+	mmap_region_t trace = MAP_REGION(0x98000000U, 0U, 0x100000U,
+					 MT_RW_DATA | MT_NS | contig);
+	uintptr_t va, group_va;
+	xlat_ctx_t cctx;
+	const char *line;
+	uint64_t *desc;
+
+	memset(&cctx, 0, sizeof(cctx));
+	memset(cctx_mmap, 0, sizeof(cctx_mmap));
+	memset(cctx_tables, 0, sizeof(cctx_tables));
+	memset(cctx_base_table, 0, sizeof(cctx_base_table));
+	memset(cctx_mapped_regions, 0, sizeof(cctx_mapped_regions));
+
+	xlat_setup_dynamic_ctx(&cctx, PA_SPACE_SIZE - 1U, VA_SPACE_SIZE - 1U,
+			       cctx_mmap, CONTIG_MAX_REGIONS,
+			       (uint64_t **)cctx_tables, CONTIG_MAX_TABLES,
+			       cctx_base_table, EL3_REGIME,
+			       cctx_mapped_regions);
+	for (size_t i = 0U; i < ARRAY_SIZE(contig_regions); i++) {
+		mmap_region_t mm = contig_regions[i];
+
+		mm.attr |= contig;
+		mmap_add_region_ctx(&cctx, &mm);
+	}
+
+	capture_start();
+	init_xlat_tables_ctx(&cctx);
+	capture_end();
+	free(captured);
+
+	/* The EL3 trace buffer gets a VA aligned like its PA if needed */
+	CHECK(mmap_add_dynamic_region_alloc_va_ctx(&cctx, &stats) == 0);
+	CHECK(mmap_add_dynamic_region_alloc_va_ctx(&cctx, &trace) == 0);
+	CHECK((trace.base_va == (stats.base_va + PAGE_SIZE)) ==
+	      (contig == 0U));
+	CHECK((contig == 0U) || ((trace.base_va & (group - 1U)) == 0U));
+
+	capture_start();
+	xlat_tables_print(&cctx);
+	capture_end();
+
+	line = strstr(captured, "TLB entries");
+	CHECK(line != NULL);
+	printf("%s: %.*s", (contig != 0U) ? "MT_CONTIGUOUS" : "Default",
+	       (int)(strchr(line, '\n') + 1 - line), line);
+	free(captured);
+
+	va = trace.base_va + group + (5U * PAGE_SIZE);
+	group_va = va & ~(group - 1U);
+
+	if (contig == 0U) {
+		CHECK((*page_desc(&cctx, va) & UPPER_ATTRS(CONT_HINT)) == 0ULL);
+		return;
+	}
+
+	/* Make one page of the EL3 trace buffer read-only */
+	memset(inval, 0, sizeof(inval));
+	all_inval = false;
+	capture_start();
+	CHECK(xlat_change_mem_attributes_ctx(&cctx, va, PAGE_SIZE,
+					     MT_RO_DATA | MT_NS) == 0);
+	capture_end();
+	free(captured);
+
+	for (size_t off = 0U; off < group; off += PAGE_SIZE) {
+		desc = page_desc(&cctx, group_va + off);
+		CHECK((*desc & UPPER_ATTRS(CONT_HINT)) == 0ULL);
+		CHECK(((*desc & LOWER_ATTRS(AP_RO)) != 0ULL) ==
+		      ((group_va + off) == va));
+		CHECK(all_inval || (inval[(group_va + off) >> PAGE_SIZE_SHIFT] != 0U));
+	}
+
+	/* The neighbouring groups keep the Contiguous bit */
+	CHECK((*page_desc(&cctx, group_va - PAGE_SIZE) &
+	       UPPER_ATTRS(CONT_HINT)) != 0ULL);
+	CHECK((*page_desc(&cctx, group_va + group) &
+	       UPPER_ATTRS(CONT_HINT)) != 0ULL);
+
+	printf("Contiguous group split OK\n");
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = (argc > 1) ? atoi(argv[1]) : 20000;
+	unsigned long added = 0UL, removed = 0UL, rejected = 0UL;
+	mmap_region_t static_region = MAP_REGION_FLAT(0, XLAT_BLOCK_SIZE(2U),
+						      MT_MEMORY | MT_RW |
+						      MT_SECURE);
+
+	feat_tlbirange = (argc > 2) ? (atoi(argv[2]) != 0) : true;
+	srand((argc > 3) ? (unsigned int)atoi(argv[3]) : 1U);
+
+	xlat_setup_dynamic_ctx(&ctx, PA_SPACE_SIZE - 1U, VA_SPACE_SIZE - 1U,
+			       ctx_mmap, MAX_REGIONS, (uint64_t **)ctx_tables,
+			       MAX_TABLES, ctx_base_table, EL3_REGIME,
+			       ctx_mapped_regions);
+	mmap_add_region_ctx(&ctx, &static_region);
+	capture_start();
+	init_xlat_tables_ctx(&ctx);
+	capture_end();
+	free(captured);
+	CHECK(ctx.base_table_entries == BASE_TABLE_ENTRIES);
+
+	for (int i = 0; i < iterations; i++) {
+		if (((rnd() % 2U) != 0U) && (model_count < (MAX_REGIONS - 8))) {
+			test_add(&added, &rejected);
+		} else if (model_count > 0) {
+			test_remove(&removed, &rejected);
+		}
+		check_state();
+	}
+
+	printf("%d iterations: %lu regions added, %lu removed, %lu batches rejected\n",
+	       iterations, added, removed, rejected);
+	printf("TLBI VAE3IS: %lu, RVAE3IS: %lu, ALLE3IS: %lu\n",
+	       num_tlbi_va, num_tlbi_range, num_tlbi_all);
+
+	test_tlbi_range();
+	printf("TLBI range decomposition OK, FEAT_TLBIRANGE %s\n",
+	       feat_tlbirange ? "on" : "off");
+
+	test_contig(0U);
+	test_contig(MT_CONTIGUOUS);
+
+	return 0;
+}